@@ -5,6 +5,7 @@
 #include <iostream>
 
 #include "../trinoAPIWrapper/environmentConfig.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/connHandle.hpp"
 #include "handles/descriptorHandle.hpp"
@@ -32,6 +33,7 @@ SQLRETURN SQL_API SQLAllocHandle(SQLSMALLINT HandleType,
    statement.
    */
   WriteLog(LL_TRACE, "Entering SQLAllocHandle");
+  TraceSpan span("SQLAllocHandle");
   if (OutputHandle == NULL) {
     WriteLog(LL_ERROR, "  ERROR: allocHandle Output handle was null.");
     return SQL_INVALID_HANDLE;
@@ -4,6 +4,7 @@
 
 #include <string>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
@@ -30,6 +31,8 @@ SQLRETURN SQL_API SQLBindCol(SQLHSTMT StatementHandle,
   */
 
   WriteLog(LL_TRACE, "Entering SQLBindCol");
+  TraceSpan span("SQLBindCol");
+
   WriteLog(LL_TRACE, "  Column Number is: " + std::to_string(ColumnNumber));
   WriteLog(LL_TRACE, "  Target Type is: " + std::to_string(TargetType));
   Statement* statement  = reinterpret_cast<Statement*>(StatementHandle);
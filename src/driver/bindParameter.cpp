@@ -2,6 +2,9 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include <string>
+
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
@@ -15,9 +18,40 @@ SQLRETURN SQL_API SQLBindParameter(SQLHSTMT StatementHandle,
                                    SQLPOINTER rgbValue,
                                    SQLLEN cbValueMax,
                                    SQLLEN* pcbValue) {
+  /*
+  Bind an application buffer to a parameter marker. Like SQLBindCol, this
+  only records where the value lives. The buffer is read when the
+  statement is executed, and rendered as a literal for Trino then.
+
+  Trino has no output parameters, so only input parameters are supported.
+  */
   WriteLog(LL_TRACE, "Entering SQLBindParameter");
+  TraceSpan span("SQLBindParameter");
+  WriteLog(LL_TRACE, "  Parameter Number is: " + std::to_string(ipar));
+  WriteLog(LL_TRACE, "  C Type is: " + std::to_string(fCType));
+  WriteLog(LL_TRACE, "  SQL Type is: " + std::to_string(fSqlType));
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
-  // This could probably look a lot like the SQLBindCol function.
-  WriteLog(LL_ERROR, "  ERROR: SQLBindParameter is unimplemented");
-  return SQL_ERROR;
+  if (ipar < 1) {
+    WriteLog(LL_ERROR, "  ERROR: Invalid parameter number");
+    ErrorInfo errorInfo("Invalid descriptor index", "07009");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  }
+  if (fParamType != SQL_PARAM_INPUT) {
+    WriteLog(LL_ERROR, "  ERROR: Only input parameters are supported");
+    ErrorInfo errorInfo("Optional feature not implemented", "HYC00");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  }
+  Descriptor* paramDescriptor = statement->getParamDescriptor();
+  DescriptorField field       = paramDescriptor->getField(ipar);
+  field.bufferCDataType       = fCType;
+  field.odbcDataType          = fSqlType;
+  field.bufferPtr             = rgbValue;
+  field.bufferLength          = cbValueMax;
+  field.bufferStrLenOrIndPtr  = pcbValue;
+  field.length                = static_cast<SQLINTEGER>(cbColDef);
+  field.scale                 = static_cast<SQLCHAR>(ibScale);
+  paramDescriptor->setField(ipar, field);
+  return SQL_SUCCESS;
 }
@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/connHandle.hpp"
 #include "handles/statementHandle.hpp"
@@ -9,6 +10,7 @@
 SQLRETURN SQL_API SQLCancelHandle(SQLSMALLINT HandleType,
                                   SQLHANDLE InputHandle) {
   WriteLog(LL_TRACE, "Entering SQLCancelHandle");
+  TraceSpan span("SQLCancelHandle");
   switch (HandleType) {
     case SQL_HANDLE_STMT: {
       // According to the docs, the driver manager will automatically
@@ -16,7 +18,7 @@ SQLRETURN SQL_API SQLCancelHandle(SQLSMALLINT HandleType,
       // write the code anyway.
       WriteLog(LL_WARN, "  Canceling statement handle");
       Statement* statement = reinterpret_cast<Statement*>(InputHandle);
-      statement->terminate();
+      statement->cancel();
       break;
     }
     case SQL_HANDLE_DBC: {
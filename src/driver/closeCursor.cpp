@@ -2,12 +2,23 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
 SQLRETURN SQL_API SQLCloseCursor(SQLHSTMT StatementHandle) {
   WriteLog(LL_TRACE, "Entering SQLCloseCursor");
+  TraceSpan span("SQLCloseCursor");
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
-  WriteLog(LL_ERROR, "  ERROR: SQLCloseCursor is unimplemented");
-  return SQL_ERROR;
+  // Unlike SQLFreeStmt with SQL_CLOSE, closing a cursor that isn't open
+  // is an error.
+  if (not statement->executed) {
+    WriteLog(LL_ERROR, "  ERROR: SQLCloseCursor called with no open cursor");
+    ErrorInfo errorInfo("Invalid cursor state", "24000");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  }
+  statement->terminateInBackground();
+  statement->reset();
+  return SQL_SUCCESS;
 }
@@ -5,6 +5,7 @@
 #include <string>
 
 #include "../util/valuePtrHelper.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 #include "mappings/typeMappings.hpp"
@@ -46,6 +47,7 @@ SQLRETURN SQL_API SQLColAttribute(SQLHSTMT StatementHandle,
 #endif
 #pragma warning(pop)
   WriteLog(LL_TRACE, "Entering SQLColAttribute");
+  TraceSpan span("SQLColAttribute");
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
 
   Descriptor* ird            = statement->impRowDesc;
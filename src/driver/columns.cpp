@@ -2,14 +2,42 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../trinoAPIWrapper/columnDescription.hpp"
+#include "../util/bufferToLiteral.hpp"
+#include "../util/informationSchemaColumns.hpp"
+#include "../util/searchPattern.hpp"
 #include "../util/stringFromChar.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
+// The columns of the SQLColumns result set and their Trino types.
+static const std::vector<std::pair<std::string, std::string>>
+    SQL_COLUMNS_RESULT_COLUMNS = {
+        {"table_cat", "varchar"},
+        {"table_schem", "varchar"},
+        {"table_name", "varchar"},
+        {"column_name", "varchar"},
+        {"data_type", "bigint"},
+        {"type_name", "varchar"},
+        {"column_size", "bigint"},
+        {"buffer_length", "bigint"},
+        {"decimal_digits", "bigint"},
+        {"num_prec_radix", "bigint"},
+        {"nullable", "bigint"},
+        {"remarks", "varchar"},
+        {"column_def", "varchar"},
+        {"sql_data_type", "bigint"},
+        {"sql_datetime_sub", "bigint"},
+        {"char_octet_length", "bigint"},
+        {"ordinal_position", "bigint"},
+        {"is_nullable", "varchar"},
+};
+
 std::string constructColumnQuery(std::string catalog,
                                  std::string schema,
-                                 std::string tableName,
-                                 std::string columnName) {
+                                 std::string tableName  = "",
+                                 std::string columnName = "") {
   /*
   We need to implement a result set that matches this exact spec.
   https://learn.microsoft.com/en-us/sql/odbc/reference/syntax/sqlcolumns-function
@@ -67,34 +95,18 @@ std::string constructColumnQuery(std::string catalog,
   // clang-format on
 
   // Querying with `=` is about 2x faster than `like`, so don't use
-  // `like` unless it's actually required.
+  // `like` unless it's actually required. The catalog is never a pattern.
   if (!catalog.empty()) {
-    if (catalog.find('%') != std::string::npos) {
-      query += std::string("AND table_cat LIKE '" + catalog + "'\n");
-    } else {
-      query += std::string("AND table_cat = '" + catalog + "'\n");
-    }
+    query += "AND table_cat = " + quoteSqlString(catalog) + "\n";
   }
   if (!schema.empty()) {
-    if (schema.find('%') != std::string::npos) {
-      query += std::string("AND table_schem LIKE '" + schema + "'\n");
-    } else {
-      query += std::string("AND table_schem = '" + schema + "'\n");
-    }
+    query += "AND " + searchPatternPredicate("table_schem", schema) + "\n";
   }
   if (!tableName.empty()) {
-    if (tableName.find('%') != std::string::npos) {
-      query += std::string("AND table_name LIKE '" + tableName + "'\n");
-    } else {
-      query += std::string("AND table_name = '" + tableName + "'\n");
-    }
+    query += "AND " + searchPatternPredicate("table_name", tableName) + "\n";
   }
   if (!columnName.empty()) {
-    if (columnName.find('%') != std::string::npos) {
-      query += std::string("AND column_name LIKE '" + columnName + "'\n");
-    } else {
-      query += std::string("AND column_name = '" + columnName + "'\n");
-    }
+    query += "AND " + searchPatternPredicate("column_name", columnName) + "\n";
   }
 
   // Mandatory order-by clause
@@ -106,6 +118,65 @@ std::string constructColumnQuery(std::string catalog,
   return query;
 }
 
+std::string constructInformationSchemaColumnQuery(std::string catalog,
+                                                  std::string schema,
+                                                  std::string tableName  = "",
+                                                  std::string columnName = "") {
+  /*
+  system.jdbc.columns has to visit every catalog before it can filter on
+  one, which takes seconds on a busy cluster. When the catalog is known,
+  its own information_schema answers the same question, and connectors can
+  push the schema and table predicates down into their metastore.
+  The rows are reshaped by sqlColumnsRowFromInformationSchema.
+  */
+  std::string query = "SELECT table_catalog, table_schema, table_name, "
+                      "column_name, ordinal_position, is_nullable, "
+                      "data_type\n"
+                      "FROM " + quoteSqlIdentifier(catalog) +
+                      ".information_schema.columns\n"
+                      "WHERE 1=1\n";
+  if (!schema.empty()) {
+    query += "AND " + searchPatternPredicate("table_schema", schema) + "\n";
+  }
+  if (!tableName.empty()) {
+    query += "AND " + searchPatternPredicate("table_name", tableName) + "\n";
+  }
+  if (!columnName.empty()) {
+    query += "AND " + searchPatternPredicate("column_name", columnName) + "\n";
+  }
+  query += "ORDER BY table_schema, table_name, ordinal_position";
+  return query;
+}
+
+std::vector<json> sqlColumnsResultColumns() {
+  std::vector<json> columns;
+  for (const auto& [name, type] : SQL_COLUMNS_RESULT_COLUMNS) {
+    columns.push_back(columnJsonFromType(name, type));
+  }
+  return columns;
+}
+
+json sqlColumnsResponse(const json& informationSchemaRows,
+                        const std::string& tableName  = "",
+                        const std::string& columnName = "") {
+  /*
+  Build the SQLColumns result set from rows of information_schema.columns,
+  keeping only the rows for tableName and columnName when they are given.
+  Both are exact names, not patterns.
+  */
+  json response       = json::object();
+  response["columns"] = sqlColumnsResultColumns();
+  response["data"]    = json::array();
+  for (const json& row : informationSchemaRows) {
+    // Rows start with table_catalog, table_schema, table_name, column_name.
+    if ((tableName.empty() or row[2] == tableName) and
+        (columnName.empty() or row[3] == columnName)) {
+      response["data"].push_back(sqlColumnsRowFromInformationSchema(row));
+    }
+  }
+  return response;
+}
+
 SQLRETURN SQL_API
 SQLColumns(SQLHSTMT StatementHandle,
            _In_reads_opt_(NameLength1) SQLCHAR* CatalogNameChars,
@@ -117,11 +188,13 @@ SQLColumns(SQLHSTMT StatementHandle,
            _In_reads_opt_(NameLength4) SQLCHAR* ColumnNameChars,
            SQLSMALLINT NameLength4) {
   WriteLog(LL_TRACE, "Entering SQLColumns");
+  TraceSpan span("SQLColumns");
   if (!StatementHandle) {
     WriteLog(LL_ERROR, "  ERROR: Invalid handle in SQLTables");
     return SQL_INVALID_HANDLE;
   }
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
+  statement->trinoQuery->clearCancel();
 
   std::string catalogName = stringFromChar(CatalogNameChars, NameLength1);
   std::string schemaName  = stringFromChar(SchemaNameChars, NameLength2);
@@ -133,10 +206,52 @@ SQLColumns(SQLHSTMT StatementHandle,
   WriteLog(LL_TRACE, "  Requested table: " + tableName);
   WriteLog(LL_TRACE, "  Requested columnName: " + columnName);
 
-  std::string query =
-      constructColumnQuery(catalogName, schemaName, tableName, columnName);
-  statement->trinoQuery->setQuery(query);
-  statement->trinoQuery->post();
+  /*
+  Unlike the other names, the catalog of SQLColumns is an ordinary
+  argument rather than a search pattern, so hive_prod only ever means
+  hive_prod. Applications that escape it anyway get the same catalog.
+  */
+  catalogName = unescapeSearchPattern(catalogName);
+  auto isExactName = [](const std::string& name) {
+    return not name.empty() and not isSearchPattern(name);
+  };
+  TrinoQuery* trinoQuery = statement->trinoQuery;
+  if (not catalogName.empty() and trinoQuery->usesMetadataCache() and
+      isExactName(schemaName) and isExactName(tableName) and
+      not isSearchPattern(columnName)) {
+    // Navigators ask for one table's columns at a time, so fetch the
+    // columns of the whole schema once and answer each table from that.
+    std::optional<json> columns = trinoQuery->getMetadata(
+        constructInformationSchemaColumnQuery(catalogName, schemaName));
+    if (not columns) {
+      return SQL_ERROR;
+    }
+    WriteLog(LL_DEBUG,
+             "  Answering SQLColumns from the columns of schema " +
+                 schemaName);
+    trinoQuery->reset();
+    trinoQuery->sideloadResponse(
+        sqlColumnsResponse((*columns)["data"],
+                           unescapeSearchPattern(tableName),
+                           unescapeSearchPattern(columnName)));
+  } else if (not catalogName.empty()) {
+    // A whole catalog can have more columns than are worth holding at
+    // once, so the rows are reshaped page by page as the application
+    // fetches them.
+    std::string query = constructInformationSchemaColumnQuery(
+        catalogName, schemaName, tableName, columnName);
+    PageReshaper reshaper{sqlColumnsResultColumns(),
+                          sqlColumnsRowFromInformationSchema};
+    if (not trinoQuery->runMetadataQuery(query, reshaper)) {
+      return SQL_ERROR;
+    }
+  } else {
+    std::string query =
+        constructColumnQuery(catalogName, schemaName, tableName, columnName);
+    if (not trinoQuery->runMetadataQuery(query)) {
+      return SQL_ERROR;
+    }
+  }
   statement->executed = true;
   return SQL_SUCCESS;
 }
@@ -1,5 +1,11 @@
 #include "driverConfig.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
 #include "../../util/capitalize.hpp"
+#include "../../util/stringTrim.hpp"
 #include "../../util/writeLog.hpp"
 
 
@@ -57,8 +63,54 @@ std::map<std::string, std::string> DRIVER_CONFIG_DEFAULT_VALUES = {
     std::make_pair("clientSecret", ""),
     std::make_pair("oidcScope", ""),
     std::make_pair("secretEncryptionLevel", "user"),
+    std::make_pair("tlsSessionCache", "false"),
+    std::make_pair("connectTimeoutMs", "10000"),
+    std::make_pair("requestTimeoutMs", "10000"),
+    std::make_pair("retryBudgetMs", "120000"),
+    std::make_pair("endpoints", ""),
+    std::make_pair("maxConcurrentQueries", "0"),
+    std::make_pair("maxEndpointQueries", "0"),
+    std::make_pair("admissionTimeoutMs", "60000"),
+    std::make_pair("injectRowLimit", "false"),
+    std::make_pair("maxPreparedStatements", "64"),
+    std::make_pair("maxBatchBytes", "500000"),
+    std::make_pair("metadataCacheTtlMs", "0"),
+    std::make_pair("resultSchemaCache", "false"),
+    std::make_pair("resultCacheTtlMs", "0"),
+    std::make_pair("resultCacheMaxBytes", "67108864"),
+    std::make_pair("resultCacheDir", ""),
+    std::make_pair("oidcDiscoveryTtlS", "3600"),
+    std::make_pair("traceFile", ""),
 };
 
+/*
+Numeric options come from DSN text that anyone could have typed, so a
+value that isn't a whole number is logged and the option keeps its
+default rather than failing the connection.
+*/
+static long parseLongOption(const std::string& name, std::string value) {
+  trim(value);
+  long result     = 0;
+  const char* end = value.data() + value.size();
+  auto [ptr, ec]  = std::from_chars(value.data(), end, result);
+  if (ec == std::errc() and ptr == end and not value.empty()) {
+    return result;
+  }
+  const std::string& fallback = DRIVER_CONFIG_DEFAULT_VALUES.at(name);
+  WriteLog(LL_WARN,
+           "  Ignoring " + name + "=" + value +
+               ", which is not a whole number. Using " + fallback);
+  return std::stol(fallback);
+}
+
+// Boolean options accept the usual spellings, in any case.
+static bool parseBoolOption(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(), [](char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  });
+  return value == "true" or value == "1" or value == "yes" or value == "on";
+}
+
 // DSN
 std::string DriverConfig::getDSN() {
   return this->dsn;
@@ -173,6 +225,251 @@ void DriverConfig::setGrantType(std::string grantType) {
   this->grantType = grantType;
 }
 
+// TLS Session Cache - Accepts booleans and strings like "true" or "1".
+bool DriverConfig::getTlsSessionCache() {
+  return this->tlsSessionCache;
+}
+std::string DriverConfig::getTlsSessionCacheStr() {
+  return this->tlsSessionCache ? "true" : "false";
+}
+void DriverConfig::setTlsSessionCache(bool tlsSessionCache) {
+  this->tlsSessionCache = tlsSessionCache;
+}
+void DriverConfig::setTlsSessionCache(std::string tlsSessionCache) {
+  this->tlsSessionCache = parseBoolOption(tlsSessionCache);
+}
+
+// Connect Timeout - Accepts and returns both integers and strings.
+long DriverConfig::getConnectTimeoutMs() {
+  return this->connectTimeoutMs;
+}
+std::string DriverConfig::getConnectTimeoutMsStr() {
+  return std::to_string(this->connectTimeoutMs);
+}
+void DriverConfig::setConnectTimeoutMs(long connectTimeoutMs) {
+  this->connectTimeoutMs = connectTimeoutMs;
+}
+void DriverConfig::setConnectTimeoutMs(std::string connectTimeoutMs) {
+  this->connectTimeoutMs =
+      parseLongOption("connectTimeoutMs", connectTimeoutMs);
+}
+
+// Request Timeout - Accepts and returns both integers and strings.
+long DriverConfig::getRequestTimeoutMs() {
+  return this->requestTimeoutMs;
+}
+std::string DriverConfig::getRequestTimeoutMsStr() {
+  return std::to_string(this->requestTimeoutMs);
+}
+void DriverConfig::setRequestTimeoutMs(long requestTimeoutMs) {
+  this->requestTimeoutMs = requestTimeoutMs;
+}
+void DriverConfig::setRequestTimeoutMs(std::string requestTimeoutMs) {
+  this->requestTimeoutMs =
+      parseLongOption("requestTimeoutMs", requestTimeoutMs);
+}
+
+// Retry Budget - Accepts and returns both integers and strings.
+long DriverConfig::getRetryBudgetMs() {
+  return this->retryBudgetMs;
+}
+std::string DriverConfig::getRetryBudgetMsStr() {
+  return std::to_string(this->retryBudgetMs);
+}
+void DriverConfig::setRetryBudgetMs(long retryBudgetMs) {
+  this->retryBudgetMs = retryBudgetMs;
+}
+void DriverConfig::setRetryBudgetMs(std::string retryBudgetMs) {
+  this->retryBudgetMs = parseLongOption("retryBudgetMs", retryBudgetMs);
+}
+
+// Endpoints - Extra coordinator URLs, comma separated.
+std::string DriverConfig::getEndpoints() {
+  return this->endpoints;
+}
+void DriverConfig::setEndpoints(std::string endpoints) {
+  this->endpoints = endpoints;
+}
+
+// Max Concurrent Queries - Accepts and returns both integers and strings.
+long DriverConfig::getMaxConcurrentQueries() {
+  return this->maxConcurrentQueries;
+}
+std::string DriverConfig::getMaxConcurrentQueriesStr() {
+  return std::to_string(this->maxConcurrentQueries);
+}
+void DriverConfig::setMaxConcurrentQueries(long maxConcurrentQueries) {
+  this->maxConcurrentQueries = maxConcurrentQueries;
+}
+void DriverConfig::setMaxConcurrentQueries(std::string maxConcurrentQueries) {
+  this->maxConcurrentQueries =
+      parseLongOption("maxConcurrentQueries", maxConcurrentQueries);
+}
+
+// Max Endpoint Queries - Accepts and returns both integers and strings.
+long DriverConfig::getMaxEndpointQueries() {
+  return this->maxEndpointQueries;
+}
+std::string DriverConfig::getMaxEndpointQueriesStr() {
+  return std::to_string(this->maxEndpointQueries);
+}
+void DriverConfig::setMaxEndpointQueries(long maxEndpointQueries) {
+  this->maxEndpointQueries = maxEndpointQueries;
+}
+void DriverConfig::setMaxEndpointQueries(std::string maxEndpointQueries) {
+  this->maxEndpointQueries =
+      parseLongOption("maxEndpointQueries", maxEndpointQueries);
+}
+
+// Admission Timeout - Accepts and returns both integers and strings.
+long DriverConfig::getAdmissionTimeoutMs() {
+  return this->admissionTimeoutMs;
+}
+std::string DriverConfig::getAdmissionTimeoutMsStr() {
+  return std::to_string(this->admissionTimeoutMs);
+}
+void DriverConfig::setAdmissionTimeoutMs(long admissionTimeoutMs) {
+  this->admissionTimeoutMs = admissionTimeoutMs;
+}
+void DriverConfig::setAdmissionTimeoutMs(std::string admissionTimeoutMs) {
+  this->admissionTimeoutMs =
+      parseLongOption("admissionTimeoutMs", admissionTimeoutMs);
+}
+
+// Inject Row Limit - Accepts booleans and strings like "true" or "1".
+bool DriverConfig::getInjectRowLimit() {
+  return this->injectRowLimit;
+}
+std::string DriverConfig::getInjectRowLimitStr() {
+  return this->injectRowLimit ? "true" : "false";
+}
+void DriverConfig::setInjectRowLimit(bool injectRowLimit) {
+  this->injectRowLimit = injectRowLimit;
+}
+void DriverConfig::setInjectRowLimit(std::string injectRowLimit) {
+  this->injectRowLimit = parseBoolOption(injectRowLimit);
+}
+
+// Max Prepared Statements - Accepts and returns both integers and strings.
+long DriverConfig::getMaxPreparedStatements() {
+  return this->maxPreparedStatements;
+}
+std::string DriverConfig::getMaxPreparedStatementsStr() {
+  return std::to_string(this->maxPreparedStatements);
+}
+void DriverConfig::setMaxPreparedStatements(long maxPreparedStatements) {
+  this->maxPreparedStatements = maxPreparedStatements;
+}
+void DriverConfig::setMaxPreparedStatements(
+    std::string maxPreparedStatements) {
+  this->maxPreparedStatements =
+      parseLongOption("maxPreparedStatements", maxPreparedStatements);
+}
+
+// Max Batch Bytes - Accepts and returns both integers and strings.
+long DriverConfig::getMaxBatchBytes() {
+  return this->maxBatchBytes;
+}
+std::string DriverConfig::getMaxBatchBytesStr() {
+  return std::to_string(this->maxBatchBytes);
+}
+void DriverConfig::setMaxBatchBytes(long maxBatchBytes) {
+  this->maxBatchBytes = maxBatchBytes;
+}
+void DriverConfig::setMaxBatchBytes(std::string maxBatchBytes) {
+  this->maxBatchBytes = parseLongOption("maxBatchBytes", maxBatchBytes);
+}
+
+// Metadata Cache TTL - Accepts and returns both integers and strings.
+long DriverConfig::getMetadataCacheTtlMs() {
+  return this->metadataCacheTtlMs;
+}
+std::string DriverConfig::getMetadataCacheTtlMsStr() {
+  return std::to_string(this->metadataCacheTtlMs);
+}
+void DriverConfig::setMetadataCacheTtlMs(long metadataCacheTtlMs) {
+  this->metadataCacheTtlMs = metadataCacheTtlMs;
+}
+void DriverConfig::setMetadataCacheTtlMs(std::string metadataCacheTtlMs) {
+  this->metadataCacheTtlMs =
+      parseLongOption("metadataCacheTtlMs", metadataCacheTtlMs);
+}
+
+// Result Schema Cache - Accepts booleans and strings like "true" or "1".
+bool DriverConfig::getResultSchemaCache() {
+  return this->resultSchemaCache;
+}
+std::string DriverConfig::getResultSchemaCacheStr() {
+  return this->resultSchemaCache ? "true" : "false";
+}
+void DriverConfig::setResultSchemaCache(bool resultSchemaCache) {
+  this->resultSchemaCache = resultSchemaCache;
+}
+void DriverConfig::setResultSchemaCache(std::string resultSchemaCache) {
+  this->resultSchemaCache = parseBoolOption(resultSchemaCache);
+}
+
+// Result Cache TTL (ms) - Accepts and returns both integers and strings.
+long DriverConfig::getResultCacheTtlMs() {
+  return this->resultCacheTtlMs;
+}
+std::string DriverConfig::getResultCacheTtlMsStr() {
+  return std::to_string(this->resultCacheTtlMs);
+}
+void DriverConfig::setResultCacheTtlMs(long resultCacheTtlMs) {
+  this->resultCacheTtlMs = resultCacheTtlMs;
+}
+void DriverConfig::setResultCacheTtlMs(std::string resultCacheTtlMs) {
+  this->resultCacheTtlMs =
+      parseLongOption("resultCacheTtlMs", resultCacheTtlMs);
+}
+
+// Result Cache Size (bytes) - Accepts and returns both integers and strings.
+long DriverConfig::getResultCacheMaxBytes() {
+  return this->resultCacheMaxBytes;
+}
+std::string DriverConfig::getResultCacheMaxBytesStr() {
+  return std::to_string(this->resultCacheMaxBytes);
+}
+void DriverConfig::setResultCacheMaxBytes(long resultCacheMaxBytes) {
+  this->resultCacheMaxBytes = resultCacheMaxBytes;
+}
+void DriverConfig::setResultCacheMaxBytes(std::string resultCacheMaxBytes) {
+  this->resultCacheMaxBytes =
+      parseLongOption("resultCacheMaxBytes", resultCacheMaxBytes);
+}
+
+// Result Cache Directory
+std::string DriverConfig::getResultCacheDir() {
+  return this->resultCacheDir;
+}
+void DriverConfig::setResultCacheDir(std::string resultCacheDir) {
+  this->resultCacheDir = resultCacheDir;
+}
+
+// OIDC Discovery TTL - Accepts and returns both integers and strings.
+long DriverConfig::getOidcDiscoveryTtlS() {
+  return this->oidcDiscoveryTtlS;
+}
+std::string DriverConfig::getOidcDiscoveryTtlSStr() {
+  return std::to_string(this->oidcDiscoveryTtlS);
+}
+void DriverConfig::setOidcDiscoveryTtlS(long oidcDiscoveryTtlS) {
+  this->oidcDiscoveryTtlS = oidcDiscoveryTtlS;
+}
+void DriverConfig::setOidcDiscoveryTtlS(std::string oidcDiscoveryTtlS) {
+  this->oidcDiscoveryTtlS =
+      parseLongOption("oidcDiscoveryTtlS", oidcDiscoveryTtlS);
+}
+
+// Trace File
+std::string DriverConfig::getTraceFile() {
+  return this->traceFile;
+}
+void DriverConfig::setTraceFile(std::string traceFile) {
+  this->traceFile = traceFile;
+}
+
 // IsSaved
 bool DriverConfig::getIsSaved() {
   return this->isSaved;
@@ -239,6 +536,111 @@ DriverConfig driverConfigFromKVPs(std::map<std::string, std::string> kvps) {
   if (kvps.count("tokenendpoint")) {
     config.setTokenEndpoint(kvps.at("tokenendpoint"));
   }
+  if (kvps.count("tlsSessionCache")) {
+    config.setTlsSessionCache(kvps.at("tlsSessionCache"));
+  }
+  if (kvps.count("tlssessioncache")) {
+    config.setTlsSessionCache(kvps.at("tlssessioncache"));
+  }
+  if (kvps.count("connectTimeoutMs")) {
+    config.setConnectTimeoutMs(kvps.at("connectTimeoutMs"));
+  }
+  if (kvps.count("connecttimeoutms")) {
+    config.setConnectTimeoutMs(kvps.at("connecttimeoutms"));
+  }
+  if (kvps.count("requestTimeoutMs")) {
+    config.setRequestTimeoutMs(kvps.at("requestTimeoutMs"));
+  }
+  if (kvps.count("requesttimeoutms")) {
+    config.setRequestTimeoutMs(kvps.at("requesttimeoutms"));
+  }
+  if (kvps.count("retryBudgetMs")) {
+    config.setRetryBudgetMs(kvps.at("retryBudgetMs"));
+  }
+  if (kvps.count("retrybudgetms")) {
+    config.setRetryBudgetMs(kvps.at("retrybudgetms"));
+  }
+  if (kvps.count("endpoints")) {
+    config.setEndpoints(kvps.at("endpoints"));
+  }
+  if (kvps.count("maxConcurrentQueries")) {
+    config.setMaxConcurrentQueries(kvps.at("maxConcurrentQueries"));
+  }
+  if (kvps.count("maxconcurrentqueries")) {
+    config.setMaxConcurrentQueries(kvps.at("maxconcurrentqueries"));
+  }
+  if (kvps.count("maxEndpointQueries")) {
+    config.setMaxEndpointQueries(kvps.at("maxEndpointQueries"));
+  }
+  if (kvps.count("maxendpointqueries")) {
+    config.setMaxEndpointQueries(kvps.at("maxendpointqueries"));
+  }
+  if (kvps.count("admissionTimeoutMs")) {
+    config.setAdmissionTimeoutMs(kvps.at("admissionTimeoutMs"));
+  }
+  if (kvps.count("admissiontimeoutms")) {
+    config.setAdmissionTimeoutMs(kvps.at("admissiontimeoutms"));
+  }
+  if (kvps.count("injectRowLimit")) {
+    config.setInjectRowLimit(kvps.at("injectRowLimit"));
+  }
+  if (kvps.count("injectrowlimit")) {
+    config.setInjectRowLimit(kvps.at("injectrowlimit"));
+  }
+  if (kvps.count("maxPreparedStatements")) {
+    config.setMaxPreparedStatements(kvps.at("maxPreparedStatements"));
+  }
+  if (kvps.count("maxpreparedstatements")) {
+    config.setMaxPreparedStatements(kvps.at("maxpreparedstatements"));
+  }
+  if (kvps.count("maxBatchBytes")) {
+    config.setMaxBatchBytes(kvps.at("maxBatchBytes"));
+  }
+  if (kvps.count("maxbatchbytes")) {
+    config.setMaxBatchBytes(kvps.at("maxbatchbytes"));
+  }
+  if (kvps.count("metadataCacheTtlMs")) {
+    config.setMetadataCacheTtlMs(kvps.at("metadataCacheTtlMs"));
+  }
+  if (kvps.count("metadatacachettlms")) {
+    config.setMetadataCacheTtlMs(kvps.at("metadatacachettlms"));
+  }
+  if (kvps.count("resultSchemaCache")) {
+    config.setResultSchemaCache(kvps.at("resultSchemaCache"));
+  }
+  if (kvps.count("resultschemacache")) {
+    config.setResultSchemaCache(kvps.at("resultschemacache"));
+  }
+  if (kvps.count("resultCacheTtlMs")) {
+    config.setResultCacheTtlMs(kvps.at("resultCacheTtlMs"));
+  }
+  if (kvps.count("resultcachettlms")) {
+    config.setResultCacheTtlMs(kvps.at("resultcachettlms"));
+  }
+  if (kvps.count("resultCacheMaxBytes")) {
+    config.setResultCacheMaxBytes(kvps.at("resultCacheMaxBytes"));
+  }
+  if (kvps.count("resultcachemaxbytes")) {
+    config.setResultCacheMaxBytes(kvps.at("resultcachemaxbytes"));
+  }
+  if (kvps.count("resultCacheDir")) {
+    config.setResultCacheDir(kvps.at("resultCacheDir"));
+  }
+  if (kvps.count("resultcachedir")) {
+    config.setResultCacheDir(kvps.at("resultcachedir"));
+  }
+  if (kvps.count("oidcDiscoveryTtlS")) {
+    config.setOidcDiscoveryTtlS(kvps.at("oidcDiscoveryTtlS"));
+  }
+  if (kvps.count("oidcdiscoveryttls")) {
+    config.setOidcDiscoveryTtlS(kvps.at("oidcdiscoveryttls"));
+  }
+  if (kvps.count("traceFile")) {
+    config.setTraceFile(kvps.at("traceFile"));
+  }
+  if (kvps.count("tracefile")) {
+    config.setTraceFile(kvps.at("tracefile"));
+  }
 
   return config;
 }
@@ -277,6 +679,30 @@ std::map<std::string, std::string> driverConfigToKVPs(DriverConfig config) {
   if (!config.getOidcScope().empty()) {
     kvps["oidcScope"] = config.getOidcScope();
   }
+  kvps["tlsSessionCache"]  = config.getTlsSessionCacheStr();
+  kvps["connectTimeoutMs"] = config.getConnectTimeoutMsStr();
+  kvps["requestTimeoutMs"] = config.getRequestTimeoutMsStr();
+  kvps["retryBudgetMs"]    = config.getRetryBudgetMsStr();
+  if (!config.getEndpoints().empty()) {
+    kvps["endpoints"] = config.getEndpoints();
+  }
+  kvps["maxConcurrentQueries"]  = config.getMaxConcurrentQueriesStr();
+  kvps["maxEndpointQueries"]    = config.getMaxEndpointQueriesStr();
+  kvps["admissionTimeoutMs"]    = config.getAdmissionTimeoutMsStr();
+  kvps["injectRowLimit"]        = config.getInjectRowLimitStr();
+  kvps["maxPreparedStatements"] = config.getMaxPreparedStatementsStr();
+  kvps["maxBatchBytes"]         = config.getMaxBatchBytesStr();
+  kvps["metadataCacheTtlMs"]    = config.getMetadataCacheTtlMsStr();
+  kvps["resultSchemaCache"]     = config.getResultSchemaCacheStr();
+  kvps["resultCacheTtlMs"]      = config.getResultCacheTtlMsStr();
+  kvps["resultCacheMaxBytes"]   = config.getResultCacheMaxBytesStr();
+  if (!config.getResultCacheDir().empty()) {
+    kvps["resultCacheDir"] = config.getResultCacheDir();
+  }
+  kvps["oidcDiscoveryTtlS"] = config.getOidcDiscoveryTtlSStr();
+  if (!config.getTraceFile().empty()) {
+    kvps["traceFile"] = config.getTraceFile();
+  }
 
   return kvps;
 }
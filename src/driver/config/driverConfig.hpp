@@ -27,6 +27,24 @@ class DriverConfig {
     std::string oidcScope        = "";
     std::string tokenEndpoint    = "";
     std::string grantType        = "";
+    bool tlsSessionCache         = false;
+    long connectTimeoutMs        = 10000;
+    long requestTimeoutMs        = 10000;
+    long retryBudgetMs           = 120000;
+    std::string endpoints        = "";
+    long maxConcurrentQueries    = 0;
+    long maxEndpointQueries      = 0;
+    long admissionTimeoutMs      = 60000;
+    bool injectRowLimit          = false;
+    long maxPreparedStatements   = 64;
+    long maxBatchBytes           = 500000;
+    long metadataCacheTtlMs      = 0;
+    bool resultSchemaCache       = false;
+    long resultCacheTtlMs        = 0;
+    long resultCacheMaxBytes     = 67108864;
+    std::string resultCacheDir   = "";
+    long oidcDiscoveryTtlS       = 3600;
+    std::string traceFile        = "";
 
     // Metadata describing the status of this config object.
     bool isSaved = false;
@@ -77,6 +95,90 @@ class DriverConfig {
     std::string getGrantType();
     void setGrantType(std::string grantType);
 
+    bool getTlsSessionCache();
+    std::string getTlsSessionCacheStr();
+    void setTlsSessionCache(bool tlsSessionCache);
+    void setTlsSessionCache(std::string tlsSessionCache);
+
+    long getConnectTimeoutMs();
+    std::string getConnectTimeoutMsStr();
+    void setConnectTimeoutMs(long connectTimeoutMs);
+    void setConnectTimeoutMs(std::string connectTimeoutMs);
+
+    long getRequestTimeoutMs();
+    std::string getRequestTimeoutMsStr();
+    void setRequestTimeoutMs(long requestTimeoutMs);
+    void setRequestTimeoutMs(std::string requestTimeoutMs);
+
+    long getRetryBudgetMs();
+    std::string getRetryBudgetMsStr();
+    void setRetryBudgetMs(long retryBudgetMs);
+    void setRetryBudgetMs(std::string retryBudgetMs);
+
+    std::string getEndpoints();
+    void setEndpoints(std::string endpoints);
+
+    long getMaxConcurrentQueries();
+    std::string getMaxConcurrentQueriesStr();
+    void setMaxConcurrentQueries(long maxConcurrentQueries);
+    void setMaxConcurrentQueries(std::string maxConcurrentQueries);
+
+    long getMaxEndpointQueries();
+    std::string getMaxEndpointQueriesStr();
+    void setMaxEndpointQueries(long maxEndpointQueries);
+    void setMaxEndpointQueries(std::string maxEndpointQueries);
+
+    long getAdmissionTimeoutMs();
+    std::string getAdmissionTimeoutMsStr();
+    void setAdmissionTimeoutMs(long admissionTimeoutMs);
+    void setAdmissionTimeoutMs(std::string admissionTimeoutMs);
+
+    bool getInjectRowLimit();
+    std::string getInjectRowLimitStr();
+    void setInjectRowLimit(bool injectRowLimit);
+    void setInjectRowLimit(std::string injectRowLimit);
+
+    long getMaxPreparedStatements();
+    std::string getMaxPreparedStatementsStr();
+    void setMaxPreparedStatements(long maxPreparedStatements);
+    void setMaxPreparedStatements(std::string maxPreparedStatements);
+
+    long getMaxBatchBytes();
+    std::string getMaxBatchBytesStr();
+    void setMaxBatchBytes(long maxBatchBytes);
+    void setMaxBatchBytes(std::string maxBatchBytes);
+
+    long getMetadataCacheTtlMs();
+    std::string getMetadataCacheTtlMsStr();
+    void setMetadataCacheTtlMs(long metadataCacheTtlMs);
+    void setMetadataCacheTtlMs(std::string metadataCacheTtlMs);
+
+    bool getResultSchemaCache();
+    std::string getResultSchemaCacheStr();
+    void setResultSchemaCache(bool resultSchemaCache);
+    void setResultSchemaCache(std::string resultSchemaCache);
+
+    long getResultCacheTtlMs();
+    std::string getResultCacheTtlMsStr();
+    void setResultCacheTtlMs(long resultCacheTtlMs);
+    void setResultCacheTtlMs(std::string resultCacheTtlMs);
+
+    long getResultCacheMaxBytes();
+    std::string getResultCacheMaxBytesStr();
+    void setResultCacheMaxBytes(long resultCacheMaxBytes);
+    void setResultCacheMaxBytes(std::string resultCacheMaxBytes);
+
+    std::string getResultCacheDir();
+    void setResultCacheDir(std::string resultCacheDir);
+
+    long getOidcDiscoveryTtlS();
+    std::string getOidcDiscoveryTtlSStr();
+    void setOidcDiscoveryTtlS(long oidcDiscoveryTtlS);
+    void setOidcDiscoveryTtlS(std::string oidcDiscoveryTtlS);
+
+    std::string getTraceFile();
+    void setTraceFile(std::string traceFile);
+
     std::string serialize();
     static DriverConfig deserialize(const std::string& jsonStr);
 };
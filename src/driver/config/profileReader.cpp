@@ -42,6 +42,32 @@ DriverConfig readDriverConfigFromProfile(std::string dsn) {
   config.setOidcDiscoveryUrl(readFromPrivateProfile(dsn, "oidcDiscoveryUrl"));
   config.setClientId(readFromPrivateProfile(dsn, "clientId"));
   config.setOidcScope(readFromPrivateProfile(dsn, "oidcScope"));
+  config.setTlsSessionCache(readFromPrivateProfile(dsn, "tlsSessionCache"));
+  config.setConnectTimeoutMs(readFromPrivateProfile(dsn, "connectTimeoutMs"));
+  config.setRequestTimeoutMs(readFromPrivateProfile(dsn, "requestTimeoutMs"));
+  config.setRetryBudgetMs(readFromPrivateProfile(dsn, "retryBudgetMs"));
+  config.setEndpoints(readFromPrivateProfile(dsn, "endpoints"));
+  config.setMaxConcurrentQueries(
+      readFromPrivateProfile(dsn, "maxConcurrentQueries"));
+  config.setMaxEndpointQueries(
+      readFromPrivateProfile(dsn, "maxEndpointQueries"));
+  config.setAdmissionTimeoutMs(
+      readFromPrivateProfile(dsn, "admissionTimeoutMs"));
+  config.setInjectRowLimit(readFromPrivateProfile(dsn, "injectRowLimit"));
+  config.setMaxPreparedStatements(
+      readFromPrivateProfile(dsn, "maxPreparedStatements"));
+  config.setMaxBatchBytes(readFromPrivateProfile(dsn, "maxBatchBytes"));
+  config.setMetadataCacheTtlMs(
+      readFromPrivateProfile(dsn, "metadataCacheTtlMs"));
+  config.setResultSchemaCache(
+      readFromPrivateProfile(dsn, "resultSchemaCache"));
+  config.setResultCacheTtlMs(readFromPrivateProfile(dsn, "resultCacheTtlMs"));
+  config.setResultCacheMaxBytes(
+      readFromPrivateProfile(dsn, "resultCacheMaxBytes"));
+  config.setResultCacheDir(readFromPrivateProfile(dsn, "resultCacheDir"));
+  config.setOidcDiscoveryTtlS(
+      readFromPrivateProfile(dsn, "oidcDiscoveryTtlS"));
+  config.setTraceFile(readFromPrivateProfile(dsn, "traceFile"));
 
   std::string secretEncryptionLevel =
       readFromPrivateProfile(dsn, "secretEncryptionLevel");
@@ -8,6 +8,7 @@
 #include "handles/connHandle.hpp"
 
 #include "../util/stringFromChar.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 
@@ -20,6 +21,7 @@ SQLRETURN SQL_API SQLConnect(SQLHDBC ConnectionHandle,
                                  SQLCHAR* AuthenticationChars,
                              SQLSMALLINT NameLength3) {
   WriteLog(LL_TRACE, "Entering SQLConnect");
+  TraceSpan span("SQLConnect");
   std::string dsn        = stringFromChar(DSNChars, NameLength1);
   Connection* connection = reinterpret_cast<Connection*>(ConnectionHandle);
   DriverConfig config    = readDriverConfigFromProfile(dsn);
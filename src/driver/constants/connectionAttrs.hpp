@@ -0,0 +1,20 @@
+#pragma once
+
+/*
+ Driver-defined connection attribute to forget
+ cached catalog metadata. Setting it to any value
+ drops every SQLTables and SQLColumns result that
+ is cached for this connection's server and user,
+ so the next call asks Trino again. Useful after
+ creating or altering tables.
+*/
+#define SQL_ATTR_INVALIDATE_METADATA_CACHE 1101
+
+/*
+ Driver-defined connection attribute that reads the
+ timings of every HTTP request the driver has sent, as
+ a null terminated JSON string. They are broken down
+ by endpoint, kind of request and phase of the request,
+ and cover the whole process rather than one connection.
+*/
+#define SQL_ATTR_HTTP_TIMINGS 1102
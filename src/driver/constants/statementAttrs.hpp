@@ -23,3 +23,16 @@
  fetch performance independent of poll performance.
 */
 #define SQL_ATTR_DEFAULT_FETCH_POLL_MODE 1002
+
+/*
+ Driver-defined, read-only statement attribute to get
+ the performance counters of the statement's current
+ query, as a QueryMetrics struct (see
+ trinoAPIWrapper/queryMetrics.hpp). Value must point
+ to a QueryMetrics, and BufferLength must be at least
+ its size.
+
+ The counters are also written to the log at the
+ debug level when the statement is closed.
+*/
+#define SQL_ATTR_QUERY_METRICS 1003
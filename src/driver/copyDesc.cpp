@@ -2,11 +2,13 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLCopyDesc(SQLHDESC SourceDescHandle,
                               SQLHDESC TargetDescHandle) {
   WriteLog(LL_TRACE, "Entering SQLCopyDesc");
+  TraceSpan span("SQLCopyDesc");
 
   WriteLog(LL_ERROR, "  ERROR: SQLCopyDesc is unimplemented");
   return SQL_ERROR;
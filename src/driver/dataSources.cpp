@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLDataSources(SQLHENV EnvironmentHandle,
@@ -15,6 +16,7 @@ SQLRETURN SQL_API SQLDataSources(SQLHENV EnvironmentHandle,
                                  SQLSMALLINT BufferLength2,
                                  _Out_opt_ SQLSMALLINT* NameLength2Ptr) {
   WriteLog(LL_TRACE, "Entering SQLDataSources");
+  TraceSpan span("SQLDataSources");
   WriteLog(LL_ERROR, "  ERROR: SQLDataSources is unimplemented");
   return SQL_ERROR;
 }
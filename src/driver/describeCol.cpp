@@ -4,6 +4,7 @@
 
 #include <map>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 #include "mappings/typeMappings.hpp"
@@ -43,6 +44,7 @@ SQLRETURN SQL_API SQLDescribeCol(SQLHSTMT StatementHandle,
                                  _Out_opt_ SQLSMALLINT* DecimalDigits,
                                  _Out_opt_ SQLSMALLINT* Nullable) {
   WriteLog(LL_TRACE, "Entering SQLDescribeCol");
+  TraceSpan span("SQLDescribeCol");
   WriteLog(LL_TRACE, "  Column index: " + std::to_string(ColumnNumber));
 
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
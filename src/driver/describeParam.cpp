@@ -0,0 +1,81 @@
+#include "../util/windowsLean.hpp"
+#include <sql.h>
+#include <sqlext.h>
+
+#include "../trinoAPIWrapper/columnDescription.hpp"
+#include "../util/traceEvents.hpp"
+#include "../util/writeLog.hpp"
+#include "handles/statementHandle.hpp"
+#include "mappings/typeMappings.hpp"
+
+SQLRETURN SQL_API SQLDescribeParam(SQLHSTMT hstmt,
+                                   SQLUSMALLINT ipar,
+                                   _Out_opt_ SQLSMALLINT* pfSqlType,
+                                   _Out_opt_ SQLULEN* pcbParamDef,
+                                   _Out_opt_ SQLSMALLINT* pibScale,
+                                   _Out_opt_ SQLSMALLINT* pfNullable) {
+  /*
+  Describe one parameter marker of a prepared statement, from the types
+  Trino inferred for it with DESCRIBE INPUT. Trino reports "unknown" when
+  it can't tell, and those are described as varchars, which Trino can
+  convert to whatever the statement needs.
+  */
+  WriteLog(LL_TRACE, "Entering SQLDescribeParam");
+  TraceSpan span("SQLDescribeParam");
+  WriteLog(LL_TRACE, "  Parameter index: " + std::to_string(ipar));
+  Statement* statement = reinterpret_cast<Statement*>(hstmt);
+  if (not statement->trinoQuery->isPrepared()) {
+    WriteLog(LL_ERROR, "  ERROR: SQLDescribeParam called before SQLPrepare");
+    ErrorInfo errorInfo("Function sequence error", "HY010");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  }
+  const std::vector<std::string>& parameterTypes =
+      statement->trinoQuery->getParameterTypes();
+  if (statement->trinoQuery->hasError()) {
+    return SQL_ERROR;
+  }
+  if (ipar < 1 or ipar > parameterTypes.size()) {
+    WriteLog(LL_ERROR, "  ERROR: Invalid parameter number");
+    ErrorInfo errorInfo("Invalid descriptor index", "07009");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  }
+
+  ColumnDescription description(
+      columnJsonFromType("", parameterTypes[ipar - 1]));
+  const std::string& rawType = description.getRawType();
+  const json& typeArguments  = description.getTypeArguments();
+  WriteLog(LL_TRACE, "  Parameter type is: " + description.getType());
+
+  SQLSMALLINT sqlType = SQL_VARCHAR;
+  if (TRINO_RAW_TYPE_TO_ODBC_TYPE_CODE.contains(rawType)) {
+    sqlType = TRINO_RAW_TYPE_TO_ODBC_TYPE_CODE.at(rawType);
+  }
+  SQLULEN size      = 0;
+  SQLSMALLINT scale = 0;
+  if (rawType == "varchar" or rawType == "decimal") {
+    // Varchar lengths and decimal precisions are type arguments.
+    size = typeArguments[0]["value"].get<SQLULEN>();
+    if (rawType == "decimal") {
+      scale = typeArguments[1]["value"].get<SQLSMALLINT>();
+    }
+  } else if (TRINO_RAW_TYPE_TO_ODBC_SIZE_BYTES.contains(rawType)) {
+    size = TRINO_RAW_TYPE_TO_ODBC_SIZE_BYTES.at(rawType);
+  }
+
+  if (pfSqlType) {
+    *pfSqlType = sqlType;
+  }
+  if (pcbParamDef) {
+    *pcbParamDef = size;
+  }
+  if (pibScale) {
+    *pibScale = scale;
+  }
+  if (pfNullable) {
+    // Any parameter may be given a NULL.
+    *pfNullable = SQL_NULLABLE;
+  }
+  return SQL_SUCCESS;
+}
@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include <chrono>
 #include <map>
 #include <string>
 
@@ -10,6 +11,7 @@
 
 #include "../util/delimKvpHelper.hpp"
 #include "../util/stringFromChar.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLDriverConnect(SQLHDBC ConnectionHandle,
@@ -23,6 +25,7 @@ SQLRETURN SQL_API SQLDriverConnect(SQLHDBC ConnectionHandle,
                                    _Out_opt_ SQLSMALLINT* StringLength2Ptr,
                                    SQLUSMALLINT DriverCompletion) {
   WriteLog(LL_TRACE, "Entering SQLDriverConnect");
+  TraceSpan span("SQLDriverConnect");
   Connection* connection = reinterpret_cast<Connection*>(ConnectionHandle);
 
   if (InConnectionChars == nullptr) {
@@ -39,6 +42,7 @@ SQLRETURN SQL_API SQLDriverConnect(SQLHDBC ConnectionHandle,
   std::map<std::string, std::string> kvps =
       parseKVPsFromSemicolonDelimStr(inputConnStr);
 
+  auto profileStart = std::chrono::steady_clock::now();
   if (kvps.count("dsn")) {
     WriteLog(LL_TRACE, "  An explicit DSN was provided to SQLDriverConnect");
     // This means there was an explict DSN passed in. We should use whatever
@@ -70,6 +74,13 @@ SQLRETURN SQL_API SQLDriverConnect(SQLHDBC ConnectionHandle,
   // until we've read the DSN in some way.
   WriteLog(LL_TRACE, "  Setting Log Level");
   setLogLevel(config.getLogLevelEnum());
+  WriteLog(LL_DEBUG,
+           "  Connect: reading the configuration took " +
+               std::to_string(
+                   std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - profileStart)
+                       .count()) +
+               " ms");
 
   WriteLog(LL_TRACE, "  Configuring connection");
   try {
@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLDrivers(SQLHENV henv,
@@ -15,6 +16,7 @@ SQLRETURN SQL_API SQLDrivers(SQLHENV henv,
                              SQLSMALLINT cchDrvrAttrMax,
                              _Out_opt_ SQLSMALLINT* pcchDrvrAttr) {
   WriteLog(LL_TRACE, "Entering SQLDrivers");
+  TraceSpan span("SQLDrivers");
   WriteLog(LL_ERROR, "  ERROR: This is not implemented");
   return SQL_ERROR;
 }
@@ -2,12 +2,14 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLEndTran(SQLSMALLINT HandleType,
                              SQLHANDLE Handle,
                              SQLSMALLINT CompletionType) {
   WriteLog(LL_TRACE, "Entering SQLEndTran");
+  TraceSpan span("SQLEndTran");
   /*
   Trino supplies HTTP headers to accomplish this.
   We need to parse/handle them to enable this functionality.
@@ -2,8 +2,10 @@
 #include <sql.h>
 #include <string.h>
 
+#include "../trinoAPIWrapper/trinoExceptions.hpp"
 #include "../trinoAPIWrapper/trinoQuery.hpp"
 #include "../util/stringFromChar.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
@@ -12,6 +14,7 @@ SQLRETURN SQL_API SQLExecDirect(SQLHSTMT StatementHandle,
                                     SQLCHAR* StatementText,
                                 SQLINTEGER TextLength) {
   WriteLog(LL_TRACE, "Entering SQLExecDirect");
+  TraceSpan span("SQLExecDirect");
 
   if (not StatementText) {
     WriteLog(LL_ERROR, " ERROR: No StatementText defined for query");
@@ -25,6 +28,9 @@ SQLRETURN SQL_API SQLExecDirect(SQLHSTMT StatementHandle,
     std::string queryText = stringFromChar(StatementText, TextLength);
     WriteLog(LL_DEBUG, "  Query: " + queryText);
     TrinoQuery* trinoQuery = statement->trinoQuery;
+    trinoQuery->clearCancel();
+    // Direct execution replaces anything prepared on this statement.
+    trinoQuery->clearPrepared();
     WriteLog(LL_DEBUG, "  Setting Query");
     trinoQuery->setQuery(queryText);
     WriteLog(LL_DEBUG, "  POSTing Query");
@@ -32,6 +38,18 @@ SQLRETURN SQL_API SQLExecDirect(SQLHSTMT StatementHandle,
     WriteLog(LL_DEBUG, "  Setting to executed");
     statement->executed = true;
     return SQL_SUCCESS;
+  } catch (const CancelledError& ex) {
+    WriteLog(LL_INFO, "  SQLExecDirect was canceled");
+    ErrorInfo errorInfo(ex.what(), "HY008");
+    statementPtr->setError(errorInfo);
+    return SQL_ERROR;
+  } catch (const TimeoutError& ex) {
+    WriteLog(LL_ERROR,
+             "  ERROR: Timeout during SQLExecDirect: " +
+                 std::string(ex.what()));
+    ErrorInfo errorInfo(ex.what(), "HYT00");
+    statementPtr->setError(errorInfo);
+    return SQL_ERROR;
   } catch (const std::exception& ex) {
     WriteLog(LL_ERROR,
              "  ERROR: Exception thrown during SQLExecDirect: " +
@@ -2,10 +2,82 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include <string>
+#include <vector>
+
+#include "../trinoAPIWrapper/trinoExceptions.hpp"
+#include "../trinoAPIWrapper/trinoQuery.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
+#include "handles/statementHandle.hpp"
 
 SQLRETURN SQL_API SQLExecute(SQLHSTMT StatementHandle) {
+  /*
+  Run the statement prepared by SQLPrepare with the current values of its
+  bound parameters. Executing the same statement again only sends a short
+  EXECUTE, never the statement text. With SQL_ATTR_PARAMSET_SIZE above one,
+  the statement runs for every set of values in the bound arrays.
+  */
   WriteLog(LL_TRACE, "Entering SQLExecute");
-  WriteLog(LL_ERROR, "  ERROR: SQLExecute unimplemented");
-  return SQL_ERROR;
+  TraceSpan span("SQLExecute");
+  Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
+  statement->trinoQuery->clearCancel();
+
+  if (not statement->trinoQuery->isPrepared()) {
+    WriteLog(LL_ERROR, "  ERROR: SQLExecute called before SQLPrepare");
+    ErrorInfo errorInfo("Function sequence error", "HY010");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  }
+
+  try {
+    if (statement->getParamDescriptor()->Field_ArraySize > 1) {
+      if (statement->executed) {
+        statement->terminateInBackground();
+        statement->reset();
+      }
+      WriteLog(LL_DEBUG,
+               "  Executing prepared statement for each parameter set");
+      return statement->executeParameterArray();
+    }
+    std::vector<std::string> parameters;
+    if (not statement->getParameterLiterals(parameters)) {
+      statement->setParamStatus(0, 1, SQL_PARAM_ERROR);
+      return SQL_ERROR;
+    }
+    // Results from the last execution are no longer wanted.
+    if (statement->executed) {
+      statement->terminateInBackground();
+      statement->reset();
+    }
+    WriteLog(LL_DEBUG, "  Executing prepared statement");
+    statement->setParamsProcessed(1);
+    if (not statement->trinoQuery->executePrepared(parameters)) {
+      statement->setParamStatus(0, 1, SQL_PARAM_ERROR);
+      return SQL_ERROR;
+    }
+    statement->setParamStatus(0, 1, SQL_PARAM_SUCCESS);
+    statement->executed = true;
+    return SQL_SUCCESS;
+  } catch (const CancelledError& ex) {
+    WriteLog(LL_INFO, "  SQLExecute was canceled");
+    ErrorInfo errorInfo(ex.what(), "HY008");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  } catch (const TimeoutError& ex) {
+    WriteLog(LL_ERROR,
+             "  ERROR: Timeout during SQLExecute: " + std::string(ex.what()));
+    ErrorInfo errorInfo(ex.what(), "HYT00");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  } catch (const std::exception& ex) {
+    WriteLog(LL_ERROR,
+             "  ERROR: Exception thrown during SQLExecute: " +
+                 std::string(ex.what()));
+    ErrorInfo errorInfo("Exception thrown during SQLExecute: " +
+                            std::string(ex.what()),
+                        "HY000");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  }
 }
@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLExtendedFetch(SQLHSTMT hstmt,
@@ -10,6 +11,7 @@ SQLRETURN SQL_API SQLExtendedFetch(SQLHSTMT hstmt,
                                    _Out_opt_ SQLULEN* pcrow,
                                    _Out_opt_ SQLUSMALLINT* rgfRowStatus) {
   WriteLog(LL_TRACE, "Entering SQLExtendedFetch");
+  TraceSpan span("SQLExtendedFetch");
   WriteLog(LL_ERROR, "  ERROR: SQLExtendedFetch unimplemented");
   return SQL_ERROR;
 }
@@ -6,6 +6,7 @@
 
 #include "../trinoAPIWrapper/trinoQuery.hpp"
 #include "../util/rowToBuffer.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/descriptorHandle.hpp"
 #include "handles/statementHandle.hpp"
@@ -28,6 +29,7 @@ static void handleBoundColumns(Statement* statement) {
   Descriptor* rowDescriptor = statement->getRowDescriptor();
   SQLLEN fetchedPosition    = statement->getFetchedPosition();
   const json& rowData = statement->trinoQuery->getRowAtIndex(fetchedPosition);
+  MetricsTimer timer(statement->trinoQuery->getMetrics().conversionUs);
 
   // Field indices start at 1 because index 0 is the "bookmark" column.
   for (auto i = 1; i <= columnCount; i++) {
@@ -68,15 +70,7 @@ static void handleBoundColumns(Statement* statement) {
   }
 }
 
-SQLRETURN SQL_API SQLFetch(SQLHSTMT StatementHandle) {
-  WriteLog(LL_TRACE, "Entering SQLFetch");
-  if (!StatementHandle) {
-    WriteLog(LL_ERROR, "  ERROR: Invalid statement handle");
-    return SQL_INVALID_HANDLE;
-  }
-
-  WriteLog(LL_TRACE, "  Getting Handles");
-  Statement* statement   = reinterpret_cast<Statement*>(StatementHandle);
+static SQLRETURN fetchNextRow(Statement* statement) {
   TrinoQuery* trinoQuery = statement->trinoQuery;
 
   WriteLog(LL_TRACE, "  Checking row counts and completion");
@@ -128,10 +122,15 @@ SQLRETURN SQL_API SQLFetch(SQLHSTMT StatementHandle) {
     TrinoQueryPollMode pollMethod = statement->fetchPollMode;
     statement->trinoQuery->poll(pollMethod);
     WriteLog(LL_TRACE, "  Trino poll complete");
+    if (trinoQuery->hasError()) {
+      // Polling gave up on reaching Trino. The details are on the query
+      // for SQLGetDiagRec to report.
+      return SQL_ERROR;
+    }
     int64_t newTrinoRowCount = trinoQuery->getCurrentRowCount();
     WriteLog(LL_TRACE, "  Got row count: " + std::to_string(newTrinoRowCount));
 
-    return SQLFetch(StatementHandle);
+    return fetchNextRow(statement);
 
   } else {
     WriteLog(LL_ERROR, "  ERROR: This should not be happening");
@@ -142,4 +141,30 @@ SQLRETURN SQL_API SQLFetch(SQLHSTMT StatementHandle) {
              "  trinoQueryRowCount: " + std::to_string(trinoQueryRowCount));
     return SQL_ERROR;
   }
-};
+}
+
+SQLRETURN SQL_API SQLFetch(SQLHSTMT StatementHandle) {
+  WriteLog(LL_TRACE, "Entering SQLFetch");
+  TraceSpan span("SQLFetch");
+  if (!StatementHandle) {
+    WriteLog(LL_ERROR, "  ERROR: Invalid statement handle");
+    return SQL_INVALID_HANDLE;
+  }
+
+  WriteLog(LL_TRACE, "  Getting Handles");
+  Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
+  SQLRETURN ret        = fetchNextRow(statement);
+
+  // Results described from the result schema cache may turn out to have
+  // a different shape once Trino sends the real columns. The application
+  // is told even when no rows came back, since what it described is not
+  // what the query returned.
+  if (statement->trinoQuery->takeColumnsChanged() and
+      (ret == SQL_SUCCESS or ret == SQL_SUCCESS_WITH_INFO or
+       ret == SQL_NO_DATA)) {
+    statement->setError(ErrorInfo(
+        "The result columns changed since they were described", "01000"));
+    return ret == SQL_NO_DATA ? SQL_NO_DATA : SQL_SUCCESS_WITH_INFO;
+  }
+  return ret;
+}
@@ -2,12 +2,14 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLFetchScroll(SQLHSTMT StatementHandle,
                                  SQLSMALLINT FetchOrientation,
                                  SQLLEN FetchOffset) {
   WriteLog(LL_TRACE, "Entering SQLFetchScroll");
+  TraceSpan span("SQLFetchScroll");
   WriteLog(LL_ERROR, "  ERROR: SQLFetchScroll is unimplemented");
   return SQL_ERROR;
 }
@@ -1,6 +1,7 @@
 #include "../util/windowsLean.hpp"
 #include <sql.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/connHandle.hpp"
 #include "handles/descriptorHandle.hpp"
@@ -11,6 +12,7 @@ using namespace std;
 
 SQLRETURN SQL_API SQLFreeHandle(SQLSMALLINT HandleType, SQLHANDLE Handle) {
   WriteLog(LL_TRACE, "Entering SQLFreeHandle");
+  TraceSpan span("SQLFreeHandle");
   if (Handle == SQL_NULL_HANDLE) {
     WriteLog(LL_ERROR, "  ERROR: Invalid handle in SQLFreeHandle");
     return SQL_INVALID_HANDLE;
@@ -46,8 +48,9 @@ SQLRETURN SQL_API SQLFreeHandle(SQLSMALLINT HandleType, SQLHANDLE Handle) {
       // is ready to be freed. We can prevent it from leaving Trino
       // queries hanging in the `FINISHING` state by doing a terminate()
       // before we free the statement. Conveniently, that does nothing
-      // if a query is not currently running.
-      stmt->terminate();
+      // if a query is not currently running. The terminate is sent in
+      // the background since nobody is left to wait for it.
+      stmt->terminateInBackground();
       delete stmt;
       return SQL_SUCCESS;
     }
@@ -2,17 +2,22 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
 SQLRETURN SQL_API SQLFreeStmt(SQLHSTMT StatementHandle, SQLUSMALLINT Option) {
   WriteLog(LL_TRACE, "Entering SQLFreeStmt");
+  TraceSpan span("SQLFreeStmt");
   Statement* stmt = reinterpret_cast<Statement*>(StatementHandle);
   switch (Option) {
     case (SQL_CLOSE): {
       WriteLog(
           LL_TRACE,
           "  Closing statement with SQL_CLOSE. The statement may be reused.");
+      // Closing the cursor discards any pending results, so a query that
+      // is still running needs to be stopped.
+      stmt->terminateInBackground();
       stmt->reset();
       return SQL_SUCCESS;
     }
@@ -27,10 +32,9 @@ SQLRETURN SQL_API SQLFreeStmt(SQLHSTMT StatementHandle, SQLUSMALLINT Option) {
       return SQL_ERROR;
     }
     case (SQL_RESET_PARAMS): {
-      WriteLog(
-          LL_ERROR,
-          "  ERROR: Unimplemented: Closing statement with SQL_RESET_PARAMS");
-      return SQL_ERROR;
+      WriteLog(LL_TRACE, "  Unbinding all parameters with SQL_RESET_PARAMS");
+      stmt->resetParams();
+      return SQL_SUCCESS;
     }
     default: {
       WriteLog(LL_ERROR, "  ERROR: Unknown option in SQLFreeStmt");
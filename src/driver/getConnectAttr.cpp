@@ -2,8 +2,12 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../trinoAPIWrapper/httpTimings.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/valuePtrHelper.hpp"
 #include "../util/writeLog.hpp"
+#include "constants/connectionAttrs.hpp"
+#include "handles/connHandle.hpp"
 
 
 SQLRETURN SQL_API SQLGetConnectAttr(
@@ -13,6 +17,7 @@ SQLRETURN SQL_API SQLGetConnectAttr(
     SQLINTEGER BufferLength,
     _Out_opt_ SQLINTEGER* StringLengthPtr) {
   WriteLog(LL_TRACE, "Entering SQLGetConnectAttr");
+  TraceSpan span("SQLGetConnectAttr");
   WriteLog(LL_TRACE,
            "  Application is requesting connection attribute: " +
                std::to_string(Attribute));
@@ -25,6 +30,30 @@ SQLRETURN SQL_API SQLGetConnectAttr(
       writeNullTermStringToPtr(Value, "system", StringLengthPtr);
       break;
     }
+    case SQL_ATTR_HTTP_TIMINGS: { // 1102
+      // Driver defined - HTTP timings as JSON.
+      std::string timings = getHttpTimings().toJson();
+      SQLINTEGER length   = static_cast<SQLINTEGER>(timings.size());
+      if (StringLengthPtr) {
+        *StringLengthPtr = length;
+      }
+      if (Value and length >= BufferLength) {
+        // Too long for the buffer, so the application gets as much as
+        // fits and a warning.
+        if (BufferLength > 0) {
+          char* valueChars = reinterpret_cast<char*>(Value);
+          memcpy(valueChars, timings.c_str(), BufferLength - 1);
+          valueChars[BufferLength - 1] = '\0';
+        }
+        Connection* connection =
+            reinterpret_cast<Connection*>(ConnectionHandle);
+        connection->setError(
+            ErrorInfo("String data, right truncated", "01004"));
+        return SQL_SUCCESS_WITH_INFO;
+      }
+      writeNullTermStringToPtr(Value, timings, StringLengthPtr);
+      break;
+    }
     default: {
       WriteLog(LL_ERROR,
                "  ERROR: Application is requesting unimplemented connection "
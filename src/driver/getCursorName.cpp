@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLGetCursorName(SQLHSTMT StatementHandle,
@@ -10,6 +11,7 @@ SQLRETURN SQL_API SQLGetCursorName(SQLHSTMT StatementHandle,
                                    SQLSMALLINT BufferLength,
                                    _Out_opt_ SQLSMALLINT* NameLengthPtr) {
   WriteLog(LL_TRACE, "Entering SQLGetCursorName");
+  TraceSpan span("SQLGetCursorName");
   WriteLog(LL_ERROR, "  ERROR: SQLGetCursorName unimplemented");
   return SQL_ERROR;
 }
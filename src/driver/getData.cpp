@@ -8,6 +8,7 @@
 
 #include "../trinoAPIWrapper/columnDescription.hpp"
 #include "../util/rowToBuffer.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
@@ -37,6 +38,7 @@ SQLRETURN SQL_API SQLGetData(SQLHSTMT StatementHandle,
   the size of the buffer provided by the application.
   */
   WriteLog(LL_TRACE, "Entering SQLGetData");
+  TraceSpan span("SQLGetData");
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
 
   const std::vector<ColumnDescription>& columnDescriptions =
@@ -83,6 +85,7 @@ SQLRETURN SQL_API SQLGetData(SQLHSTMT StatementHandle,
     WriteLog(LL_TRACE, "  CDataType is: " + std::to_string(cDataType));
   }
 
+  MetricsTimer timer(statement->trinoQuery->getMetrics().conversionUs);
   ColumnToBufferStatus status = columnToBuffer(cDataType,
                                                odbcDataType,
                                                rowData,
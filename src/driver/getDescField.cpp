@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/descriptorHandle.hpp"
 
@@ -14,6 +15,7 @@ SQLRETURN SQL_API SQLGetDescField(
     _Out_opt_ SQLINTEGER* StringLength) {
   Descriptor* descriptor = reinterpret_cast<Descriptor*>(DescriptorHandle);
   WriteLog(LL_TRACE, "Entering SQLGetDescField");
+  TraceSpan span("SQLGetDescField");
   WriteLog(LL_TRACE,
            "  Descriptor handle is :" +
                std::to_string((uintptr_t)(void**)descriptor));
@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLGetDescRec(SQLHDESC DescriptorHandle,
@@ -16,6 +17,7 @@ SQLRETURN SQL_API SQLGetDescRec(SQLHDESC DescriptorHandle,
                                 _Out_opt_ SQLSMALLINT* ScalePtr,
                                 _Out_opt_ SQLSMALLINT* NullablePtr) {
   WriteLog(LL_TRACE, "Entering SQLGetDescRec");
+  TraceSpan span("SQLGetDescRec");
   WriteLog(LL_ERROR, "  ERROR: SQLGetDescRec unimplemented");
   return SQL_ERROR;
 }
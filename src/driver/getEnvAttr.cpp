@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/envHandle.hpp"
 
@@ -12,6 +13,7 @@ SQLRETURN SQL_API SQLGetEnvAttr(SQLHENV EnvironmentHandle,
                                 SQLINTEGER BufferLength,
                                 _Out_opt_ SQLINTEGER* StringLength) {
   WriteLog(LL_TRACE, "Entering SQLGetEnvAttr");
+  TraceSpan span("SQLGetEnvAttr");
 
   if (!EnvironmentHandle) {
     WriteLog(LL_ERROR, "  ERROR: EnvironmentHandle is invalid.");
@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 std::vector<SQLUSMALLINT> SUPPORTED_FUNCTIONS{
@@ -23,6 +24,7 @@ std::vector<SQLUSMALLINT> SUPPORTED_FUNCTIONS{
     SQL_API_SQLCOPYDESC,
     SQL_API_SQLDATASOURCES,
     SQL_API_SQLDESCRIBECOL,
+    SQL_API_SQLDESCRIBEPARAM,
     SQL_API_SQLDISCONNECT,
     SQL_API_SQLDRIVERCONNECT,
     SQL_API_SQLDRIVERS,
@@ -99,6 +101,7 @@ SQLRETURN SQL_API SQLGetFunctions(
         "Buffer length pfExists points to depends on fFunction value."))
         SQLUSMALLINT* Supported) {
   WriteLog(LL_TRACE, "Entering SQLGetFunctions");
+  TraceSpan span("SQLGetFunctions");
   if (Supported == nullptr) {
     WriteLog(LL_ERROR, "  ERROR: Supported array is null");
     return SQL_ERROR;
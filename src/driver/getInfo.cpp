@@ -5,6 +5,7 @@
 #include <string>
 
 #include "../util/valuePtrHelper.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/connHandle.hpp"
 
@@ -16,6 +17,7 @@ _Success_(return == SQL_SUCCESS) SQLRETURN SQL_API
                _Out_opt_ SQLSMALLINT* StringLengthPtr) {
   Connection* connection = reinterpret_cast<Connection*>(ConnectionHandle);
   WriteLog(LL_TRACE, "Entering SQLGetInfo");
+  TraceSpan span("SQLGetInfo");
   WriteLog(LL_TRACE,
            "  Requesting information type: " + std::to_string(InfoType));
 
@@ -44,11 +46,9 @@ _Success_(return == SQL_SUCCESS) SQLRETURN SQL_API
       break;
     }
     case SQL_SEARCH_PATTERN_ESCAPE: { // 14
-      // Trino supports escapes in search patterns:
-      // x LIKE y ESCAPE '/'
-      // but that's not a hard-coded constant like this driver is expecting.
-      // So we return empty string = no escaping supported.
-      writeNullTermStringToPtr(InfoValue, "", StringLengthPtr);
+      // The catalog functions turn search patterns into
+      // x LIKE y ESCAPE '\', so a backslash escapes % and _ in them.
+      writeNullTermStringToPtr(InfoValue, "\\", StringLengthPtr);
       break;
     }
     case SQL_DBMS_NAME: { // 17
@@ -57,7 +57,8 @@ _Success_(return == SQL_SUCCESS) SQLRETURN SQL_API
       break;
     }
     case SQL_DBMS_VER: { // 18
-      // What's the version of this DBMS? We have to query to find out.
+      // What's the version of this DBMS? The connection reads it from
+      // /v1/info once, while it's being set up.
       // It must be of the form ##.##.####, but Trino doesn't do that.
       // We're allow to append a product-specific version, so we will
       // put the actual version there.
@@ -2,6 +2,8 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../trinoAPIWrapper/queryMetrics.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "constants/statementAttrs.hpp"
 #include "handles/statementHandle.hpp"
@@ -13,6 +15,7 @@ SQLRETURN SQL_API SQLGetStmtAttr(SQLHSTMT StatementHandle,
                                  SQLINTEGER BufferLength,
                                  _Out_opt_ SQLINTEGER* StringLength) {
   WriteLog(LL_TRACE, "Entering SQLGetStmtAttr");
+  TraceSpan span("SQLGetStmtAttr");
   if (!StatementHandle) {
     WriteLog(LL_ERROR, "  ERROR: Invalid statement handle");
     if (Value) {
@@ -27,6 +30,24 @@ SQLRETURN SQL_API SQLGetStmtAttr(SQLHSTMT StatementHandle,
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
 
   switch (Attribute) {
+    case SQL_ATTR_QUERY_TIMEOUT: { // 0
+      if (Value) {
+        *reinterpret_cast<SQLULEN*>(Value) = statement->queryTimeout;
+      }
+      if (StringLength) {
+        *StringLength = sizeof(SQLULEN);
+      }
+      break;
+    }
+    case SQL_ATTR_MAX_ROWS: { // 1
+      if (Value) {
+        *reinterpret_cast<SQLULEN*>(Value) = statement->maxRows;
+      }
+      if (StringLength) {
+        *StringLength = sizeof(SQLULEN);
+      }
+      break;
+    }
     case SQL_ATTR_ROW_NUMBER: { // 14
       if (Value) {
         *reinterpret_cast<SQLULEN*>(Value) = statement->getFetchedPosition();
@@ -36,6 +57,56 @@ SQLRETURN SQL_API SQLGetStmtAttr(SQLHSTMT StatementHandle,
       }
       break;
     }
+    case SQL_ATTR_PARAM_BIND_OFFSET_PTR: { // 17
+      if (Value) {
+        *reinterpret_cast<SQLPOINTER*>(Value) =
+            statement->getParamDescriptor()->Field_BindOffsetPtr;
+      }
+      if (StringLength) {
+        *StringLength = sizeof(SQLPOINTER);
+      }
+      break;
+    }
+    case SQL_ATTR_PARAM_BIND_TYPE: { // 18
+      if (Value) {
+        *reinterpret_cast<SQLULEN*>(Value) =
+            statement->getParamDescriptor()->Field_BindType;
+      }
+      if (StringLength) {
+        *StringLength = sizeof(SQLULEN);
+      }
+      break;
+    }
+    case SQL_ATTR_PARAM_STATUS_PTR: { // 20
+      if (Value) {
+        *reinterpret_cast<SQLPOINTER*>(Value) =
+            statement->getParamDescriptor()->Field_ArrayStatusPtr;
+      }
+      if (StringLength) {
+        *StringLength = sizeof(SQLPOINTER);
+      }
+      break;
+    }
+    case SQL_ATTR_PARAMS_PROCESSED_PTR: { // 21
+      if (Value) {
+        *reinterpret_cast<SQLPOINTER*>(Value) =
+            statement->getParamDescriptor()->Field_RowsProcessedPtr;
+      }
+      if (StringLength) {
+        *StringLength = sizeof(SQLPOINTER);
+      }
+      break;
+    }
+    case SQL_ATTR_PARAMSET_SIZE: { // 22
+      if (Value) {
+        *reinterpret_cast<SQLULEN*>(Value) =
+            statement->getParamDescriptor()->Field_ArraySize;
+      }
+      if (StringLength) {
+        *StringLength = sizeof(SQLULEN);
+      }
+      break;
+    }
     case SQL_ATTR_APP_ROW_DESC: { // 10010
       if (Value) {
         *reinterpret_cast<SQLPOINTER*>(Value) = statement->appRowDesc;
@@ -82,6 +153,24 @@ SQLRETURN SQL_API SQLGetStmtAttr(SQLHSTMT StatementHandle,
       }
       break;
     }
+    case SQL_ATTR_QUERY_METRICS: { // 1003
+      // Driver defined - performance counters for the current execution.
+      SQLINTEGER size = sizeof(QueryMetrics);
+      if (Value and BufferLength < size) {
+        ErrorInfo errorInfo("Invalid string or buffer length", "HY090");
+        statement->setError(errorInfo);
+        return SQL_ERROR;
+      }
+      if (Value) {
+        QueryMetrics metrics = statement->priorMetrics;
+        addQueryMetrics(metrics, statement->trinoQuery->getMetrics());
+        *reinterpret_cast<QueryMetrics*>(Value) = metrics;
+      }
+      if (StringLength) {
+        *StringLength = size;
+      }
+      break;
+    }
     default: {
       WriteLog(LL_ERROR,
                "  ERROR: Unsupported attribute: " + std::to_string(Attribute));
@@ -3,8 +3,11 @@
 #include <sqlext.h>
 
 #include <map>
+#include <memory>
 #include <nlohmann/json.hpp>
 
+#include "../trinoAPIWrapper/syntheticResultSet.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
@@ -149,70 +152,75 @@ TypeInfo decimalTypeInfo   = TypeInfo(  "DECIMAL",   SQL_DECIMAL,          39,
 // clang-format on
 
 
+static std::shared_ptr<const SyntheticResultSet>
+typeInfoResultSet(std::vector<json> rows) {
+  auto result     = std::make_shared<SyntheticResultSet>();
+  result->columns = columnDescription["columns"].get<std::vector<json>>();
+  result->rows    = std::move(rows);
+  return result;
+}
+
+/*
+The type information never changes, so the result set for each type code
+is built the first time any statement asks for it and shared from then on.
+Applications tend to ask for it on every connection.
+*/
+static const std::map<SQLSMALLINT, std::shared_ptr<const SyntheticResultSet>>&
+typeInfoResultSets() {
+  static const std::map<SQLSMALLINT, std::shared_ptr<const SyntheticResultSet>>
+      resultSets = {
+          // TODO: JSON TYPE
+          // TODO: INTERVAL TYPE
+          // TODO: ARRAY TYPE
+          // TODO: MAP TYPE
+          // TODO: TIME/TIMESTAMP WITH TIME ZONE?
+          {SQL_ALL_TYPES,
+           typeInfoResultSet({
+               varcharTypeInfo.toJson(),
+               varbinaryTypeInfo.toJson(),
+               bitTypeInfo.toJson(),
+               tinyintTypeInfo.toJson(),
+               smallintTypeInfo.toJson(),
+               integerTypeInfo.toJson(),
+               bigintTypeInfo.toJson(),
+               realTypeInfo.toJson(),
+               doubleTypeInfo.toJson(),
+               guidTypeInfo.toJson(),
+               dateTypeInfo.toJson(),
+               timeTypeInfo.toJson(),
+               timestampTypeInfo.toJson(),
+               decimalTypeInfo.toJson(),
+           })},
+          // TODO: Does WVARCHAR exist in Trino?
+          // Is WVARCHAR any different than varchar?
+          // I'm guessing Trino uses UTF-8, and not any wide varchars.
+          {SQL_WVARCHAR, typeInfoResultSet({varcharTypeInfo.toJson()})},
+          {SQL_VARCHAR, typeInfoResultSet({varcharTypeInfo.toJson()})},
+          {SQL_VARBINARY, typeInfoResultSet({varbinaryTypeInfo.toJson()})},
+          {SQL_TIMESTAMP, typeInfoResultSet({timestampTypeInfo.toJson()})},
+          {SQL_TYPE_TIMESTAMP,
+           typeInfoResultSet({timestampTypeInfo.toJson()})},
+      };
+  return resultSets;
+}
+
 SQLRETURN SQL_API SQLGetTypeInfo(SQLHSTMT StatementHandle,
                                  SQLSMALLINT DataType) {
   WriteLog(LL_TRACE, "Entering SQLGetTypeInfo");
+  TraceSpan span("SQLGetTypeInfo");
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
   WriteLog(LL_TRACE,
            "  Requesting type info for type code: " + std::to_string(DataType));
 
-  json typeResponse = columnDescription;
-  switch (DataType) {
-    case SQL_ALL_TYPES: {
-      // TODO: JSON TYPE
-      // TODO: INTERVAL TYPE
-      // TODO: ARRAY TYPE
-      // TODO: MAP TYPE
-      // TODO: TIME/TIMESTAMP WITH TIME ZONE?
-      typeResponse["data"] = json::array({
-          varcharTypeInfo.toJson(),
-          varbinaryTypeInfo.toJson(),
-          bitTypeInfo.toJson(),
-          tinyintTypeInfo.toJson(),
-          smallintTypeInfo.toJson(),
-          integerTypeInfo.toJson(),
-          bigintTypeInfo.toJson(),
-          realTypeInfo.toJson(),
-          doubleTypeInfo.toJson(),
-          guidTypeInfo.toJson(),
-          dateTypeInfo.toJson(),
-          timeTypeInfo.toJson(),
-          timestampTypeInfo.toJson(),
-          decimalTypeInfo.toJson(),
-      });
-      break;
-    }
-    case SQL_WVARCHAR: {
-      // TODO: Does WVARCHAR exist in Trino?
-      // Is WVARCHAR any different than varchar?
-      // I'm guessing Trino uses UTF-8, and not any wide varchars.
-      typeResponse["data"] = json::array({varcharTypeInfo.toJson()});
-      break;
-    }
-    case SQL_VARCHAR: {
-      typeResponse["data"] = json::array({varcharTypeInfo.toJson()});
-      break;
-    }
-    case SQL_VARBINARY: {
-      typeResponse["data"] = json::array({varbinaryTypeInfo.toJson()});
-      break;
-    }
-    case SQL_TIMESTAMP: {
-      typeResponse["data"] = json::array({timestampTypeInfo.toJson()});
-      break;
-    }
-    case SQL_TYPE_TIMESTAMP: {
-      typeResponse["data"] = json::array({timestampTypeInfo.toJson()});
-      break;
-    }
-    default: {
-      WriteLog(LL_ERROR,
-               "  ERROR: SQLGetTypeInfo returning failure for type id: " +
-                   std::to_string(DataType));
-      return SQL_ERROR;
-    }
+  const auto& resultSets = typeInfoResultSets();
+  auto found             = resultSets.find(DataType);
+  if (found == resultSets.end()) {
+    WriteLog(LL_ERROR,
+             "  ERROR: SQLGetTypeInfo returning failure for type id: " +
+                 std::to_string(DataType));
+    return SQL_ERROR;
   }
-  statement->trinoQuery->sideloadResponse(typeResponse);
+  statement->trinoQuery->sideloadResultSet(found->second);
   WriteLog(LL_TRACE,
            "  SQLGetTypeInfo returning success for type id: " +
                std::to_string(DataType));
@@ -1,5 +1,7 @@
 #include "connHandle.hpp"
 
+#include "../../util/traceEvents.hpp"
+
 Connection::Connection(EnvironmentConfig* environmentConfig) {
   this->environmentConfig = environmentConfig;
 }
@@ -31,6 +33,31 @@ void Connection::configure(DriverConfig config) {
   // The destructor will clean it up if that's happened.
   checkInputs(config);
 
+  // Tracing covers the whole process, so the first DSN to ask for it
+  // picks the file.
+  if (not config.getTraceFile().empty()) {
+    startTracing(config.getTraceFile());
+  }
+
+  ConnectionOptions options;
+  options.tlsSessionCache       = config.getTlsSessionCache();
+  options.connectTimeoutMs      = config.getConnectTimeoutMs();
+  options.requestTimeoutMs      = config.getRequestTimeoutMs();
+  options.retryBudgetMs         = config.getRetryBudgetMs();
+  options.endpoints             = config.getEndpoints();
+  options.maxConcurrentQueries  = config.getMaxConcurrentQueries();
+  options.maxEndpointQueries    = config.getMaxEndpointQueries();
+  options.admissionTimeoutMs    = config.getAdmissionTimeoutMs();
+  options.injectRowLimit        = config.getInjectRowLimit();
+  options.maxPreparedStatements = config.getMaxPreparedStatements();
+  options.maxBatchBytes         = config.getMaxBatchBytes();
+  options.metadataCacheTtlMs    = config.getMetadataCacheTtlMs();
+  options.resultSchemaCache     = config.getResultSchemaCache();
+  options.resultCacheTtlMs      = config.getResultCacheTtlMs();
+  options.resultCacheMaxBytes   = config.getResultCacheMaxBytes();
+  options.resultCacheDir        = config.getResultCacheDir();
+  options.oidcDiscoveryTtlS     = config.getOidcDiscoveryTtlS();
+
   this->connectionConfig = new ConnectionConfig(config.getHostname(),
                                                 config.getPortNum(),
                                                 config.getAuthMethodEnum(),
@@ -40,7 +67,8 @@ void Connection::configure(DriverConfig config) {
                                                 config.getClientSecret(),
                                                 config.getOidcScope(),
                                                 config.getGrantType(),
-                                                config.getTokenEndpoint());
+                                                config.getTokenEndpoint(),
+                                                options);
 }
 
 void Connection::setError(ErrorInfo errorInfo) {
@@ -1,9 +1,12 @@
 #include "statementHandle.hpp"
+#include <algorithm>
 #include <functional>
 #include <string>
 
 #include "../mappings/typeMappings.hpp"
 
+#include "../../util/bufferToLiteral.hpp"
+#include "../../util/insertBatch.hpp"
 #include "../../util/writeLog.hpp"
 
 void Statement::columnsChangedCallback(TrinoQuery* trinoQuery) {
@@ -67,10 +70,16 @@ void Statement::columnsChangedCallback(TrinoQuery* trinoQuery) {
     this->getRowDescriptor()->setField(i, field);
     i++;
   }
+  // Results described from the result schema cache may come back with
+  // fewer columns, and the records past the end describe nothing.
+  if (rowDescriptor->getColumnCount() > i) {
+    rowDescriptor->resize(i);
+  }
 }
 
 Statement::Statement(ConnectionConfig* connectionConfig) {
-  this->trinoQuery   = new TrinoQuery(connectionConfig);
+  this->connectionConfig = connectionConfig;
+  this->trinoQuery       = new TrinoQuery(connectionConfig);
   this->impParamDesc = new Descriptor();
   this->impRowDesc   = new Descriptor();
   // Application descriptors are managed by the application,
@@ -94,17 +103,182 @@ Statement::~Statement() {
 }
 
 /*
-Reset gets this statement ready to be used again.
+Reset gets this statement ready to be used again. A prepared statement
+stays prepared and its parameters stay bound, so it can be executed
+again right away.
 */
 void Statement::reset() {
   this->executed              = false;
   this->fetchExecuteConfirmed = false;
   this->fetchedPosition       = -1;
+  this->priorRowCount         = 0;
+  this->priorMetrics          = QueryMetrics();
   this->trinoQuery->reset();
-  this->impParamDesc->reset();
   this->impRowDesc->reset();
 }
 
+/*
+Unbind every parameter, as SQLFreeStmt with SQL_RESET_PARAMS asks.
+*/
+void Statement::resetParams() {
+  this->getParamDescriptor()->reset();
+}
+
+/*
+Render every bound parameter as a SQL literal, in order, for an EXECUTE.
+Parameters are numbered from 1, so record 0 of the descriptor is never
+used. With an array of parameters bound, paramSet picks which set of
+values to render. Returns false, with the error set on the statement, if
+a parameter is missing or can't be converted.
+*/
+bool Statement::getParameterLiterals(std::vector<std::string>& literals,
+                                     SQLULEN paramSet) {
+  Descriptor* paramDescriptor = this->getParamDescriptor();
+  SQLLEN offset               = 0;
+  if (paramDescriptor->Field_BindOffsetPtr) {
+    offset = *paramDescriptor->Field_BindOffsetPtr;
+  }
+  // Bound by row, every parameter's values are the size of the row
+  // structure apart. Bound by column, they're one value apart.
+  bool rowWise = paramDescriptor->Field_BindType != SQL_PARAM_BIND_BY_COLUMN;
+  literals.clear();
+  for (SQLSMALLINT i = 1; i < paramDescriptor->getColumnCount(); i++) {
+    const DescriptorField& field = paramDescriptor->getFieldRef(i);
+    if (field.bufferCDataType == SQL_UNKNOWN_TYPE) {
+      ErrorInfo errorInfo(
+          "Parameter " + std::to_string(i) + " is not bound", "07002");
+      this->setError(errorInfo);
+      return false;
+    }
+    SQLLEN valueSize       = cDataTypeSize(field.bufferCDataType);
+    SQLLEN bufferStride    = valueSize > 0 ? valueSize : field.bufferLength;
+    SQLLEN indicatorStride = sizeof(SQLLEN);
+    if (rowWise) {
+      bufferStride    = paramDescriptor->Field_BindType;
+      indicatorStride = paramDescriptor->Field_BindType;
+    }
+    char* buffer = nullptr;
+    if (field.bufferPtr) {
+      buffer = static_cast<char*>(field.bufferPtr) + offset +
+               paramSet * bufferStride;
+    }
+    SQLLEN* strLen_or_IndPtr = nullptr;
+    if (field.bufferStrLenOrIndPtr) {
+      strLen_or_IndPtr = reinterpret_cast<SQLLEN*>(
+          reinterpret_cast<char*>(field.bufferStrLenOrIndPtr) + offset +
+          paramSet * indicatorStride);
+    }
+    std::optional<std::string> literal =
+        bufferToLiteral(field.bufferCDataType,
+                        field.odbcDataType,
+                        buffer,
+                        field.bufferLength,
+                        strLen_or_IndPtr);
+    if (not literal) {
+      ErrorInfo errorInfo("Parameter " + std::to_string(i) +
+                              " has an unsupported C data type: " +
+                              std::to_string(field.bufferCDataType),
+                          "HYC00");
+      this->setError(errorInfo);
+      return false;
+    }
+    literals.push_back(*literal);
+  }
+  return true;
+}
+
+/*
+Execute the prepared statement once for every set of parameters in the
+bound arrays, as SQL_ATTR_PARAMSET_SIZE asks. An INSERT of one row of
+markers is rewritten into multi-row INSERTs of up to maxBatchBytes each,
+so a thousand sets take a handful of queries rather than a thousand. Any
+other statement is executed once per set, and the results of the last
+set are the ones left to fetch.
+
+Execution stops at the first query that fails. The sets it covered are
+marked SQL_PARAM_ERROR, and the sets after it SQL_PARAM_UNUSED.
+*/
+SQLRETURN Statement::executeParameterArray() {
+  SQLULEN paramsetSize = this->getParamDescriptor()->Field_ArraySize;
+  this->setParamStatus(0, paramsetSize, SQL_PARAM_UNUSED);
+  this->setParamsProcessed(0);
+
+  std::vector<std::vector<std::string>> literals(paramsetSize);
+  for (SQLULEN paramSet = 0; paramSet < paramsetSize; paramSet++) {
+    if (not this->getParameterLiterals(literals[paramSet], paramSet)) {
+      this->setParamStatus(paramSet, paramSet + 1, SQL_PARAM_ERROR);
+      this->setParamsProcessed(paramSet + 1);
+      return SQL_ERROR;
+    }
+  }
+
+  std::optional<InsertTemplate> insert =
+      parseInsertTemplate(this->trinoQuery->getPreparedSql());
+  bool batched = insert and insert->rowPieces.size() == literals[0].size() + 1;
+  std::vector<std::string> rows;
+  if (batched) {
+    rows.reserve(paramsetSize);
+    for (const std::vector<std::string>& paramLiterals : literals) {
+      rows.push_back(renderInsertRow(*insert, paramLiterals));
+    }
+  }
+  size_t maxBytes = static_cast<size_t>(
+      std::max(1L, this->connectionConfig->getOptions().maxBatchBytes));
+
+  // Each query runs to completion before the next one starts. The last
+  // EXECUTE is left for the application to fetch from, but an INSERT has
+  // nothing to fetch, and finishing it gives SQLRowCount its answer.
+  size_t first = 0;
+  while (first < paramsetSize) {
+    if (first > 0) {
+      this->priorRowCount +=
+          std::max<int64_t>(0, this->trinoQuery->getUpdateCount());
+      addQueryMetrics(this->priorMetrics, this->trinoQuery->getMetrics());
+      this->trinoQuery->reset();
+    }
+    size_t end = first + 1;
+    bool ok    = true;
+    if (batched) {
+      std::string sql = buildInsertBatch(*insert, rows, first, maxBytes, end);
+      WriteLog(LL_DEBUG,
+               "  Inserting parameter sets " + std::to_string(first) +
+                   " to " + std::to_string(end - 1));
+      this->trinoQuery->executeRewritten(sql);
+    } else {
+      ok = this->trinoQuery->executePrepared(literals[first]);
+    }
+    this->executed = true;
+    if (ok and (batched or end < paramsetSize)) {
+      this->trinoQuery->poll(ToCompletion);
+    }
+    ok = ok and not this->trinoQuery->hasError();
+    this->setParamStatus(first, end, ok ? SQL_PARAM_SUCCESS : SQL_PARAM_ERROR);
+    this->setParamsProcessed(end);
+    if (not ok) {
+      return first == 0 ? SQL_ERROR : SQL_SUCCESS_WITH_INFO;
+    }
+    first = end;
+  }
+  return SQL_SUCCESS;
+}
+
+void Statement::setParamStatus(SQLULEN first,
+                               SQLULEN end,
+                               SQLUSMALLINT status) {
+  SQLUSMALLINT* statusArray = this->getParamDescriptor()->Field_ArrayStatusPtr;
+  if (statusArray) {
+    for (SQLULEN i = first; i < end; i++) {
+      statusArray[i] = status;
+    }
+  }
+}
+
+void Statement::setParamsProcessed(SQLULEN count) {
+  if (this->getParamDescriptor()->Field_RowsProcessedPtr) {
+    *(this->getParamDescriptor()->Field_RowsProcessedPtr) = count;
+  }
+}
+
 /*
 Terminate stops an in-flight query immediately. It also
 gets called just before freeing the statement handle as
@@ -115,6 +289,22 @@ void Statement::terminate() {
   this->trinoQuery->terminate();
 }
 
+/*
+Like terminate, but the DELETE is sent by the query reaper so the caller
+doesn't wait on it. Used when the application is done with the results.
+*/
+void Statement::terminateInBackground() {
+  this->trinoQuery->terminateInBackground();
+}
+
+/*
+Cancel is safe to call from a different thread than the one using the
+statement. A fetch blocked on Trino returns SQLSTATE HY008 shortly after.
+*/
+void Statement::cancel() {
+  this->trinoQuery->requestCancel();
+}
+
 /*
 If the application provides their own descriptor,
 we will ignore the default one we are providing
@@ -4,11 +4,14 @@
 #include <sqlext.h>
 
 #include <functional>
+#include <string>
+#include <vector>
 
 #include "descriptorHandle.hpp"
 #include "handleErrorInfo.hpp"
 
 #include "../../trinoAPIWrapper/connectionConfig.hpp"
+#include "../../trinoAPIWrapper/queryMetrics.hpp"
 #include "../../trinoAPIWrapper/trinoQuery.hpp"
 
 class Statement {
@@ -24,6 +27,8 @@ class Statement {
     // Trino Query ID
     std::string queryId;
 
+    ConnectionConfig* connectionConfig;
+
   public:
     Statement(ConnectionConfig* connectionConfig);
     ~Statement();
@@ -35,6 +40,16 @@ class Statement {
     TrinoQuery* trinoQuery;
     // The method used in SQLFetch for polling trino.
     TrinoQueryPollMode fetchPollMode = UntilNewData;
+    // SQL_ATTR_QUERY_TIMEOUT in seconds. Zero means no timeout.
+    SQLULEN queryTimeout = 0;
+    // SQL_ATTR_MAX_ROWS. Zero means every row.
+    SQLULEN maxRows = 0;
+    // Rows changed by queries that already ran for earlier sets of an
+    // array of parameters. The current query's row count adds to it.
+    SQLLEN priorRowCount = 0;
+    // The metrics of those queries, which SQL_ATTR_QUERY_METRICS adds to
+    // the current query's.
+    QueryMetrics priorMetrics;
 
     // The ODBC protocol assumes these descriptors are
     // instantiated on all statements.
@@ -44,7 +59,15 @@ class Statement {
     Descriptor* impParamDesc;
 
     void reset();
+    void resetParams();
+    bool getParameterLiterals(std::vector<std::string>& literals,
+                              SQLULEN paramSet = 0);
+    SQLRETURN executeParameterArray();
+    void setParamStatus(SQLULEN first, SQLULEN end, SQLUSMALLINT status);
+    void setParamsProcessed(SQLULEN count);
     void terminate();
+    void terminateInBackground();
+    void cancel();
     Descriptor* getRowDescriptor();
     Descriptor* getParamDescriptor();
     SQLLEN getFetchedPosition();
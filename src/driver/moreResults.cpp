@@ -2,11 +2,13 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
 SQLRETURN SQL_API SQLMoreResults(SQLHSTMT StatementHandle) {
   WriteLog(LL_TRACE, "Entering SQLMoreResults");
+  TraceSpan span("SQLMoreResults");
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
 
   /*
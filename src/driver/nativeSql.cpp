@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLNativeSql(SQLHDBC hdbc,
@@ -11,6 +12,7 @@ SQLRETURN SQL_API SQLNativeSql(SQLHDBC hdbc,
                                SQLINTEGER cchSqlStrMax,
                                SQLINTEGER* pcbSqlStr) {
   WriteLog(LL_TRACE, "Entering SQLNativeSQL");
+  TraceSpan span("SQLNativeSQL");
   WriteLog(LL_ERROR, "  ERROR: SQLNativeSQL is unimplemented");
   return SQL_ERROR;
 }
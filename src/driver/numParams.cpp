@@ -2,10 +2,33 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
+#include "handles/statementHandle.hpp"
 
 SQLRETURN SQL_API SQLNumParams(SQLHSTMT hstmt, _Out_opt_ SQLSMALLINT* pcpar) {
+  /*
+  Count the parameter markers in a prepared statement. Trino works this
+  out with DESCRIBE INPUT, so the statement doesn't have to run.
+  */
   WriteLog(LL_TRACE, "Entering SQLNumParams");
-  WriteLog(LL_ERROR, " ERROR: SQLNumParams is unimplemented");
-  return SQL_ERROR;
+  TraceSpan span("SQLNumParams");
+  Statement* statement = reinterpret_cast<Statement*>(hstmt);
+  if (not statement->trinoQuery->isPrepared()) {
+    WriteLog(LL_ERROR, "  ERROR: SQLNumParams called before SQLPrepare");
+    ErrorInfo errorInfo("Function sequence error", "HY010");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  }
+  const std::vector<std::string>& parameterTypes =
+      statement->trinoQuery->getParameterTypes();
+  if (statement->trinoQuery->hasError()) {
+    return SQL_ERROR;
+  }
+  if (pcpar) {
+    *pcpar = static_cast<SQLSMALLINT>(parameterTypes.size());
+  }
+  WriteLog(LL_TRACE,
+           "  Parameter count is: " + std::to_string(parameterTypes.size()));
+  return SQL_SUCCESS;
 }
@@ -1,12 +1,14 @@
 #include "../util/windowsLean.hpp"
 #include <sql.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
 SQLRETURN SQL_API SQLNumResultCols(SQLHSTMT StatementHandle,
                                    _Out_ SQLSMALLINT* ColumnCount) {
   WriteLog(LL_TRACE, "Entering SQLNumResultCols");
+  TraceSpan span("SQLNumResultCols");
 
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
   WriteLog(LL_TRACE, "  Getting Column Count");
@@ -2,11 +2,13 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLParamData(SQLHSTMT StatementHandle,
                                _Out_opt_ SQLPOINTER* Value) {
   WriteLog(LL_TRACE, "Entering SQLParamData");
+  TraceSpan span("SQLParamData");
   WriteLog(LL_ERROR, "  ERROR: SQLParamData is unimplemented");
   return SQL_ERROR;
 }
@@ -2,12 +2,67 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../trinoAPIWrapper/trinoExceptions.hpp"
+#include "../trinoAPIWrapper/trinoQuery.hpp"
+#include "../util/stringFromChar.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
+#include "handles/statementHandle.hpp"
 
 SQLRETURN SQL_API SQLPrepare(SQLHSTMT StatementHandle,
                              _In_reads_(TextLength) SQLCHAR* StatementText,
                              SQLINTEGER TextLength) {
+  /*
+  Register the statement with Trino as a prepared statement, so
+  SQLExecute can run it with different parameters without sending the
+  full text each time. Statements with the same text share one
+  registration across the whole connection.
+  */
   WriteLog(LL_TRACE, "Entering SQLPrepare");
-  WriteLog(LL_ERROR, "  ERROR: SQLPrepare is unimplemented");
-  return SQL_ERROR;
+  TraceSpan span("SQLPrepare");
+
+  if (not StatementText) {
+    WriteLog(LL_ERROR, " ERROR: No StatementText defined for query");
+    return SQL_ERROR;
+  }
+
+  Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
+  statement->trinoQuery->clearCancel();
+
+  try {
+    std::string queryText = stringFromChar(StatementText, TextLength);
+    WriteLog(LL_DEBUG, "  Preparing: " + queryText);
+    // Preparing discards whatever the statement ran before.
+    if (statement->executed) {
+      statement->terminateInBackground();
+    }
+    statement->reset();
+    if (not statement->trinoQuery->prepare(queryText)) {
+      // Trino rejected the statement. The details are on the query for
+      // SQLGetDiagRec to report.
+      return SQL_ERROR;
+    }
+    statement->reset();
+    return SQL_SUCCESS;
+  } catch (const CancelledError& ex) {
+    WriteLog(LL_INFO, "  SQLPrepare was canceled");
+    ErrorInfo errorInfo(ex.what(), "HY008");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  } catch (const TimeoutError& ex) {
+    WriteLog(LL_ERROR,
+             "  ERROR: Timeout during SQLPrepare: " + std::string(ex.what()));
+    ErrorInfo errorInfo(ex.what(), "HYT00");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  } catch (const std::exception& ex) {
+    WriteLog(LL_ERROR,
+             "  ERROR: Exception thrown during SQLPrepare: " +
+                 std::string(ex.what()));
+    ErrorInfo errorInfo("Exception thrown during SQLPrepare: " +
+                            std::string(ex.what()),
+                        "HY000");
+    statement->setError(errorInfo);
+    return SQL_ERROR;
+  }
 }
@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLPutData(SQLHSTMT StatementHandle,
@@ -9,6 +10,7 @@ SQLRETURN SQL_API SQLPutData(SQLHSTMT StatementHandle,
                                  SQLPOINTER Data,
                              SQLLEN StrLen_or_Ind) {
   WriteLog(LL_TRACE, "Entering SQLPutData");
+  TraceSpan span("SQLPutData");
   WriteLog(LL_ERROR, "  ERROR: SQLPutData is unimplemented");
   return SQL_ERROR;
 }
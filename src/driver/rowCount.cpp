@@ -1,12 +1,14 @@
 #include "../util/windowsLean.hpp"
 #include <sql.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
 SQLRETURN SQL_API SQLRowCount(_In_ SQLHSTMT StatementHandle,
                               _Out_ SQLLEN* RowCount) {
   WriteLog(LL_TRACE, "Entering SQLRowCount");
+  TraceSpan span("SQLRowCount");
 
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
   // We can return -1 to indicate that we do not
@@ -16,6 +18,11 @@ SQLRETURN SQL_API SQLRowCount(_In_ SQLHSTMT StatementHandle,
   // getAbsoluteRowCount will return -1 if the query is not yet complete
   SQLLEN queryRowCount =
       static_cast<SQLLEN>(statement->trinoQuery->getAbsoluteRowCount());
+  // An array of parameters may have taken several queries, and each
+  // one's changes count.
+  if (queryRowCount >= 0) {
+    queryRowCount += statement->priorRowCount;
+  }
   *RowCount = queryRowCount;
 
   WriteLog(LL_TRACE, "  Row count is set to: " + std::to_string(*RowCount));
@@ -2,7 +2,10 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../trinoAPIWrapper/metadataCache.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
+#include "constants/connectionAttrs.hpp"
 #include "handles/connHandle.hpp"
 
 SQLRETURN SQL_API SQLSetConnectOption(SQLHDBC ConnectionHandle,
@@ -30,6 +33,8 @@ SQLRETURN SQL_API SQLSetConnectAttr(SQLHDBC ConnectionHandle,
   */
 
   WriteLog(LL_TRACE, "Entering SQLSetConnectAttr");
+  TraceSpan span("SQLSetConnectAttr");
+
   Connection* connection = reinterpret_cast<Connection*>(ConnectionHandle);
   WriteLog(LL_TRACE,
            "  Request to set attribute: " + std::to_string(Attribute));
@@ -56,6 +61,15 @@ SQLRETURN SQL_API SQLSetConnectAttr(SQLHDBC ConnectionHandle,
                "  Login timeout set to: " + std::to_string(loginTimeout));
       break;
     }
+    case SQL_ATTR_INVALIDATE_METADATA_CACHE: { // 1101
+      // Driver defined - forget metadata cached for this connection.
+      if (connection->connectionConfig) {
+        getMetadataCache().invalidate(
+            connection->connectionConfig->getIdentity());
+      }
+      WriteLog(LL_TRACE, "  Metadata cache invalidated");
+      break;
+    }
     default: {
       WriteLog(LL_ERROR, "  ERROR: Unsupported attribute in SetConnectAttr.");
       WriteLog(LL_ERROR, "  Attribute is " + std::to_string(Attribute));
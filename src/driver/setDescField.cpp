@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLSetDescField(SQLHDESC DescriptorHandle,
@@ -11,6 +12,7 @@ SQLRETURN SQL_API SQLSetDescField(SQLHDESC DescriptorHandle,
                                       SQLPOINTER Value,
                                   SQLINTEGER BufferLength) {
   WriteLog(LL_TRACE, "Entering SQLSetDescField");
+  TraceSpan span("SQLSetDescField");
   WriteLog(LL_ERROR, " ERROR: SQLSetDescField is unimplemented");
   return SQL_ERROR;
 }
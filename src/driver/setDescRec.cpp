@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLSetDescRec(SQLHDESC DescriptorHandle,
@@ -16,6 +17,7 @@ SQLRETURN SQL_API SQLSetDescRec(SQLHDESC DescriptorHandle,
                                 _Inout_opt_ SQLLEN* StringLength,
                                 _Inout_opt_ SQLLEN* Indicator) {
   WriteLog(LL_TRACE, "Entering SQLSetDescRec");
+  TraceSpan span("SQLSetDescRec");
   WriteLog(LL_ERROR, "  ERROR: SQLSetDescRec is unimplemented");
   return SQL_ERROR;
 }
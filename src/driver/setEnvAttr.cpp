@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/envHandle.hpp"
 
@@ -18,6 +19,8 @@ SQLRETURN SQL_API SQLSetEnvAttr(SQLHENV EnvironmentHandle,
   */
 
   WriteLog(LL_TRACE, "Entering SQLSetEnvAttr");
+  TraceSpan span("SQLSetEnvAttr");
+
   Environment* environment = reinterpret_cast<Environment*>(EnvironmentHandle);
 
   if (environment == nullptr) {
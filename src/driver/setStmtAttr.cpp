@@ -3,6 +3,7 @@
 #include <sqlext.h>
 
 #include "../trinoAPIWrapper/trinoQuery.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "constants/statementAttrs.hpp"
 #include "handles/statementHandle.hpp"
@@ -13,10 +14,65 @@ SQLRETURN SQL_API SQLSetStmtAttr(SQLHSTMT StatementHandle,
                                      SQLPOINTER Value,
                                  SQLINTEGER StringLength) {
   WriteLog(LL_TRACE, "Entering SQLSetStmtAttr");
+  TraceSpan span("SQLSetStmtAttr");
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
 
   WriteLog(LL_TRACE, "  Setting attribute: " + std::to_string(Attribute));
   switch (Attribute) {
+    case SQL_ATTR_QUERY_TIMEOUT: { // 0
+      SQLULEN seconds = reinterpret_cast<SQLULEN>(Value);
+      WriteLog(LL_TRACE,
+               "  Attribute value is set to " + std::to_string(seconds));
+      statement->queryTimeout = seconds;
+      statement->trinoQuery->setQueryTimeout(static_cast<long long>(seconds));
+      break;
+    }
+    case SQL_ATTR_MAX_ROWS: { // 1
+      SQLULEN maxRows = reinterpret_cast<SQLULEN>(Value);
+      WriteLog(LL_TRACE,
+               "  Attribute value is set to " + std::to_string(maxRows));
+      statement->maxRows = maxRows;
+      statement->trinoQuery->setMaxRows(static_cast<int64_t>(maxRows));
+      break;
+    }
+    case SQL_ATTR_PARAM_BIND_OFFSET_PTR: { // 17
+      WriteLog(LL_TRACE, std::format("  Attribute value is set to {}", Value));
+      statement->getParamDescriptor()->Field_BindOffsetPtr =
+          static_cast<SQLLEN*>(Value);
+      break;
+    }
+    case SQL_ATTR_PARAM_BIND_TYPE: { // 18
+      SQLULEN bindType = reinterpret_cast<SQLULEN>(Value);
+      WriteLog(LL_TRACE,
+               "  Attribute value is set to " + std::to_string(bindType));
+      statement->getParamDescriptor()->Field_BindType =
+          static_cast<SQLUINTEGER>(bindType);
+      break;
+    }
+    case SQL_ATTR_PARAM_STATUS_PTR: { // 20
+      WriteLog(LL_TRACE, std::format("  Attribute value is set to {}", Value));
+      statement->getParamDescriptor()->Field_ArrayStatusPtr =
+          static_cast<SQLUSMALLINT*>(Value);
+      break;
+    }
+    case SQL_ATTR_PARAMS_PROCESSED_PTR: { // 21
+      WriteLog(LL_TRACE, std::format("  Attribute value is set to {}", Value));
+      statement->getParamDescriptor()->Field_RowsProcessedPtr =
+          static_cast<SQLULEN*>(Value);
+      break;
+    }
+    case SQL_ATTR_PARAMSET_SIZE: { // 22
+      SQLULEN paramsetSize = reinterpret_cast<SQLULEN>(Value);
+      WriteLog(LL_TRACE,
+               "  Attribute value is set to " + std::to_string(paramsetSize));
+      if (paramsetSize == 0) {
+        ErrorInfo errorInfo("Invalid attribute value", "HY024");
+        statement->setError(errorInfo);
+        return SQL_ERROR;
+      }
+      statement->getParamDescriptor()->Field_ArraySize = paramsetSize;
+      break;
+    }
     case SQL_ATTR_ROWS_FETCHED_PTR: { // 26
       SQLULEN* rowsProcessedPtr = static_cast<SQLULEN*>(Value);
       WriteLog(LL_TRACE, std::format("  Attribute value is set to {}", Value));
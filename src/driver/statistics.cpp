@@ -2,6 +2,7 @@
 #include <sql.h>
 #include <sqlext.h>
 
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 SQLRETURN SQL_API SQLStatistics(SQLHSTMT StatementHandle,
@@ -15,6 +16,7 @@ SQLRETURN SQL_API SQLStatistics(SQLHSTMT StatementHandle,
                                 SQLUSMALLINT Unique,
                                 SQLUSMALLINT Reserved) {
   WriteLog(LL_TRACE, "Entering SQLStatistics");
+  TraceSpan span("SQLStatistics");
   WriteLog(LL_ERROR, "  ERROR: SQLStatistics is unimplemented");
   return SQL_ERROR;
 }
@@ -4,8 +4,11 @@
 
 #include <string>
 
+#include "../util/bufferToLiteral.hpp"
+#include "../util/searchPattern.hpp"
 #include "../util/stringFromChar.hpp"
 #include "../util/stringSplitAndTrim.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "handles/statementHandle.hpp"
 
@@ -39,6 +42,31 @@ std::string ALL_TABLE_TYPES_QUERY = R"SQL(
   FROM system.jdbc.table_types
 )SQL";
 
+std::string tableTypePredicate(std::string tableType) {
+  if (tableType.empty() or tableType == "%") {
+    return "table_type LIKE '%'";
+  }
+  // The app is requesting that we filter the types of tables returned.
+  // The list may be written 'TABLE','VIEW' or TABLE,VIEW.
+  std::vector<std::string> tableTypesVec = stringSplitAndTrim(tableType, ',');
+
+  std::string predicate = "table_type IN (";
+  for (std::vector<std::string>::size_type i = 0; i < tableTypesVec.size();
+       i++) {
+    std::string type = tableTypesVec[i];
+    if (type.size() >= 2 and type.front() == '\'' and type.back() == '\'') {
+      type = type.substr(1, type.size() - 2);
+    }
+    predicate += quoteSqlString(type);
+    // Insert a comma if it's not the last member of the list.
+    if (i < tableTypesVec.size() - 1) {
+      predicate += " ,";
+    }
+  }
+  predicate += ")";
+  return predicate;
+}
+
 std::string constructTableQuery(std::string catalog,
                                 std::string schema,
                                 std::string tableName,
@@ -56,40 +84,49 @@ std::string constructTableQuery(std::string catalog,
   )SQL");
   // Profiling shows that using `=` is faster than using `like'
   // so we should use `=` if it's possible to do so.
-  if (catalog.find('%') != std::string::npos) {
-    query += "AND table_cat LIKE '" + catalog + "'\n";
-  } else {
-    query += "AND table_cat = '" + catalog + "'\n";
-  }
-  if (schema.find('%') != std::string::npos) {
-    query += "AND table_schem LIKE '" + schema + "'\n";
-  } else {
-    query += "AND table_schem = '" + schema + "'\n";
-  }
-  if (tableName.find('%') != std::string::npos) {
-    query += "AND table_name LIKE '" + tableName + "'\n";
-  } else {
-    query += "AND table_name = '" + tableName + "'\n";
-  }
-  if (tableType.empty() or tableType == "%") {
-    query += "AND table_type LIKE '" + tableType + "'";
-  } else {
-    std::vector<std::string> tableTypesVec = stringSplitAndTrim(tableType, ',');
-    if (!tableTypesVec.empty()) {
-      // The app is requesting that we filter the types of tables returned
-      query += "AND table_type IN (";
-      for (std::vector<std::string>::size_type i = 0; i < tableTypesVec.size();
-           i++) {
-        // Insert the name of the table type enclosed in single quotes.
-        query += "'" + tableTypesVec[i] + "'";
-        // Insert a comma if it's not the last member of the list.
-        if (i < tableTypesVec.size() - 1) {
-          query += " ,";
-        }
-      }
-      query += ")";
-    }
-  }
+  query += "AND " + searchPatternPredicate("table_cat", catalog) + "\n";
+  query += "AND " + searchPatternPredicate("table_schem", schema) + "\n";
+  query += "AND " + searchPatternPredicate("table_name", tableName) + "\n";
+  query += "AND " + tableTypePredicate(tableType);
+
+  return query;
+}
+
+std::string constructInformationSchemaTableQuery(std::string catalog,
+                                                 std::string schema,
+                                                 std::string tableName,
+                                                 std::string tableType) {
+  /*
+  When the catalog is known, its own information_schema lists its tables
+  without visiting every other catalog the way system.jdbc.tables does.
+  information_schema calls tables 'BASE TABLE' where ODBC says 'TABLE',
+  and it has no table comments, so remarks are null.
+  */
+  std::string query = std::string(R"SQL(
+    SELECT
+        table_cat,
+        table_schem,
+        table_name,
+        table_type,
+        remarks
+    FROM (
+        SELECT
+            table_catalog AS table_cat,
+            table_schema AS table_schem,
+            table_name,
+            CASE table_type
+                WHEN 'BASE TABLE' THEN 'TABLE'
+                ELSE table_type
+            END AS table_type,
+            CAST(NULL AS VARCHAR) AS remarks
+        FROM
+  )SQL");
+  query += "    " + quoteSqlIdentifier(unescapeSearchPattern(catalog)) +
+           ".information_schema.tables\n";
+  query += "    WHERE " + searchPatternPredicate("table_schema", schema) + "\n";
+  query += "    AND " + searchPatternPredicate("table_name", tableName) + "\n";
+  query += ")\n";
+  query += "WHERE " + tableTypePredicate(tableType);
 
   return query;
 }
@@ -106,12 +143,14 @@ SQLRETURN SQL_API SQLTables(SQLHSTMT StatementHandle,
                             _In_reads_opt_(NameLength4) SQLCHAR* TableTypeChars,
                             SQLSMALLINT NameLength4) {
   WriteLog(LL_TRACE, "Entering SQLTables");
+  TraceSpan span("SQLTables");
   if (!StatementHandle) {
     WriteLog(LL_ERROR, "  ERROR: Invalid handle in SQLTables");
     return SQL_INVALID_HANDLE;
   }
 
   Statement* statement = reinterpret_cast<Statement*>(StatementHandle);
+  statement->trinoQuery->clearCancel();
 
   std::string catalogName = stringFromChar(CatalogNameChars, NameLength1);
   std::string schemaName  = stringFromChar(SchemaNameChars, NameLength2);
@@ -126,18 +165,21 @@ SQLRETURN SQL_API SQLTables(SQLHSTMT StatementHandle,
   // Special cases to enable enumeration of catalogs, schemas, and table types.
   if (catalogName == SQL_ALL_CATALOGS and schemaName.empty() and
       tableName.empty() and tableType.empty()) {
-    statement->trinoQuery->setQuery(ALL_CATALOGS_QUERY);
-    statement->trinoQuery->post();
+    if (not statement->trinoQuery->runMetadataQuery(ALL_CATALOGS_QUERY)) {
+      return SQL_ERROR;
+    }
     statement->executed = true;
   } else if (schemaName == SQL_ALL_SCHEMAS and catalogName.empty() and
              tableName.empty()) {
-    statement->trinoQuery->setQuery(ALL_SCHEMAS_QUERY);
-    statement->trinoQuery->post();
+    if (not statement->trinoQuery->runMetadataQuery(ALL_SCHEMAS_QUERY)) {
+      return SQL_ERROR;
+    }
     statement->executed = true;
   } else if (tableType == SQL_ALL_TABLE_TYPES and catalogName.empty() and
              schemaName.empty() and tableName.empty()) {
-    statement->trinoQuery->setQuery(ALL_TABLE_TYPES_QUERY);
-    statement->trinoQuery->post();
+    if (not statement->trinoQuery->runMetadataQuery(ALL_TABLE_TYPES_QUERY)) {
+      return SQL_ERROR;
+    }
     statement->executed = true;
   } else {
     /*
@@ -158,11 +200,18 @@ SQLRETURN SQL_API SQLTables(SQLHSTMT StatementHandle,
     if (tableType.empty()) {
       tableType = std::string("%");
     }
-    std::string query =
-        constructTableQuery(catalogName, schemaName, tableName, tableType);
+    std::string query;
+    if (isSearchPattern(catalogName)) {
+      query =
+          constructTableQuery(catalogName, schemaName, tableName, tableType);
+    } else {
+      query = constructInformationSchemaTableQuery(
+          catalogName, schemaName, tableName, tableType);
+    }
     WriteLog(LL_TRACE, "Final query is: " + query);
-    statement->trinoQuery->setQuery(query);
-    statement->trinoQuery->post();
+    if (not statement->trinoQuery->runMetadataQuery(query)) {
+      return SQL_ERROR;
+    }
     statement->executed = true;
   }
 
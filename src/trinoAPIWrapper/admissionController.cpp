@@ -0,0 +1,122 @@
+#include "admissionController.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+
+bool AdmissionController::acquire(std::string endpoint,
+                                  long maxQueries,
+                                  long maxEndpointQueries,
+                                  long timeoutMs,
+                                  std::function<bool()> stopWaiting,
+                                  std::thread::id holder) {
+  std::unique_lock<std::mutex> lock(this->mutex);
+  if (this->runningPerThread.count(holder)) {
+    this->take(endpoint, holder);
+    return true;
+  }
+  Waiter waiter;
+  waiter.ticket             = this->nextTicket++;
+  waiter.endpoint           = endpoint;
+  waiter.maxQueries         = maxQueries;
+  waiter.maxEndpointQueries = maxEndpointQueries;
+  this->waiters.push_back(waiter);
+
+  auto nextInLine = [&]() { return this->isNextInLine(waiter.ticket); };
+  auto doneWaiting = [&]() {
+    return nextInLine() or (stopWaiting and stopWaiting());
+  };
+  if (timeoutMs > 0) {
+    this->slotFreed.wait_for(
+        lock, std::chrono::milliseconds(timeoutMs), doneWaiting);
+  } else {
+    this->slotFreed.wait(lock, doneWaiting);
+  }
+  bool admitted = nextInLine();
+
+  this->waiters.erase(std::find_if(
+      this->waiters.begin(), this->waiters.end(), [&](const Waiter& w) {
+        return w.ticket == waiter.ticket;
+      }));
+  if (admitted) {
+    this->take(endpoint, holder);
+  }
+  // Leaving the line, either way, may let the next waiter through.
+  lock.unlock();
+  this->slotFreed.notify_all();
+  return admitted;
+}
+
+void AdmissionController::release(std::string endpoint,
+                                  std::thread::id holder) {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->running--;
+    if (--this->runningPerEndpoint[endpoint] <= 0) {
+      this->runningPerEndpoint.erase(endpoint);
+    }
+    if (--this->runningPerThread[holder] <= 0) {
+      this->runningPerThread.erase(holder);
+    }
+  }
+  this->slotFreed.notify_all();
+}
+
+void AdmissionController::wakeWaiters() {
+  // Taking the lock means a caller that just found stopWaiting false is
+  // already waiting, and so gets woken.
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->slotFreed.notify_all();
+}
+
+int AdmissionController::getRunningCount() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->running;
+}
+
+int AdmissionController::getWaitingCount() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return static_cast<int>(this->waiters.size());
+}
+
+void AdmissionController::take(const std::string& endpoint,
+                               std::thread::id holder) {
+  // Must be called with the mutex held.
+  this->running++;
+  this->runningPerEndpoint[endpoint]++;
+  this->runningPerThread[holder]++;
+}
+
+bool AdmissionController::hasRoom(const Waiter& waiter) {
+  if (waiter.maxQueries > 0 and this->running >= waiter.maxQueries) {
+    return false;
+  }
+  if (waiter.maxEndpointQueries > 0 and
+      this->runningPerEndpoint.count(waiter.endpoint) and
+      this->runningPerEndpoint.at(waiter.endpoint) >=
+          waiter.maxEndpointQueries) {
+    return false;
+  }
+  return true;
+}
+
+bool AdmissionController::isNextInLine(unsigned long long ticket) {
+  // Must be called with the mutex held. The first waiter in line that
+  // has room goes next, so earlier waiters only hold this one back if
+  // they could go themselves.
+  for (const Waiter& waiter : this->waiters) {
+    if (this->hasRoom(waiter)) {
+      return waiter.ticket == ticket;
+    }
+    if (waiter.ticket == ticket) {
+      return false;
+    }
+  }
+  return false;
+}
+
+
+AdmissionController& getAdmissionController() {
+  static AdmissionController admissionController;
+  return admissionController;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/*
+Limits how many queries this process has running on Trino at once.
+
+Without a limit, a burst of parallel statements all POST at the same
+moment and the coordinator queues every one of them, so they all slow
+down together. Holding the extra submissions on the client smooths the
+burst out instead.
+
+Every submitted query holds a slot from just before its POST until it
+completes, fails, or is terminated. Limits are given per request, since
+they come from each connection's options: maxQueries caps the running
+queries in the whole process, and maxEndpointQueries caps those on one
+endpoint. A limit of zero or less means no limit.
+
+Whenever a slot frees up, the earliest waiting query that fits within
+its own limits goes next. Since every query brings its own limits, an
+earlier query held back by them, whether its endpoint's or a lower
+process-wide one from its connection, is skipped by later queries that
+fit, and only keeps its place in line for the next slot.
+*/
+class AdmissionController {
+  public:
+    /*
+    Wait for a slot. Returns false if none was free within timeoutMs, or
+    once stopWaiting returns true, which it is asked again whenever
+    wakeWaiters is called. A timeout of zero or less waits for as long
+    as it takes.
+
+    The slot is held by the holder thread. A thread that already holds
+    one is admitted right away, even past the limits, because the slot
+    it would wait for may be its own, and it can't give that back while
+    it waits. A single threaded application that executes a statement
+    before it has read all of another one's results does exactly that.
+    */
+    bool acquire(std::string endpoint,
+                 long maxQueries,
+                 long maxEndpointQueries,
+                 long timeoutMs,
+                 std::function<bool()> stopWaiting = nullptr,
+                 std::thread::id holder = std::this_thread::get_id());
+    void release(std::string endpoint,
+                 std::thread::id holder = std::this_thread::get_id());
+    // Wake every waiting caller to check its stopWaiting, for example
+    // after a statement was canceled.
+    void wakeWaiters();
+
+    int getRunningCount();
+    int getWaitingCount();
+
+  private:
+    struct Waiter {
+        unsigned long long ticket;
+        std::string endpoint;
+        long maxQueries;
+        long maxEndpointQueries;
+    };
+
+    std::mutex mutex;
+    std::condition_variable slotFreed;
+    std::deque<Waiter> waiters;
+    unsigned long long nextTicket = 0;
+    int running                   = 0;
+    std::map<std::string, int> runningPerEndpoint;
+    std::map<std::thread::id, int> runningPerThread;
+
+    void take(const std::string& endpoint, std::thread::id holder);
+    bool hasRoom(const Waiter& waiter);
+    bool isNextInLine(unsigned long long ticket);
+};
+
+// The controller shared by every connection in the process.
+AdmissionController& getAdmissionController();
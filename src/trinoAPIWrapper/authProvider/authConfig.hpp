@@ -2,11 +2,15 @@
 
 #include <curl/curl.h>
 #include <map>
+#include <mutex>
 #include <string>
 
 class AuthConfig {
   public:
     // Any headers that must be included on all requests go here.
+    // Tokens may be refreshed on a background thread, so once the
+    // provider is constructed go through getHeaders and setHeader
+    // instead of touching this map directly.
     std::map<std::string, std::string> headers = {
         {"X-Trino-Source", "TrinoODBCDriver"},
     };
@@ -22,6 +26,29 @@ class AuthConfig {
       this->connectionName = connectionName;
     }
 
+    std::map<std::string, std::string> getHeaders() {
+      std::lock_guard<std::mutex> lock(this->headersMutex);
+      return this->headers;
+    }
+
+    void setHeader(std::string key, std::string value) {
+      std::lock_guard<std::mutex> lock(this->headersMutex);
+      this->headers[key] = value;
+      this->headersVersion++;
+    }
+
+    // Bumped on every setHeader so callers can cache anything they build
+    // from the headers and only rebuild it when they change.
+    unsigned long long getHeadersVersion() {
+      std::lock_guard<std::mutex> lock(this->headersMutex);
+      return this->headersVersion;
+    }
+
+    // Providers that can refresh their credentials without user interaction
+    // may do it ahead of time on a background thread. Connection configs
+    // call this once the provider is fully constructed.
+    virtual void startBackgroundRefresh() {}
+
     // The '=0' on the end makes these "pure virtual" methods,
     // transforming this into an abstract bass class.
     virtual bool const isExpired()                                       = 0;
@@ -31,4 +58,8 @@ class AuthConfig {
 
     // Virtual destructors are considered "best practice" for virtual classes.
     virtual ~AuthConfig() = default;
+
+  private:
+    std::mutex headersMutex;
+    unsigned long long headersVersion = 0;
 };
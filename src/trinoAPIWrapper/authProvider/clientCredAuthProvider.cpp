@@ -5,7 +5,9 @@
 #include "nlohmann/json.hpp"
 
 #include "../../util/writeLog.hpp"
+#include "../httpTimings.hpp"
 
+#include "oidcDiscoveryCache.hpp"
 #include "tokenCacheAuthProviderBase.hpp"
 #include "tokens/tokenCache.hpp"
 
@@ -34,19 +36,19 @@ struct ClientCredAuthParams {
     std::string* responseData                              = nullptr;
     std::map<std::string, std::string>* responseHeaderData = nullptr;
     std::map<std::string, std::string>* requestHeaders     = nullptr;
+    long long oidcDiscoveryTtlS                            = 0;
 };
 
 std::string refreshClientCredAuth(ClientCredAuthParams& params) {
   std::string tokenEndpoint;
 
   if (params.tokenEndpoint->empty()) {
-    // Obtain the OIDC Discovery data.
-    curl_easy_setopt(
-        params.curl, CURLOPT_URL, params.oidcDiscoveryUrl->c_str());
-    CURLcode res1 = curl_easy_perform(params.curl);
-    WriteLog(LL_DEBUG,
-             "  OIDC discovery CURLcode response was: " + std::to_string(res1));
-    json discoveryData = json::parse(*params.responseData);
+    // Obtain the OIDC Discovery data. This is usually cached.
+    json discoveryData = getOidcDiscoveryDocument(params.curl,
+                                                  *params.oidcDiscoveryUrl,
+                                                  params.responseData,
+                                                  params.responseHeaderData,
+                                                  params.oidcDiscoveryTtlS);
 
     // Obtain the token endpoint that provides tokens in exchange for
     // client credentials.
@@ -85,6 +87,11 @@ std::string refreshClientCredAuth(ClientCredAuthParams& params) {
       headers, "Content-Type: application/x-www-form-urlencoded");
   curl_easy_setopt(params.curl, CURLOPT_HTTPHEADER, headers);
   CURLcode res2 = curl_easy_perform(params.curl);
+  getHttpTimings().record(params.curl, HttpAuth);
+  // The handle may be used again, so it must not keep pointing at the
+  // list once it is freed.
+  curl_easy_setopt(params.curl, CURLOPT_HTTPHEADER, nullptr);
+  curl_slist_free_all(headers);
   WriteLog(LL_DEBUG,
            "  Token endpoint HTTP response code was: " + std::to_string(res2));
 
@@ -108,6 +115,7 @@ class ClientCredAuthConfig : public TokenCacheAuthProviderBase {
     std::string scope;
     std::string grantType;
     std::string tokenEndpoint;
+    long long oidcDiscoveryTtlS;
 
   public:
     ClientCredAuthConfig(std::string hostname,
@@ -118,15 +126,17 @@ class ClientCredAuthConfig : public TokenCacheAuthProviderBase {
                          std::string clientSecret,
                          std::string scope,
                          std::string grantType,
-                         std::string tokenEndpoint)
+                         std::string tokenEndpoint,
+                         long long oidcDiscoveryTtlS)
         : TokenCacheAuthProviderBase(hostname, port, connectionName) {
       // The other parameters are used by base classes.
-      this->oidcDiscoveryUrl = oidcDiscoveryUrl;
-      this->clientId         = clientId;
-      this->clientSecret     = clientSecret;
-      this->scope            = scope;
-      this->grantType        = grantType;
-      this->tokenEndpoint    = tokenEndpoint;
+      this->oidcDiscoveryUrl  = oidcDiscoveryUrl;
+      this->clientId          = clientId;
+      this->clientSecret      = clientSecret;
+      this->scope             = scope;
+      this->grantType         = grantType;
+      this->tokenEndpoint     = tokenEndpoint;
+      this->oidcDiscoveryTtlS = oidcDiscoveryTtlS;
     }
 
 
@@ -147,11 +157,21 @@ class ClientCredAuthConfig : public TokenCacheAuthProviderBase {
       params.scope              = &this->scope;
       params.grantType          = &this->grantType;
       params.tokenEndpoint      = &this->tokenEndpoint;
+      params.oidcDiscoveryTtlS  = this->oidcDiscoveryTtlS;
 
       return refreshClientCredAuth(params);
     }
 
-    virtual ~ClientCredAuthConfig() = default;
+    // Client credentials don't need the user, so they can be renewed
+    // in the background before the token expires.
+    bool supportsBackgroundRefresh() override {
+      return true;
+    }
+
+    virtual ~ClientCredAuthConfig() {
+      // The refresh thread uses our members, stop it before they go away.
+      this->stopBackgroundRefresh();
+    }
 };
 
 std::unique_ptr<AuthConfig>
@@ -163,7 +183,8 @@ getClientCredAuthProvider(std::string hostname,
                           std::string clientSecret,
                           std::string oidcScope,
                           std::string grantType,
-                          std::string tokenEndpoint) {
+                          std::string tokenEndpoint,
+                          long long oidcDiscoveryTtlS) {
   if (connectionName.empty() && grantType.empty() && tokenEndpoint.empty()) {
     // If there is no connection name, that means this is a connection
     // defined entirely by the connection string. In that case we can
@@ -179,7 +200,8 @@ getClientCredAuthProvider(std::string hostname,
                                                   clientSecret,
                                                   oidcScope,
                                                   grantType,
-                                                  tokenEndpoint);
+                                                  tokenEndpoint,
+                                                  oidcDiscoveryTtlS);
   } else {
     return std::make_unique<ClientCredAuthConfig>(hostname,
                                                   port,
@@ -189,6 +211,7 @@ getClientCredAuthProvider(std::string hostname,
                                                   clientSecret,
                                                   oidcScope,
                                                   grantType,
-                                                  tokenEndpoint);
+                                                  tokenEndpoint,
+                                                  oidcDiscoveryTtlS);
   }
 }
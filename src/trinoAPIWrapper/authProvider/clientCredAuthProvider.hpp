@@ -14,4 +14,5 @@ getClientCredAuthProvider(std::string hostname,
                           std::string clientSecret,
                           std::string oidcScope,
                           std::string grantType,
-                          std::string tokenEndpoint);
+                          std::string tokenEndpoint,
+                          long long oidcDiscoveryTtlS);
@@ -6,7 +6,9 @@
 #include "nlohmann/json.hpp"
 
 #include "../../util/writeLog.hpp"
+#include "../httpTimings.hpp"
 
+#include "oidcDiscoveryCache.hpp"
 #include "tokenCacheAuthProviderBase.hpp"
 #include "tokens/tokenCache.hpp"
 
@@ -34,15 +36,16 @@ struct ClientCredAuthParams {
     std::string* responseData                              = nullptr;
     std::map<std::string, std::string>* responseHeaderData = nullptr;
     std::map<std::string, std::string>* requestHeaders     = nullptr;
+    long long oidcDiscoveryTtlS                            = 0;
 };
 
 std::string refreshDeviceCredAuth(ClientCredAuthParams& params) {
-  // Obtain the OIDC Discovery data.
-  curl_easy_setopt(params.curl, CURLOPT_URL, params.oidcDiscoveryUrl->c_str());
-  CURLcode res1 = curl_easy_perform(params.curl);
-  WriteLog(LL_DEBUG,
-           "  OIDC discovery CURLcode response was: " + std::to_string(res1));
-  json discoveryData = json::parse(*params.responseData);
+  // Obtain the OIDC Discovery data. This is usually cached.
+  json discoveryData = getOidcDiscoveryDocument(params.curl,
+                                                *params.oidcDiscoveryUrl,
+                                                params.responseData,
+                                                params.responseHeaderData,
+                                                params.oidcDiscoveryTtlS);
 
   WriteLog(LL_DEBUG,
            "Full discovery response: " +
@@ -77,6 +80,10 @@ std::string refreshDeviceCredAuth(ClientCredAuthParams& params) {
       headers, "Content-Type: application/x-www-form-urlencoded");
   curl_easy_setopt(params.curl, CURLOPT_HTTPHEADER, headers);
   CURLcode res2 = curl_easy_perform(params.curl);
+  getHttpTimings().record(params.curl, HttpAuth);
+  // The token polls below reuse the handle, so it must not keep pointing
+  // at the list once it is freed.
+  curl_easy_setopt(params.curl, CURLOPT_HTTPHEADER, nullptr);
   curl_slist_free_all(
       headers); // Always free curl headers to avoid memory leaks
   WriteLog(LL_DEBUG,
@@ -138,6 +145,7 @@ std::string refreshDeviceCredAuth(ClientCredAuthParams& params) {
       curl_easy_setopt(params.curl, CURLOPT_URL, tokenEndpoint.c_str());
       curl_easy_setopt(params.curl, CURLOPT_POSTFIELDS, tokenPost.c_str());
       CURLcode res = curl_easy_perform(params.curl);
+      getHttpTimings().record(params.curl, HttpAuth);
       WriteLog(LL_DEBUG,
                "  Polling token endpoint HTTP response code: " +
                    std::to_string(res));
@@ -185,6 +193,7 @@ class DeviceCredAuthConfig : public TokenCacheAuthProviderBase {
     std::string scope;
     std::string grantType;
     std::string tokenEndpoint;
+    long long oidcDiscoveryTtlS;
 
   public:
     DeviceCredAuthConfig(std::string hostname,
@@ -195,15 +204,17 @@ class DeviceCredAuthConfig : public TokenCacheAuthProviderBase {
                          std::string clientSecret,
                          std::string scope,
                          std::string grantType,
-                         std::string tokenEndpoint)
+                         std::string tokenEndpoint,
+                         long long oidcDiscoveryTtlS)
         : TokenCacheAuthProviderBase(hostname, port, connectionName) {
       // The other parameters are used by base classes.
-      this->oidcDiscoveryUrl = oidcDiscoveryUrl;
-      this->clientId         = clientId;
-      this->clientSecret     = clientSecret;
-      this->scope            = scope;
-      this->grantType        = grantType;
-      this->tokenEndpoint    = tokenEndpoint;
+      this->oidcDiscoveryUrl  = oidcDiscoveryUrl;
+      this->clientId          = clientId;
+      this->clientSecret      = clientSecret;
+      this->scope             = scope;
+      this->grantType         = grantType;
+      this->tokenEndpoint     = tokenEndpoint;
+      this->oidcDiscoveryTtlS = oidcDiscoveryTtlS;
     }
 
 
@@ -224,6 +235,7 @@ class DeviceCredAuthConfig : public TokenCacheAuthProviderBase {
       params.scope              = &this->scope;
       params.grantType          = &this->grantType;
       params.tokenEndpoint      = &this->tokenEndpoint;
+      params.oidcDiscoveryTtlS  = this->oidcDiscoveryTtlS;
 
       return refreshDeviceCredAuth(params);
     }
@@ -238,7 +250,8 @@ getDeviceFlowAuthProvider(std::string hostname,
                           std::string oidcDiscoveryUrl,
                           std::string clientId,
                           std::string clientSecret,
-                          std::string oidcScope) {
+                          std::string oidcScope,
+                          long long oidcDiscoveryTtlS) {
   // If there is no connection name, that means this is a connection
   // defined entirely by the connection string. In that case we can
   // substitute the clientId and scope together as the name. This is
@@ -253,5 +266,6 @@ getDeviceFlowAuthProvider(std::string hostname,
                                                 clientSecret,
                                                 oidcScope,
                                                 "",
-                                                "");
+                                                "",
+                                                oidcDiscoveryTtlS);
 }
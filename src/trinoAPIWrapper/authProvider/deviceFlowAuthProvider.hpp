@@ -12,4 +12,5 @@ getDeviceFlowAuthProvider(std::string hostname,
                           std::string oidcDiscoveryUrl,
                           std::string clientId,
                           std::string clientSecret,
-                          std::string oidcScope);
+                          std::string oidcScope,
+                          long long oidcDiscoveryTtlS);
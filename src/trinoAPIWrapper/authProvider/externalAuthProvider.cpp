@@ -7,6 +7,7 @@
 #include "../../util/browserInteraction.hpp"
 #include "../../util/delimKvpHelper.hpp"
 #include "../../util/writeLog.hpp"
+#include "../httpTimings.hpp"
 
 #include "tokenCacheAuthProviderBase.hpp"
 #include "tokens/tokenCache.hpp"
@@ -51,9 +52,7 @@ std::string refreshExternalAuth(ExternalAuthParams& params) {
   // custom headers from the request.
   // In theory this could be modified to only remove the
   // "Authorization" header, but that's significantly more work.
-  struct curl_slist* headers = nullptr;
-  curl_easy_setopt(params.curl, CURLOPT_HTTPHEADER, headers);
-  curl_slist_free_all(headers);
+  curl_easy_setopt(params.curl, CURLOPT_HTTPHEADER, nullptr);
 
   // Clear out the buffers for curl callbacks so we
   // don't end up with data from the prior CURL request
@@ -65,6 +64,7 @@ std::string refreshExternalAuth(ExternalAuthParams& params) {
 
   // Now hit the Trino API, which will return a 401.
   CURLcode res = curl_easy_perform(params.curl);
+  getHttpTimings().record(params.curl, HttpAuth);
 
   // Get the HTTP status code so we can log it in case of an error.
   long http_code = 0;
@@ -133,6 +133,7 @@ std::string refreshExternalAuth(ExternalAuthParams& params) {
 
     // Hit the token server
     CURLcode res = curl_easy_perform(params.curl);
+    getHttpTimings().record(params.curl, HttpAuth);
 
     // Parse the response as JSON, it will contain a "token" key
     // that is the access token.
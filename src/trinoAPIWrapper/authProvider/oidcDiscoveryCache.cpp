@@ -0,0 +1,116 @@
+#include "oidcDiscoveryCache.hpp"
+
+#include <charconv>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#include "../../util/delimKvpHelper.hpp"
+#include "../../util/timeUtils.hpp"
+#include "../../util/writeLog.hpp"
+#include "../httpTimings.hpp"
+
+
+struct CachedDiscoveryDocument {
+    json document;
+    long long expiresAt = 0;
+};
+
+static std::mutex discoveryCacheMutex;
+static std::map<std::string, CachedDiscoveryDocument> discoveryCache;
+
+
+long long
+getCacheLifetimeSeconds(const std::map<std::string, std::string>& headers,
+                        long long defaultTtlS) {
+  // Header names are stored as received, and HTTP/2 sends them lowercase,
+  // so look for Cache-Control without caring about case.
+  std::string cacheControl;
+  for (const auto& pair : headers) {
+    if (toLowercase(pair.first) == "cache-control") {
+      cacheControl = toLowercase(pair.second);
+      break;
+    }
+  }
+  if (cacheControl.empty()) {
+    return defaultTtlS;
+  }
+  if (cacheControl.find("no-store") != std::string::npos or
+      cacheControl.find("no-cache") != std::string::npos) {
+    return 0;
+  }
+  size_t maxAgePos = cacheControl.find("max-age=");
+  if (maxAgePos != std::string::npos) {
+    // The value runs to the next directive, and anything but digits there
+    // is malformed.
+    size_t stop = cacheControl.find_first_of(", ", maxAgePos);
+    if (stop == std::string::npos) {
+      stop = cacheControl.size();
+    }
+    const char* first = cacheControl.data() + maxAgePos + 8;
+    const char* last  = cacheControl.data() + stop;
+    long long maxAge  = 0;
+    auto [ptr, ec]    = std::from_chars(first, last, maxAge);
+    if (ec == std::errc() and ptr == last and first != last) {
+      return maxAge;
+    }
+  }
+  return defaultTtlS;
+}
+
+
+json getOidcDiscoveryDocument(
+    CURL* curl,
+    std::string discoveryUrl,
+    std::string* responseData,
+    std::map<std::string, std::string>* responseHeaderData,
+    long long defaultTtlS) {
+  {
+    std::lock_guard<std::mutex> lock(discoveryCacheMutex);
+    auto it = discoveryCache.find(discoveryUrl);
+    if (it != discoveryCache.end() and
+        it->second.expiresAt > getSecondsSinceEpoch()) {
+      WriteLog(LL_TRACE, "  Using cached OIDC discovery document");
+      return it->second.document;
+    }
+  }
+
+  // Fetch without holding the lock, other identity providers shouldn't
+  // wait on this one.
+  responseData->clear();
+  responseHeaderData->clear();
+  curl_easy_setopt(curl, CURLOPT_URL, discoveryUrl.c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPGET, true);
+  CURLcode res = curl_easy_perform(curl);
+  getHttpTimings().record(curl, HttpAuth);
+  WriteLog(LL_DEBUG,
+           "  OIDC discovery CURLcode response was: " + std::to_string(res));
+  if (res != CURLE_OK) {
+    throw std::runtime_error("Failed to fetch OIDC discovery document: " +
+                             std::string(curl_easy_strerror(res)));
+  }
+  long statusCode = 0;
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
+  json document;
+  try {
+    document = json::parse(*responseData);
+  } catch (const json::parse_error& e) {
+    throw std::runtime_error("Failed to parse OIDC discovery document from " +
+                             discoveryUrl + ": " + e.what());
+  }
+  if (statusCode != 200) {
+    // Don't cache error responses, the next refresh should try again.
+    return document;
+  }
+
+  long long lifetime =
+      getCacheLifetimeSeconds(*responseHeaderData, defaultTtlS);
+  if (lifetime > 0) {
+    std::lock_guard<std::mutex> lock(discoveryCacheMutex);
+    CachedDiscoveryDocument cached;
+    cached.document              = document;
+    cached.expiresAt             = getSecondsSinceEpoch() + lifetime;
+    discoveryCache[discoveryUrl] = cached;
+  }
+  return document;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+/*
+Return the OIDC discovery document published at discoveryUrl.
+
+Documents are cached in-process per URL, so token refreshes don't pay an
+extra round trip to the identity provider every time. A document is kept
+for as long as the Cache-Control max-age the identity provider sent, or
+for defaultTtlS, the connection's oidcDiscoveryTtlS, if it sent none.
+Responses marked no-store or no-cache are not cached.
+
+On a cache miss the document is fetched with curl, which must be set up
+to collect the response into responseData and responseHeaderData.
+Throws std::runtime_error if the document can't be fetched or parsed.
+*/
+json getOidcDiscoveryDocument(
+    CURL* curl,
+    std::string discoveryUrl,
+    std::string* responseData,
+    std::map<std::string, std::string>* responseHeaderData,
+    long long defaultTtlS);
+
+/*
+How many seconds a discovery response with these headers may be cached,
+going by its Cache-Control header. Zero means it must not be cached.
+Header names are matched in any case, and a missing or malformed max-age
+gives defaultTtlS.
+*/
+long long
+getCacheLifetimeSeconds(const std::map<std::string, std::string>& headers,
+                        long long defaultTtlS);
@@ -1,25 +1,44 @@
 #include "tokenCacheAuthProviderBase.hpp"
 
+#include <chrono>
+
+#include "../../util/writeLog.hpp"
+#include "../curlHelpers.hpp"
+#include "tokens/tokenRegistry.hpp"
+
+// Background refresh starts this long before the token would otherwise be
+// considered expired on the request path.
+long long BACKGROUND_REFRESH_LEAD_S = 60 * 2;
+// Never refresh in the background more often than this, so failures don't
+// spin. It is also how often a token without an "exp" claim is checked
+// for having been replaced by one with an expiry.
+long long BACKGROUND_REFRESH_MIN_INTERVAL_S = 30;
+
 TokenCacheAuthProviderBase::TokenCacheAuthProviderBase(
     std::string hostname, unsigned short port, std::string connectionName)
     : AuthConfig(hostname, port, connectionName) {
   this->tokenId = getTokenIdentity(hostname, port, connectionName);
+  // Connections that share an identity share a token, so this only touches
+  // the disk for the first connection with this identity in the process.
   this->tokenCache =
-      std::optional<TokenCacheEntry>(readTokenCache(this->tokenId));
+      std::optional<TokenCacheEntry>(getSharedToken(this->tokenId));
   if (not this->tokenCache->isExpired()) {
     this->applyToken();
   }
 }
 
+TokenCacheAuthProviderBase::~TokenCacheAuthProviderBase() {
+  this->stopBackgroundRefresh();
+}
+
 bool const TokenCacheAuthProviderBase::isExpired() {
+  std::lock_guard<std::mutex> lock(this->tokenMutex);
   return this->tokenCache->isExpired();
 }
 
 void TokenCacheAuthProviderBase::applyToken() {
   std::string accessToken = this->tokenCache->getAccessToken();
-  std::string authKey     = "Authorization";
-  std::string authValue   = "Bearer " + accessToken;
-  this->headers.insert({authKey, authValue});
+  this->setAccessTokenHeader(accessToken);
 }
 
 void TokenCacheAuthProviderBase::refresh(
@@ -29,15 +48,17 @@ void TokenCacheAuthProviderBase::refresh(
   applyTokenIfNotExpired();
 
   // Actually obtain the access token. This function is pure virtual,
-  // so subclasses must implement it.
-  std::string accessToken =
-      this->obtainAccessToken(curl, responseData, responseHeaderData);
-
-  // Cache the token
-  this->cacheToken(accessToken);
+  // so subclasses must implement it. The shared registry makes sure only
+  // one connection per identity does this at a time, and hands the
+  // result to any others that are waiting on it.
+  TokenCacheEntry refreshed = refreshSharedToken(this->tokenId, [&]() {
+    return this->obtainAccessToken(curl, responseData, responseHeaderData);
+  });
 
+  std::lock_guard<std::mutex> lock(this->tokenMutex);
+  this->tokenCache = refreshed;
   // Set the header for all requests
-  this->setAccessTokenHeader(accessToken);
+  this->setAccessTokenHeader(this->tokenCache->getAccessToken());
 }
 
 void TokenCacheAuthProviderBase::applyTokenIfNotExpired() {
@@ -45,20 +66,113 @@ void TokenCacheAuthProviderBase::applyTokenIfNotExpired() {
   // the token cache to see if we just need to apply it. Not having
   // a token in the request headers yet is an example of an "Expired
   // Token" that requires a "refresh" too.
+  std::lock_guard<std::mutex> lock(this->tokenMutex);
   if (not this->tokenCache->isExpired()) {
     this->applyToken();
   }
 }
 
-void TokenCacheAuthProviderBase::cacheToken(std::string accessToken) {
-  // Cache the auth token for later
-  this->tokenCache->setAccessToken(accessToken);
-  writeTokenCache(this->tokenCache.value());
+void TokenCacheAuthProviderBase::setAccessTokenHeader(std::string accessToken) {
+  // Set the access token into the headers. This replaces any stale token
+  // in one step, so requests see either the old header or the new one.
+  this->setHeader("Authorization", "Bearer " + accessToken);
 }
 
-void TokenCacheAuthProviderBase::setAccessTokenHeader(std::string accessToken) {
-  // Set the access token into the headers
-  std::string authKey   = "Authorization";
-  std::string authValue = "Bearer " + accessToken;
-  this->headers.insert({authKey, authValue});
+bool TokenCacheAuthProviderBase::supportsBackgroundRefresh() {
+  return false;
+}
+
+void TokenCacheAuthProviderBase::startBackgroundRefresh() {
+  if (not this->supportsBackgroundRefresh() or
+      this->backgroundRefreshThread.joinable()) {
+    return;
+  }
+  WriteLog(LL_DEBUG, "  Starting background token refresh for " + tokenId);
+  this->backgroundRefreshThread =
+      std::thread(&TokenCacheAuthProviderBase::backgroundRefreshLoop, this);
+}
+
+void TokenCacheAuthProviderBase::stopBackgroundRefresh() {
+  {
+    std::lock_guard<std::mutex> lock(this->backgroundMutex);
+    this->backgroundStopping = true;
+  }
+  this->backgroundWake.notify_all();
+  if (this->backgroundRefreshThread.joinable()) {
+    this->backgroundRefreshThread.join();
+  }
+}
+
+void TokenCacheAuthProviderBase::backgroundRefreshLoop() {
+  // The background thread gets its own CURL handle. The connection's handle
+  // belongs to whichever thread is running a query.
+  CURL* curl = nullptr;
+  std::string responseData;
+  std::map<std::string, std::string> responseHeaderData;
+
+  std::unique_lock<std::mutex> lock(this->backgroundMutex);
+  while (not this->backgroundStopping) {
+    bool hasExpiry;
+    long long secondsUntilRefresh;
+    {
+      std::lock_guard<std::mutex> tokenLock(this->tokenMutex);
+      hasExpiry           = this->tokenCache->hasExpiry();
+      secondsUntilRefresh = this->tokenCache->getSecondsUntilExpired() -
+                            BACKGROUND_REFRESH_LEAD_S;
+    }
+    if (not hasExpiry) {
+      // Nothing says when such a token runs out, so refreshing it ahead
+      // of time would only call the identity provider over and over. The
+      // request path, where it always counts as expired, refreshes it.
+      secondsUntilRefresh = BACKGROUND_REFRESH_MIN_INTERVAL_S;
+    }
+    if (secondsUntilRefresh > 0) {
+      this->backgroundWake.wait_for(
+          lock, std::chrono::seconds(secondsUntilRefresh), [this]() {
+            return this->backgroundStopping;
+          });
+      continue;
+    }
+
+    lock.unlock();
+    try {
+      if (curl == nullptr) {
+        curl = curl_easy_init();
+        setCurlDefaults(curl, &responseData, &responseHeaderData);
+      }
+      responseData.clear();
+      responseHeaderData.clear();
+      curl_easy_setopt(curl, CURLOPT_HTTPGET, true);
+
+      TokenCacheEntry refreshed = refreshSharedToken(
+          this->tokenId,
+          [&]() {
+            return this->obtainAccessToken(
+                curl, &responseData, &responseHeaderData);
+          },
+          BACKGROUND_REFRESH_LEAD_S);
+
+      std::lock_guard<std::mutex> tokenLock(this->tokenMutex);
+      this->tokenCache = refreshed;
+      this->setAccessTokenHeader(this->tokenCache->getAccessToken());
+      WriteLog(LL_DEBUG, "  Background token refresh done for " + tokenId);
+    } catch (const std::exception& e) {
+      // The request path will still refresh synchronously if the token
+      // actually expires, so this is not fatal.
+      WriteLog(LL_WARN,
+               "  WARNING: background token refresh failed: " +
+                   std::string(e.what()));
+    }
+    lock.lock();
+
+    this->backgroundWake.wait_for(
+        lock,
+        std::chrono::seconds(BACKGROUND_REFRESH_MIN_INTERVAL_S),
+        [this]() { return this->backgroundStopping; });
+  }
+  lock.unlock();
+
+  if (curl) {
+    curl_easy_cleanup(curl);
+  }
 }
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <condition_variable>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 
 #include "curl/curl.h"
 
@@ -21,17 +25,33 @@ class TokenCacheAuthProviderBase : public AuthConfig {
     refresh(CURL* curl,
             std::string* responseData,
             std::map<std::string, std::string>* responseHeaderData) override;
-    virtual ~TokenCacheAuthProviderBase() = default;
+    void startBackgroundRefresh() override;
+    virtual ~TokenCacheAuthProviderBase();
 
   protected:
     std::string tokenId;
     std::optional<TokenCacheEntry> tokenCache;
+    // Guards tokenCache, which the background refresh thread updates.
+    std::mutex tokenMutex;
     // This is pure virtual, it requires an implementation in the subclass.
     virtual std::string obtainAccessToken(
         CURL* curl,
         std::string* responseData,
         std::map<std::string, std::string>* responseHeaderData) = 0;
+    // Subclasses that can obtain a token without any user interaction
+    // override this to return true. Those get refreshed in the background
+    // ahead of expiry so requests never wait on the identity provider.
+    virtual bool supportsBackgroundRefresh();
+    // Subclasses that support background refresh must call this from their
+    // destructor, before their own members are torn down.
+    void stopBackgroundRefresh();
     void applyTokenIfNotExpired();
-    void cacheToken(std::string accessToken);
     void setAccessTokenHeader(std::string accessToken);
+
+  private:
+    std::thread backgroundRefreshThread;
+    std::mutex backgroundMutex;
+    std::condition_variable backgroundWake;
+    bool backgroundStopping = false;
+    void backgroundRefreshLoop();
 };
@@ -1,15 +1,15 @@
 #include "tokenCache.hpp"
 
-#include "../../../util/windowsLean.hpp"
-
 #include <filesystem>
 #include <fstream>
 #include <nlohmann/json.hpp>
-#include <shlobj.h> // For getting windows folder paths.
 #include <string>
+#include <vector>
 
 #include "../../../util/b64decoder.hpp"
 #include "../../../util/cryptUtils.hpp"
+#include "../../../util/fileLock.hpp"
+#include "../../../util/localAppDataPath.hpp"
 #include "../../../util/stringSplitAndTrim.hpp"
 #include "../../../util/timeUtils.hpp"
 #include "../../../util/writeLog.hpp"
@@ -21,6 +21,13 @@ using json = nlohmann::json;
 
 int TOKEN_CACHE_JSON_INDENT     = 2;
 long long EXPIRY_GRACE_PERIOD_S = 60 * 10;
+// How long to wait on another process holding the token cache lock before
+// giving up and working without it. Holders only keep it long enough to
+// read and rewrite the file.
+unsigned long TOKEN_CACHE_LOCK_TIMEOUT_MS = 5000;
+// How long a claim to refresh a token holds off other processes. If the
+// claiming process dies mid-refresh, others take over after this.
+long long TOKEN_REFRESH_CLAIM_S = 60;
 
 
 TokenCacheEntry::TokenCacheEntry(std::string accessToken,
@@ -41,7 +48,7 @@ TokenCacheEntry::TokenCacheEntry(std::string accessToken,
 }
 
 
-bool TokenCacheEntry::isExpired() {
+bool TokenCacheEntry::isExpired(long long leadSeconds) {
   long long currentTimestamp = getSecondsSinceEpoch();
   // We need to get the "exp" key from the parsed access token, but only
   // if it exists. That's harder to do that one would hope.
@@ -55,7 +62,18 @@ bool TokenCacheEntry::isExpired() {
     WriteLog(LL_TRACE,
              "  Token expires in " + std::to_string(timeToExpiry) + " seconds");
   }
-  return (timeToExpiry - EXPIRY_GRACE_PERIOD_S) < 0;
+  return (timeToExpiry - EXPIRY_GRACE_PERIOD_S - leadSeconds) < 0;
+}
+
+
+long long TokenCacheEntry::getSecondsUntilExpired() {
+  long long expiresAt = this->parsedAccessToken.value<long long>("exp", 0LL);
+  return expiresAt - getSecondsSinceEpoch() - EXPIRY_GRACE_PERIOD_S;
+}
+
+bool TokenCacheEntry::hasExpiry() {
+  return this->parsedAccessToken.is_object() and
+         this->parsedAccessToken.contains("exp");
 }
 
 
@@ -87,16 +105,41 @@ std::string TokenCacheEntry::getTokenId() {
 }
 
 std::wstring getTempFilePath() {
-  PWSTR tempPath = nullptr;
-  // https://learn.microsoft.com/en-us/windows/win32/api/shlobj_core/nf-shlobj_core-shgetknownfolderpath
-  if (SUCCEEDED(
-          SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, NULL, &tempPath))) {
-    std::wstring tempPathStr(tempPath);
-    // We are responsible for freeing the memory used to return the tempPath.
-    CoTaskMemFree(tempPath);
-    return tempPathStr + L"\\Temp\\TrinoODBCTokenCache.json";
+  return getLocalAppDataTempFilePath(L"TrinoODBCTokenCache.json");
+}
+
+std::wstring getLockFilePath() {
+  return getLocalAppDataTempFilePath(L"TrinoODBCTokenCache.json.lock");
+}
+
+static json readTokenCacheJson(std::wstring filePath) {
+  // Return the whole cache file, or an empty object if it is missing or
+  // unreadable. The file is only ever replaced atomically, so a parse
+  // failure here means it really is corrupt rather than half written.
+  std::ifstream inputFile(filePath);
+  json jsonData = json(json::value_t::object);
+  if (!inputFile.is_open()) {
+    return jsonData;
+  }
+  try {
+    inputFile >> jsonData;
+  } catch (const std::exception& e) {
+    WriteLog(LL_ERROR,
+             "  ERROR: failed to parse token cache file as JSON: " +
+                 std::string(e.what()));
+    jsonData = json(json::value_t::object);
+  }
+  inputFile.close();
+  if (not jsonData.is_object()) {
+    jsonData = json(json::value_t::object);
+  }
+  return jsonData;
+}
+
+static void writeTokenCacheJson(std::wstring filePath, json jsonData) {
+  if (!writeFileAtomically(filePath, jsonData.dump(TOKEN_CACHE_JSON_INDENT))) {
+    WriteLog(LL_ERROR, "  ERROR: cannot write token cache file");
   }
-  return L"";
 }
 
 
@@ -113,22 +156,15 @@ TokenCacheEntry readTokenCache(const std::string& tokenId) {
     return TokenCacheEntry("", "", tokenId);
   }
 
-  // Handle the case that the file can't be parsed as JSON.
-  std::ifstream inputFile(filePath);
+  // Read under the writers' lock. Processes waiting on another one's
+  // refresh read the file several times a second, and the refreshing
+  // process can't rename its new file over one that is open.
   json jsonData;
-  try {
-    inputFile >> jsonData;
-  } catch (const std::exception& e) {
-    WriteLog(LL_ERROR,
-             "  ERROR: failed to parse token cache file as JSON: " +
-                 std::string(e.what()));
-    inputFile.close();
-    return TokenCacheEntry("", "", tokenId);
+  {
+    FileLock lock(getLockFilePath(), TOKEN_CACHE_LOCK_TIMEOUT_MS);
+    jsonData = readTokenCacheJson(filePath);
   }
 
-  // Close the file, at this point we have parsed it to JSON.
-  inputFile.close();
-
   // Get the tokens, if they are available. Be sure to handle the case that
   // we're trying to read a tokenId that's not present in the file. We want to
   // default to empty strings for the tokens in that case.
@@ -154,18 +190,13 @@ TokenCacheEntry readTokenCache(const std::string& tokenId) {
     WriteLog(LL_WARN,
              "  Deleting potentially corrupted token entry from cache.");
 
-    // Remove the corrupted token data
-    if (jsonData.contains(tokenId)) {
-      jsonData.erase(tokenId);
-      std::ofstream outputFile(filePath);
-      if (outputFile.is_open()) {
-        outputFile << jsonData.dump(TOKEN_CACHE_JSON_INDENT);
-        outputFile.close();
-      } else {
-        WriteLog(LL_ERROR,
-                 "  ERROR: Could not open token cache file to delete "
-                 "corrupted entry.");
-      }
+    // Remove the corrupted token data. Re-read the file under the lock so
+    // we don't drop entries another process wrote since we read it.
+    FileLock lock(getLockFilePath(), TOKEN_CACHE_LOCK_TIMEOUT_MS);
+    json latestJsonData = readTokenCacheJson(filePath);
+    if (latestJsonData.contains(tokenId)) {
+      latestJsonData.erase(tokenId);
+      writeTokenCacheJson(filePath, latestJsonData);
     }
     return TokenCacheEntry("", "", tokenId);
   }
@@ -173,37 +204,80 @@ TokenCacheEntry readTokenCache(const std::string& tokenId) {
 
 
 void writeTokenCache(TokenCacheEntry cacheEntry) {
+  writeTokenCache(std::vector<TokenCacheEntry>{cacheEntry});
+}
+
+
+void writeTokenCache(std::vector<TokenCacheEntry> cacheEntries) {
   std::wstring filePath = getTempFilePath();
 
-  // Start by reading the cache file in its current state.
-  std::ifstream inputFile(filePath);
-  json inputJsonData;
-  if (!inputFile.is_open()) {
-    WriteLog(LL_WARN,
-             "  ERROR: cannot open token cache file for reading. First time "
-             "writing to token cache?");
-  } else {
-    WriteLog(LL_TRACE,
-             "  Reading from token cache before overwriting it fresh");
-    inputFile >> inputJsonData;
-    inputFile.close();
+  // Encrypt before taking the lock, it's the slow part.
+  std::vector<std::pair<std::string, json>> encryptedEntries;
+  for (TokenCacheEntry& cacheEntry : cacheEntries) {
+    json tokenData = json::object();
+    tokenData["encryptedAccessToken"] =
+        userEncryptString(cacheEntry.getAccessToken());
+    tokenData["encryptedRefreshToken"] =
+        userEncryptString(cacheEntry.getRefreshToken());
+    encryptedEntries.push_back({cacheEntry.getTokenId(), tokenData});
   }
 
-  // Modify the input with the new token(s) we wish to write.
-  std::string tokenId    = cacheEntry.getTokenId();
-  inputJsonData[tokenId] = json::object();
-  inputJsonData[tokenId]["encryptedAccessToken"] =
-      userEncryptString(cacheEntry.getAccessToken());
-  inputJsonData[tokenId]["encryptedRefreshToken"] =
-      userEncryptString(cacheEntry.getRefreshToken());
-
-  // Last, modify it and write it back with an update token cache.
-  std::ofstream outputFile(filePath);
-  if (!outputFile.is_open()) {
-    WriteLog(LL_ERROR, "  ERROR: cannot open token cache file for writing");
+  // Other driver processes update the same file. Hold the lock across the
+  // whole read-modify-write so none of their entries get lost.
+  FileLock lock(getLockFilePath(), TOKEN_CACHE_LOCK_TIMEOUT_MS);
+  WriteLog(LL_TRACE, "  Reading from token cache before overwriting it fresh");
+  json inputJsonData = readTokenCacheJson(filePath);
+
+  // Replacing the whole entry also clears any refresh claim on it.
+  for (auto& pair : encryptedEntries) {
+    inputJsonData[pair.first] = pair.second;
+  }
+
+  writeTokenCacheJson(filePath, inputJsonData);
+}
+
+
+bool claimTokenRefresh(const std::string& tokenId) {
+  std::wstring filePath = getTempFilePath();
+  FileLock lock(getLockFilePath(), TOKEN_CACHE_LOCK_TIMEOUT_MS);
+  json jsonData  = readTokenCacheJson(filePath);
+  json tokenData = jsonData.value(tokenId, json(json::value_t::object));
+
+  long long now = getSecondsSinceEpoch();
+  long long refreshingUntil =
+      tokenData.value<long long>("refreshingUntil", 0LL);
+  unsigned long refreshingProcess =
+      tokenData.value<unsigned long>("refreshingProcess", 0UL);
+  unsigned long thisProcess = getCurrentProcessIdentifier();
+  if (refreshingUntil > now and refreshingProcess != thisProcess) {
+    WriteLog(LL_DEBUG,
+             "  Process " + std::to_string(refreshingProcess) +
+                 " is already refreshing token " + tokenId);
+    return false;
+  }
+
+  tokenData["refreshingUntil"]   = now + TOKEN_REFRESH_CLAIM_S;
+  tokenData["refreshingProcess"] = thisProcess;
+  jsonData[tokenId]              = tokenData;
+  writeTokenCacheJson(filePath, jsonData);
+  return true;
+}
+
+
+void releaseTokenRefreshClaim(const std::string& tokenId) {
+  std::wstring filePath = getTempFilePath();
+  FileLock lock(getLockFilePath(), TOKEN_CACHE_LOCK_TIMEOUT_MS);
+  json jsonData = readTokenCacheJson(filePath);
+  if (not jsonData.contains(tokenId)) {
+    return;
+  }
+  if (jsonData[tokenId].value<unsigned long>("refreshingProcess", 0UL) !=
+      getCurrentProcessIdentifier()) {
+    return;
   }
-  outputFile << inputJsonData.dump(TOKEN_CACHE_JSON_INDENT);
-  outputFile.close();
+  jsonData[tokenId].erase("refreshingUntil");
+  jsonData[tokenId].erase("refreshingProcess");
+  writeTokenCacheJson(filePath, jsonData);
 }
 
 
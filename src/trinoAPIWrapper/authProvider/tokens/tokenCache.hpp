@@ -2,6 +2,7 @@
 
 #include <nlohmann/json.hpp>
 #include <string>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -16,7 +17,16 @@ class TokenCacheEntry {
     TokenCacheEntry(std::string accessToken,
                     std::string refreshToken,
                     std::string tokenId);
-    bool isExpired();
+    // A token counts as expired once it is inside the expiry grace
+    // period. Pass leadSeconds to ask whether it will be within that
+    // many seconds of being expired.
+    bool isExpired(long long leadSeconds = 0);
+    // Seconds until isExpired() starts returning true. Negative if it
+    // already does.
+    long long getSecondsUntilExpired();
+    // Whether the access token has an "exp" claim. Tokens without one
+    // always count as expired.
+    bool hasExpiry();
     void setAccessToken(std::string accessToken);
     void setRefreshToken(std::string refreshToken);
     json getParsedAccessToken();
@@ -33,3 +43,19 @@ std::string getTokenIdentity(std::string hostname,
                              std::string connectionName);
 
 void writeTokenCache(TokenCacheEntry cacheEntry);
+
+// Write several entries with a single read-modify-write of the cache file.
+void writeTokenCache(std::vector<TokenCacheEntry> cacheEntries);
+
+/*
+Cross-process coordination of token refreshes. Before calling the
+identity provider, a process claims the refresh for tokenId in the cache
+file. Other processes that see the claim wait for the new token to show
+up in the file instead of starting their own refresh. The claim is
+cleared when the refreshed token is written, or by releaseTokenRefreshClaim
+if the refresh failed, and it lapses on its own after a short while.
+
+claimTokenRefresh returns false if another live process holds the claim.
+*/
+bool claimTokenRefresh(const std::string& tokenId);
+void releaseTokenRefreshClaim(const std::string& tokenId);
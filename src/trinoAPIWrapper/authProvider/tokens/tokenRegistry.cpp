@@ -0,0 +1,184 @@
+#include "tokenRegistry.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "../../../util/writeLog.hpp"
+
+
+struct SharedTokenSlot {
+    std::optional<TokenCacheEntry> entry;
+    bool refreshing           = false;
+    bool lastRefreshSucceeded = false;
+};
+
+static std::mutex registryMutex;
+static std::condition_variable refreshFinished;
+static std::map<std::string, SharedTokenSlot> sharedTokens;
+
+static std::mutex writeBackMutex;
+static std::condition_variable writeBackIdle;
+static std::map<std::string, TokenCacheEntry> pendingWrites;
+static bool writerRunning = false;
+
+
+// How long to wait on another process's token refresh before giving up on
+// it and refreshing ourselves, and how often to check for its result.
+long long TOKEN_REFRESH_WAIT_S  = 30;
+long long TOKEN_REFRESH_POLL_MS = 250;
+
+
+static SharedTokenSlot& getLoadedSlot(std::string tokenId) {
+  // The caller must hold registryMutex.
+  SharedTokenSlot& slot = sharedTokens[tokenId];
+  if (not slot.entry.has_value()) {
+    WriteLog(LL_TRACE, "  Loading token from disk for identity " + tokenId);
+    slot.entry = readTokenCache(tokenId);
+  }
+  return slot;
+}
+
+static TokenCacheEntry
+refreshAcrossProcesses(std::string tokenId,
+                       std::string refreshToken,
+                       std::function<std::string()> obtainAccessToken,
+                       long long leadSeconds) {
+  // Other driver processes on this machine share the token cache file.
+  // If one of them is already refreshing this token, wait for its result
+  // to land in the file rather than asking the identity provider again.
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::seconds(TOKEN_REFRESH_WAIT_S);
+  while (true) {
+    TokenCacheEntry onDisk = readTokenCache(tokenId);
+    if (not onDisk.isExpired(leadSeconds)) {
+      WriteLog(LL_DEBUG,
+               "  Using token refreshed by another process for " + tokenId);
+      return onDisk;
+    }
+    if (claimTokenRefresh(tokenId)) {
+      break;
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      WriteLog(LL_WARN,
+               "  WARNING: gave up waiting on another process to refresh "
+               "token " +
+                   tokenId);
+      break;
+    }
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(TOKEN_REFRESH_POLL_MS));
+  }
+
+  try {
+    // Parsing the new token happens here too, outside the registry lock,
+    // so that a malformed token can't leave the slot stuck refreshing.
+    return TokenCacheEntry(obtainAccessToken(), refreshToken, tokenId);
+  } catch (...) {
+    releaseTokenRefreshClaim(tokenId);
+    throw;
+  }
+}
+
+static void writeBackLoop() {
+  std::unique_lock<std::mutex> lock(writeBackMutex);
+  while (not pendingWrites.empty()) {
+    // Take everything queued so far. Any tokens that get refreshed while we
+    // write these will be picked up by the next pass of the loop.
+    std::vector<TokenCacheEntry> batch;
+    for (auto& pair : pendingWrites) {
+      batch.push_back(pair.second);
+    }
+    pendingWrites.clear();
+    lock.unlock();
+    try {
+      writeTokenCache(batch);
+    } catch (const std::exception& e) {
+      WriteLog(LL_ERROR,
+               "  ERROR: failed to write token cache: " +
+                   std::string(e.what()));
+    }
+    lock.lock();
+  }
+  writerRunning = false;
+  writeBackIdle.notify_all();
+}
+
+static void scheduleWriteBack(TokenCacheEntry entry) {
+  std::lock_guard<std::mutex> lock(writeBackMutex);
+  // Only the newest token for an identity is worth writing, so a later
+  // refresh replaces an earlier one that hasn't been written yet.
+  pendingWrites.insert_or_assign(entry.getTokenId(), entry);
+  if (not writerRunning) {
+    writerRunning = true;
+    std::thread(writeBackLoop).detach();
+  }
+}
+
+
+TokenCacheEntry getSharedToken(std::string tokenId) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  return getLoadedSlot(tokenId).entry.value();
+}
+
+TokenCacheEntry
+refreshSharedToken(std::string tokenId,
+                   std::function<std::string()> obtainAccessToken,
+                   long long leadSeconds) {
+  std::unique_lock<std::mutex> lock(registryMutex);
+  SharedTokenSlot& slot = getLoadedSlot(tokenId);
+
+  bool waited = false;
+  while (slot.refreshing) {
+    if (not waited) {
+      WriteLog(LL_TRACE,
+               "  Waiting on in-flight token refresh for identity " + tokenId);
+    }
+    waited = true;
+    refreshFinished.wait(lock);
+  }
+  // Reuse the token if somebody else refreshed it since the caller last
+  // looked. A refresh we waited on is reused even when the new token is
+  // already inside the expiry grace period, otherwise every waiter would
+  // go on to call the identity provider anyway. If that refresh failed we
+  // fall through and try ourselves, so each caller can surface an error.
+  if (not slot.entry->isExpired(leadSeconds) or
+      (waited and slot.lastRefreshSucceeded)) {
+    return slot.entry.value();
+  }
+
+  slot.refreshing          = true;
+  std::string refreshToken = slot.entry->getRefreshToken();
+  lock.unlock();
+
+  std::optional<TokenCacheEntry> refreshed;
+  try {
+    refreshed = refreshAcrossProcesses(
+        tokenId, refreshToken, obtainAccessToken, leadSeconds);
+  } catch (...) {
+    lock.lock();
+    slot.refreshing           = false;
+    slot.lastRefreshSucceeded = false;
+    refreshFinished.notify_all();
+    throw;
+  }
+
+  lock.lock();
+  slot.entry                = refreshed;
+  slot.refreshing           = false;
+  slot.lastRefreshSucceeded = true;
+  refreshFinished.notify_all();
+  lock.unlock();
+
+  scheduleWriteBack(refreshed.value());
+  return refreshed.value();
+}
+
+void flushTokenRegistry() {
+  std::unique_lock<std::mutex> lock(writeBackMutex);
+  writeBackIdle.wait(lock, []() { return not writerRunning; });
+}
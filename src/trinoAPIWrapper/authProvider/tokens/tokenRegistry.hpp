@@ -0,0 +1,41 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "tokenCache.hpp"
+
+/*
+A process-wide, in-memory registry of tokens keyed by token identity
+(see getTokenIdentity).
+
+Every connection that authenticates with the same identity shares a
+single entry. The on-disk token cache is only read the first time an
+identity is requested in this process, and updates are written back to
+disk on a background thread so that a refresh never waits on file IO.
+
+Refreshes are single-flight: when many connections find the shared token
+expired at the same time, only one of them calls the identity provider
+and the rest wait for, and reuse, its result. The same goes for other
+driver processes on the machine, which coordinate through a claim in the
+token cache file (see claimTokenRefresh).
+*/
+
+// Return the current token for tokenId, loading it from the on-disk
+// token cache the first time the identity is seen in this process.
+TokenCacheEntry getSharedToken(std::string tokenId);
+
+// Refresh the token for tokenId using obtainAccessToken, unless another
+// caller already holds a newer token or is in the middle of refreshing it,
+// in which case that result is reused. Exceptions thrown by
+// obtainAccessToken propagate to the caller that invoked it.
+//
+// With a non-zero leadSeconds the token is refreshed if it will expire
+// within that many seconds, which lets callers refresh ahead of time.
+TokenCacheEntry
+refreshSharedToken(std::string tokenId,
+                   std::function<std::string()> obtainAccessToken,
+                   long long leadSeconds = 0);
+
+// Block until all pending token writes have reached the disk.
+void flushTokenRegistry();
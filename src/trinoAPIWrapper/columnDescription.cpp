@@ -1,5 +1,7 @@
 #include "columnDescription.hpp"
 
+#include <cctype>
+
 ColumnDescription::ColumnDescription(const json& columnInfo) {
   this->name          = columnInfo["name"];
   this->type          = columnInfo["type"];
@@ -22,3 +24,54 @@ const std::string& ColumnDescription::getRawType() const {
 const json& ColumnDescription::getTypeArguments() const {
   return this->typeArguments;
 }
+
+json columnJsonFromType(const std::string& name, const std::string& type) {
+  /*
+  A parameterized type like "timestamp(3) with time zone" has the raw type
+  "timestamp with time zone" and one argument, 3. Container types like
+  "array(varchar)" keep only their outer name, since their arguments are
+  types rather than numbers.
+  */
+  std::string rawType = type;
+  json arguments      = json::array();
+  size_t open         = type.find('(');
+  size_t close        = type.rfind(')');
+  if (open != std::string::npos and close != std::string::npos and
+      close > open) {
+    std::string inside = type.substr(open + 1, close - open - 1);
+    bool isNumeric     = not inside.empty();
+    for (char c : inside) {
+      if (not std::isdigit(static_cast<unsigned char>(c)) and c != ',' and
+          c != ' ') {
+        isNumeric = false;
+      }
+    }
+    if (isNumeric) {
+      rawType = type.substr(0, open) + type.substr(close + 1);
+
+      size_t start = 0;
+      while (start < inside.size()) {
+        size_t end = inside.find(',', start);
+        if (end == std::string::npos) {
+          end = inside.size();
+        }
+        arguments.push_back(
+            {{"kind", "LONG"},
+             {"value", std::stoll(inside.substr(start, end - start))}});
+        start = end + 1;
+      }
+    } else {
+      rawType = type.substr(0, open);
+    }
+  }
+  // Trino reports an unbounded varchar with the largest possible length.
+  if (rawType == "varchar" and arguments.empty()) {
+    arguments.push_back({{"kind", "LONG"}, {"value", 2147483647}});
+  }
+  json column;
+  column["name"]                       = name;
+  column["type"]                       = type;
+  column["typeSignature"]["rawType"]   = rawType;
+  column["typeSignature"]["arguments"] = arguments;
+  return column;
+}
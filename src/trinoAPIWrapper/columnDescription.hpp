@@ -20,3 +20,8 @@ class ColumnDescription {
     const std::string& getRawType() const;
     const json& getTypeArguments() const;
 };
+
+// Build the column information Trino returns with query results from a
+// column name and a type as Trino prints it, such as "varchar(25)" or
+// "decimal(12,2)". Only numeric type arguments are filled in.
+json columnJsonFromType(const std::string& name, const std::string& type);
@@ -1,46 +1,74 @@
 #include "connectionConfig.hpp"
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <nlohmann/json.hpp>
 
 #include "../util/callbackHelper.hpp"
-#include "../util/stringTrim.hpp"
+#include "../util/delimKvpHelper.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 #include "authProvider/clientCredAuthProvider.hpp"
 #include "authProvider/deviceFlowAuthProvider.hpp"
 #include "authProvider/externalAuthProvider.hpp"
 #include "authProvider/noAuthProvider.hpp"
+#include "authProvider/oidcDiscoveryCache.hpp"
+#include "curlHelpers.hpp"
+#include "httpTimings.hpp"
+#include "serverInfo.hpp"
+#include "tlsSessionCache.hpp"
 
 
 using json = nlohmann::json;
 
-static size_t
-curlWriteCallback(void* contents, size_t size, size_t nmemb, std::string* s) {
-  size_t totalSize = size * nmemb;
-  s->append(static_cast<char*>(contents), totalSize);
-  return totalSize;
-}
-
-static size_t
-curlHeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata) {
-  std::map<std::string, std::string>* responseHeaderData =
-      (std::map<std::string, std::string>*)userdata;
-  std::string headerData = std::string(buffer, nitems);
-  if (headerData.starts_with("HTTP/")) {
-    // The HTTP/<version> header is not a key value pair, so
-    // it gets some special logic.
-    responseHeaderData->insert({"http", headerData});
-  } else {
-    auto firstColon = headerData.find(':');
-    if (firstColon != std::string::npos) {
-      std::string key   = headerData.substr(0, firstColon);
-      std::string value = headerData.substr(firstColon + 1);
-      // The values usually end in \r\n at a minimum, so we need
-      // to trim that off.
-      trim(value);
-      responseHeaderData->insert({key, value});
-    }
+// How long connecting waits on the requests it makes ahead of the first
+// query. They only save time, so an unreachable server shouldn't hold up
+// the application for the whole connect timeout. Whatever doesn't finish
+// in time is done again when it's needed.
+long CONNECT_WARM_UP_TIMEOUT_MS = 2000;
+
+static long long
+millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+static long warmUpTimeoutMs(long connectTimeoutMs) {
+  // Zero is no timeout at all to libcurl.
+  if (connectTimeoutMs <= 0) {
+    return CONNECT_WARM_UP_TIMEOUT_MS;
+  }
+  return std::min(connectTimeoutMs, CONNECT_WARM_UP_TIMEOUT_MS);
+}
+
+static void prefetchOidcDiscovery(std::string discoveryUrl,
+                                  long long ttlS,
+                                  long timeoutMs) {
+  /*
+  Put the identity provider's discovery document in the in-process cache,
+  so the first token refresh doesn't have to wait for it. Any failure is
+  left for that refresh to report.
+  */
+  auto start = std::chrono::steady_clock::now();
+  std::string responseData;
+  std::map<std::string, std::string> responseHeaderData;
+  CURL* curl = curl_easy_init();
+  setCurlDefaults(curl, &responseData, &responseHeaderData);
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, timeoutMs);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeoutMs);
+  try {
+    getOidcDiscoveryDocument(
+        curl, discoveryUrl, &responseData, &responseHeaderData, ttlS);
+    WriteLog(LL_DEBUG,
+             "  Connect: OIDC discovery took " +
+                 std::to_string(millisecondsSince(start)) + " ms");
+  } catch (const std::exception& e) {
+    WriteLog(LL_WARN,
+             "  WARNING: Could not prefetch the OIDC discovery document: " +
+                 std::string(e.what()));
   }
-  // Return the number of bytes consumed to signal success.
-  return nitems * size;
+  curl_easy_cleanup(curl);
 }
 
 ConnectionConfig::ConnectionConfig(std::string hostname,
@@ -52,7 +80,8 @@ ConnectionConfig::ConnectionConfig(std::string hostname,
                                    std::string clientSecret,
                                    std::string oidcScope,
                                    std::string grantType,
-                                   std::string tokenEndpoint) {
+                                   std::string tokenEndpoint,
+                                   ConnectionOptions options) {
 
   this->hostname       = hostname;
   this->port           = port;
@@ -60,13 +89,57 @@ ConnectionConfig::ConnectionConfig(std::string hostname,
   this->authMethod     = authMethod;
   this->tokenEndpoint  = tokenEndpoint;
   this->grantType      = grantType;
+  this->options        = options;
 
-  this->curl = nullptr;
+  this->curl                  = nullptr;
+  this->requestHeaders        = nullptr;
+  this->requestHeadersVersion = 0;
 
   if (hostname.empty()) {
     throw std::invalid_argument("hostname");
   }
 
+  this->endpointSelector = getEndpointSelector(
+      parseEndpointList(hostname, port, options.endpoints));
+  if (options.maxPreparedStatements > 0) {
+    this->preparedStatements.setCapacity(options.maxPreparedStatements);
+  }
+  // The DSN and client ID stand in for the user, since the credentials
+  // themselves come from them.
+  this->identity = hostname + ":" + std::to_string(port) + "|" +
+                   connectionName + "|" + std::to_string(authMethod) + "|" +
+                   clientId + "|";
+
+  /*
+  Opening the HTTP connection to the coordinator, loading cached tokens,
+  and fetching the OIDC discovery document don't depend on each other, so
+  they run side by side. All of them finish, or give up after
+  CONNECT_WARM_UP_TIMEOUT_MS, before the connection is handed to the
+  application.
+  */
+  auto connectStart = std::chrono::steady_clock::now();
+  // The warm-up opens this->curl. The destructor doesn't run if anything
+  // below throws, so until the end of the constructor the handle is
+  // cleaned up here instead. This is declared before the futures so the
+  // warm-up is done with the handle by the time it is cleaned up.
+  std::unique_ptr<CURL*, void (*)(CURL**)> curlOwner(
+      &this->curl, [](CURL** curl) {
+        curl_easy_cleanup(*curl);
+        *curl = nullptr;
+      });
+  std::future<void> warmUp =
+      std::async(std::launch::async, &ConnectionConfig::warmUpConnection, this);
+  std::future<void> discovery;
+  if ((authMethod == AM_CLIENT_CRED_AUTH or authMethod == AM_DEVICE_FLOW) and
+      not oidcDiscoveryUrl.empty()) {
+    discovery = std::async(std::launch::async,
+                           prefetchOidcDiscovery,
+                           oidcDiscoveryUrl,
+                           options.oidcDiscoveryTtlS,
+                           warmUpTimeoutMs(options.connectTimeoutMs));
+  }
+
+  auto authStart = std::chrono::steady_clock::now();
   switch (authMethod) {
     case AM_NO_AUTH: {
       this->authConfigPtr = getNoAuthConfigPtr(hostname, port, connectionName);
@@ -78,25 +151,29 @@ ConnectionConfig::ConnectionConfig(std::string hostname,
       break;
     }
     case AM_CLIENT_CRED_AUTH: {
-      this->authConfigPtr = getClientCredAuthProvider(hostname,
-                                                      port,
-                                                      connectionName,
-                                                      oidcDiscoveryUrl,
-                                                      clientId,
-                                                      clientSecret,
-                                                      oidcScope,
-                                                      grantType,
-                                                      tokenEndpoint);
+      this->authConfigPtr =
+          getClientCredAuthProvider(hostname,
+                                    port,
+                                    connectionName,
+                                    oidcDiscoveryUrl,
+                                    clientId,
+                                    clientSecret,
+                                    oidcScope,
+                                    grantType,
+                                    tokenEndpoint,
+                                    options.oidcDiscoveryTtlS);
       break;
     }
     case AM_DEVICE_FLOW: {
-      this->authConfigPtr = getDeviceFlowAuthProvider(hostname,
-                                                      port,
-                                                      connectionName,
-                                                      oidcDiscoveryUrl,
-                                                      clientId,
-                                                      clientSecret,
-                                                      oidcScope);
+      this->authConfigPtr =
+          getDeviceFlowAuthProvider(hostname,
+                                    port,
+                                    connectionName,
+                                    oidcDiscoveryUrl,
+                                    clientId,
+                                    clientSecret,
+                                    oidcScope,
+                                    options.oidcDiscoveryTtlS);
       break;
     }
 
@@ -107,10 +184,31 @@ ConnectionConfig::ConnectionConfig(std::string hostname,
                    std::to_string(authMethod));
     }
   }
+
+  WriteLog(LL_DEBUG,
+           "  Connect: loading credentials took " +
+               std::to_string(millisecondsSince(authStart)) + " ms");
+
+  warmUp.wait();
+  if (discovery.valid()) {
+    discovery.wait();
+  }
+  WriteLog(LL_DEBUG,
+           "  Connect: setup took " +
+               std::to_string(millisecondsSince(connectStart)) + " ms");
+
+  if (this->authConfigPtr) {
+    this->authConfigPtr->startBackgroundRefresh();
+  }
+  curlOwner.release();
 }
 
 ConnectionConfig::~ConnectionConfig() {
+  if (this->curl and this->options.tlsSessionCache) {
+    exportTlsSessions(this->curl, this->hostname, this->port);
+  }
   curl_easy_cleanup(this->curl);
+  this->freeRequestHeaders();
 }
 
 std::string const ConnectionConfig::getHostname() {
@@ -125,30 +223,100 @@ ApiAuthMethod const ConnectionConfig::getAuthMethod() {
   return this->authMethod;
 }
 
-std::string const ConnectionConfig::getStatementUrl() {
-  return (this->hostname) + ":" + std::to_string(port) + "/v1/statement";
+ConnectionOptions const ConnectionConfig::getOptions() {
+  return this->options;
 }
 
-CURL* ConnectionConfig::getCurl() {
+std::string const
+ConnectionConfig::getStatementUrl(const std::set<size_t>& skip,
+                                  size_t& endpoint) {
   /*
-  Return a curl handle, reset it if needed, and it's ready to go.
+  Pick the coordinator for a new query and return its statement URL, and
+  in endpoint which one it is. Only submissions are routed, since a
+  query's nextUri already points at the coordinator running it. Each
+  query keeps its own endpoint, since statements of the connection may
+  submit at the same time.
+  */
+  endpoint = this->endpointSelector->selectEndpoint(skip);
+  return this->endpointSelector->getEndpoint(endpoint).statementUrl;
+}
+
+std::string const ConnectionConfig::getEndpointUrl(size_t endpoint) {
+  return this->endpointSelector->getEndpoint(endpoint).baseUrl;
+}
+
+bool ConnectionConfig::reportEndpointFailure(size_t endpoint,
+                                             std::set<size_t>& tried) {
+  /*
+  Take the coordinator a query was sent to out of rotation. Returns true
+  if there's another coordinator that hasn't been tried yet.
   */
+  this->endpointSelector->reportFailure(endpoint);
+  tried.insert(endpoint);
+  return tried.size() < this->endpointSelector->getEndpointCount();
+}
+
+void ConnectionConfig::reportEndpointSuccess(size_t endpoint) {
+  this->endpointSelector->reportSuccess(endpoint);
+}
+
+void ConnectionConfig::applyRequestHeaders() {
+  // Read the version before the headers. If they change in between we
+  // just rebuild once more on the next request.
+  unsigned long long headersVersion =
+      this->authConfigPtr->getHeadersVersion();
+  if (this->requestHeaders == nullptr or
+      headersVersion != this->requestHeadersVersion) {
+    // The headers are copied out because a background token refresh may
+    // replace the Authorization header at any time.
+    std::map<std::string, std::string> authHeaders =
+        this->authConfigPtr->getHeaders();
+    struct curl_slist* headers = nullptr;
+    for (const auto pair : authHeaders) {
+      std::string nextHeader = pair.first + ": " + pair.second;
+      headers                = curl_slist_append(headers, nextHeader.c_str());
+    }
+    // Point the handle at the new list before freeing the old one.
+    curl_easy_setopt(this->curl, CURLOPT_HTTPHEADER, headers);
+    this->freeRequestHeaders();
+    this->requestHeaders        = headers;
+    this->requestHeadersVersion = headersVersion;
+  } else {
+    // Auth providers point the handle at their own header lists while
+    // they talk to the identity provider, so always put ours back.
+    curl_easy_setopt(this->curl, CURLOPT_HTTPHEADER, this->requestHeaders);
+  }
+}
+
+void ConnectionConfig::freeRequestHeaders() {
+  if (this->requestHeaders) {
+    curl_slist_free_all(this->requestHeaders);
+    this->requestHeaders = nullptr;
+  }
+}
+
+void ConnectionConfig::initCurl() {
   if (this->curl == nullptr) {
     this->curl = curl_easy_init();
-    // We always want to use SSL.
-    curl_easy_setopt(this->curl, CURLOPT_SSL_OPTIONS, CURLSSLOPT_NATIVE_CA);
-    // We want to save the response body in a string using a callback.
-    curl_easy_setopt(this->curl, CURLOPT_WRITEFUNCTION, curlWriteCallback);
-    curl_easy_setopt(this->curl, CURLOPT_WRITEDATA, &(this->responseData));
-    // We want to parse response headers.
-    curl_easy_setopt(this->curl, CURLOPT_HEADERFUNCTION, curlHeaderCallback);
+    setCurlDefaults(
+        this->curl, &(this->responseData), &(this->responseHeaderData));
+    curl_easy_setopt(
+        this->curl, CURLOPT_CONNECTTIMEOUT_MS, this->options.connectTimeoutMs);
     curl_easy_setopt(
-        this->curl, CURLOPT_HEADERDATA, &(this->responseHeaderData));
-    // Set a timeout on all requests
-    curl_easy_setopt(this->curl, CURLOPT_TIMEOUT_MS, 10000);
-    // Enable gzip and/or deflate on responses
-    curl_easy_setopt(this->curl, CURLOPT_ACCEPT_ENCODING, "gzip, deflate");
+        this->curl, CURLOPT_TIMEOUT_MS, this->options.requestTimeoutMs);
+    // Seed the handle with TLS sessions saved by an earlier process so
+    // the first request can skip the full handshake.
+    if (this->options.tlsSessionCache) {
+      importTlsSessions(this->curl, this->hostname, this->port);
+    }
   }
+}
+
+CURL* ConnectionConfig::getCurl() {
+  /*
+  Return a curl handle, reset it if needed, and it's ready to go.
+  */
+  this->initCurl();
 
 curlSetup:
   // Clear the previous response data, we do not want to append to it.
@@ -163,18 +331,17 @@ curlSetup:
 
   // Let's say the standard state of curl is that the
   // handle is configured to run GET requests, no matter
-  // how it was used before.
+  // how it was used before. Clearing the custom request
+  // matters too, otherwise a DELETE sent to cancel a query
+  // would stick to every request after it.
   curl_easy_setopt(this->curl, CURLOPT_HTTPGET, true);
+  curl_easy_setopt(this->curl, CURLOPT_CUSTOMREQUEST, nullptr);
+  // Queries watch for cancellation with a progress callback that points
+  // at the query. Nothing else should run with it.
+  curl_easy_setopt(this->curl, CURLOPT_NOPROGRESS, 1L);
 
   // Set up any required headers if needed.
-  if (this->authConfigPtr->headers.size() > 0) {
-    struct curl_slist* headers = nullptr;
-    for (const auto pair : this->authConfigPtr->headers) {
-      std::string nextHeader = pair.first + ": " + pair.second;
-      headers                = curl_slist_append(headers, nextHeader.c_str());
-    }
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-  }
+  this->applyRequestHeaders();
 
   // Now that we have a fully configured CURL handle, check if we need to do
   // any required auth steps. We may need to use the configured handle to
@@ -182,14 +349,22 @@ curlSetup:
   if (this->authConfigPtr->isExpired()) {
     WriteLog(LL_TRACE,
              "  Detected expired authentication. Reauthenticating...");
-    this->authConfigPtr->refresh(
-        this->curl, &(this->responseData), &(this->responseHeaderData));
+    {
+      TraceSpan span("AuthConfig::refresh");
+      this->authConfigPtr->refresh(
+          this->curl, &(this->responseData), &(this->responseHeaderData));
+    }
+    this->authRefreshCount++;
     goto curlSetup;
   }
 
   return this->curl;
 }
 
+unsigned long long ConnectionConfig::getAuthRefreshCount() {
+  return this->authRefreshCount;
+}
+
 long ConnectionConfig::getLastHTTPStatusCode() {
   long httpStatusCode = -1;
   if (this->curl) {
@@ -198,25 +373,111 @@ long ConnectionConfig::getLastHTTPStatusCode() {
   return httpStatusCode;
 }
 
+std::string ConnectionConfig::getResponseHeader(std::string name) {
+  // Header names are stored as the server sent them, and HTTP/2 servers
+  // send them in lowercase, so compare without caring about case.
+  std::string lowercaseName = toLowercase(name);
+  for (auto& pair : this->responseHeaderData) {
+    if (toLowercase(pair.first) == lowercaseName) {
+      return pair.second;
+    }
+  }
+  return "";
+}
+
+std::map<std::string, std::string> ConnectionConfig::getRequestHeaders() {
+  // A copy of the headers every request on this connection carries, for
+  // requests sent from somewhere other than this connection's handle.
+  return this->authConfigPtr->getHeaders();
+}
+
+PreparedStatementCache& ConnectionConfig::getPreparedStatements() {
+  return this->preparedStatements;
+}
+
+std::string const ConnectionConfig::getIdentity() {
+  return this->identity;
+}
+
 void ConnectionConfig::disconnect() {
   for (std::function f : this->onDisconnectCallbacks) {
     f(this);
   }
   if (this->curl) {
+    if (this->options.tlsSessionCache) {
+      exportTlsSessions(this->curl, this->hostname, this->port);
+    }
     curl_easy_cleanup(this->curl);
     this->curl = nullptr;
   }
+  this->freeRequestHeaders();
+}
+
+void ConnectionConfig::warmUpConnection() {
+  /*
+  Runs on its own thread while the connection is set up. A GET on
+  /v1/info opens the TCP and TLS connection that the first query then
+  reuses, and reads the server version while it's at it. /v1/info needs
+  no credentials, so this doesn't wait for them.
+  */
+  auto start = std::chrono::steady_clock::now();
+  // The coordinator the first query will most likely go to.
+  std::string baseUrl =
+      this->getEndpointUrl(this->endpointSelector->selectEndpoint());
+  this->serverVersion = getServerInfoCache().getVersion(baseUrl).value_or("");
+
+  this->initCurl();
+  this->responseData.clear();
+  this->responseHeaderData.clear();
+  std::string url = baseUrl + "/v1/info";
+  curl_easy_setopt(this->curl, CURLOPT_URL, url.c_str());
+  long timeoutMs = warmUpTimeoutMs(this->options.connectTimeoutMs);
+  curl_easy_setopt(this->curl, CURLOPT_CONNECTTIMEOUT_MS, timeoutMs);
+  curl_easy_setopt(this->curl, CURLOPT_TIMEOUT_MS, timeoutMs);
+  CURLcode res = curl_easy_perform(this->curl);
+  curl_easy_setopt(
+      this->curl, CURLOPT_CONNECTTIMEOUT_MS, this->options.connectTimeoutMs);
+  curl_easy_setopt(
+      this->curl, CURLOPT_TIMEOUT_MS, this->options.requestTimeoutMs);
+  getHttpTimings().record(this->curl, HttpInfo);
+  if (res != CURLE_OK) {
+    WriteLog(LL_WARN,
+             "  WARNING: Could not reach " + baseUrl + " while connecting: " +
+                 std::string(curl_easy_strerror(res)));
+    return;
+  }
+  std::optional<std::string> version = parseServerVersion(this->responseData);
+  if (version) {
+    this->serverVersion = *version;
+    getServerInfoCache().putVersion(baseUrl, *version);
+  }
+  WriteLog(LL_DEBUG,
+           "  Connect: opening the connection to " + baseUrl + " took " +
+               std::to_string(millisecondsSince(start)) + " ms");
 }
 
 std::string ConnectionConfig::getTrinoServerVersion() {
+  std::string baseUrl =
+      this->getEndpointUrl(this->endpointSelector->selectEndpoint());
+  if (this->serverVersion.empty()) {
+    // The endpoint probes may have heard from it since.
+    this->serverVersion = getServerInfoCache().getVersion(baseUrl).value_or("");
+  }
+  if (not this->serverVersion.empty()) {
+    return this->serverVersion;
+  }
+
+  // The coordinator couldn't be reached while connecting. Ask again,
+  // through this connection's handle in case whatever sits in front of
+  // Trino wants our credentials.
   CURL* curl = this->getCurl();
 
-  std::string url =
-      this->hostname + ":" + std::to_string(this->port) + "/v1/info";
+  std::string url = baseUrl + "/v1/info";
 
   curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
 
   CURLcode res = curl_easy_perform(curl);
+  getHttpTimings().record(curl, HttpInfo);
   if (res != CURLE_OK) {
     WriteLog(LL_ERROR,
              "Failed to read trino server version: " +
@@ -224,8 +485,14 @@ std::string ConnectionConfig::getTrinoServerVersion() {
     return "";
   }
 
-  json jsonResponse = nlohmann::json::parse(this->responseData);
-  return jsonResponse["nodeVersion"]["version"].get<std::string>();
+  std::optional<std::string> parsed = parseServerVersion(this->responseData);
+  if (not parsed) {
+    WriteLog(LL_ERROR, "Failed to read trino server version");
+    return "";
+  }
+  getServerInfoCache().putVersion(baseUrl, *parsed);
+  this->serverVersion = *parsed;
+  return this->serverVersion;
 }
 
 void ConnectionConfig::registerDisconnectCallback(
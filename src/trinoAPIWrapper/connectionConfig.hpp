@@ -3,13 +3,17 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 
 #include <curl/curl.h>
 
 #include "apiAuthMethod.hpp"
 #include "authProvider/authConfig.hpp"
+#include "connectionOptions.hpp"
+#include "endpointSelector.hpp"
 #include "environmentConfig.hpp"
+#include "preparedStatementCache.hpp"
 
 class ConnectionConfig {
   private:
@@ -18,6 +22,23 @@ class ConnectionConfig {
     std::string connectionName;
     std::string tokenEndpoint;
     std::string grantType;
+    ConnectionOptions options;
+
+    // Every coordinator this connection may submit queries to.
+    std::shared_ptr<EndpointSelector> endpointSelector;
+
+    // Statements prepared on this connection, shared by all its statement
+    // handles.
+    PreparedStatementCache preparedStatements;
+
+    // Who this connection talks to, and as whom. Connections with the same
+    // identity share cached metadata.
+    std::string identity;
+
+    // The server version, read from /v1/info while the connection is set
+    // up. Empty if the coordinator couldn't be reached then.
+    std::string serverVersion;
+    void warmUpConnection();
 
     ApiAuthMethod authMethod;
     std::unique_ptr<AuthConfig> authConfigPtr;
@@ -27,6 +48,17 @@ class ConnectionConfig {
     // we can set up all the right headers and SSL options
     // every time anything asks for a CURL handle.
     CURL* curl;
+    void initCurl();
+    // How many times getCurl had to get new credentials first.
+    unsigned long long authRefreshCount = 0;
+
+    // Request state shared by every request on this connection. The header
+    // list is only rebuilt when the auth provider's headers change, and it
+    // is freed along with the CURL handle.
+    struct curl_slist* requestHeaders;
+    unsigned long long requestHeadersVersion;
+    void applyRequestHeaders();
+    void freeRequestHeaders();
 
   public:
     ConnectionConfig(std::string hostname,
@@ -38,15 +70,26 @@ class ConnectionConfig {
                      std::string clientSecret,
                      std::string oidcScope,
                      std::string grantType,
-                     std::string tokenEndpoint);
+                     std::string tokenEndpoint,
+                     ConnectionOptions options = ConnectionOptions());
 
     ~ConnectionConfig();
     std::string const getHostname();
-    std::string const getStatementUrl();
+    std::string const getStatementUrl(const std::set<size_t>& skip,
+                                      size_t& endpoint);
+    std::string const getEndpointUrl(size_t endpoint);
+    bool reportEndpointFailure(size_t endpoint, std::set<size_t>& tried);
+    void reportEndpointSuccess(size_t endpoint);
     unsigned short const getPort();
     ApiAuthMethod const getAuthMethod();
+    ConnectionOptions const getOptions();
     CURL* getCurl();
+    unsigned long long getAuthRefreshCount();
     long getLastHTTPStatusCode();
+    std::string getResponseHeader(std::string name);
+    std::map<std::string, std::string> getRequestHeaders();
+    PreparedStatementCache& getPreparedStatements();
+    std::string const getIdentity();
     void disconnect();
     std::string getTrinoServerVersion();
     void registerDisconnectCallback(std::function<void(ConnectionConfig*)> f);
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+
+/*
+Optional behaviors for a connection that don't change who we authenticate
+as. These come from the DSN or the connection string and are handed to the
+ConnectionConfig as a bundle so the constructor doesn't need a new argument
+for every tuning knob.
+
+The defaults here are the defaults for the driver.
+*/
+struct ConnectionOptions {
+    // Persist TLS session tickets to disk (encrypted with the user's
+    // credentials) so that short-lived processes can resume a TLS session
+    // on their first request instead of doing a full handshake.
+    bool tlsSessionCache = false;
+
+    // How long to wait for a TCP and TLS connection to the coordinator,
+    // and for any single HTTP request to finish, in milliseconds.
+    long connectTimeoutMs = 10000;
+    long requestTimeoutMs = 10000;
+
+    // How much time a statement may spend waiting to retry failed page
+    // requests before its error is returned to the application.
+    long retryBudgetMs = 120000;
+
+    // Additional coordinators to send queries to, as a comma separated
+    // list in the same form as the hostname, each with an optional
+    // ":port". The connection's own hostname and port are always tried
+    // first.
+    std::string endpoints = "";
+
+    // Client side limits on how many queries may run at once, in the whole
+    // process and on any one endpoint, and how long a query may wait for
+    // its turn before giving up. Zero means no limit.
+    long maxConcurrentQueries = 0;
+    long maxEndpointQueries   = 0;
+    long admissionTimeoutMs   = 60000;
+
+    // When a statement has SQL_ATTR_MAX_ROWS set, append a LIMIT to plain
+    // SELECT statements so Trino doesn't produce rows that would only be
+    // thrown away. Without this, the driver still stops reading once it
+    // has enough rows, and terminates the query.
+    bool injectRowLimit = false;
+
+    // How many distinct prepared statements a connection keeps registered
+    // with Trino. Preparing one more forgets the least recently used.
+    long maxPreparedStatements = 64;
+
+    // The longest statement the driver writes when it turns an array of
+    // INSERT parameters into multi-row INSERTs. Trino rejects statements
+    // longer than its query.max-length, 1,000,000 characters by default.
+    long maxBatchBytes = 500000;
+
+    // How long SQLTables and SQLColumns results may be answered from the
+    // process-wide metadata cache. Zero, the default, turns the cache off,
+    // since tables created by others show up only after the TTL.
+    long metadataCacheTtlMs = 0;
+
+    // Describe the results of a query from the last time the same text ran
+    // with the same connection identity, so SQLNumResultCols and
+    // SQLDescribeCol don't wait for Trino to plan it. The description is
+    // checked once Trino sends the real columns.
+    bool resultSchemaCache = false;
+
+    // How long the complete results of a read-only query may be answered
+    // from the process-wide result cache. Zero turns the cache off. The
+    // cache holds up to resultCacheMaxBytes of results in memory, and
+    // results pushed out of memory are kept in resultCacheDir, if set.
+    long resultCacheTtlMs      = 0;
+    long resultCacheMaxBytes   = 67108864;
+    std::string resultCacheDir = "";
+
+    // How long an identity provider's OIDC discovery document is reused
+    // when its response doesn't say, in seconds. Zero fetches it again for
+    // every token.
+    long oidcDiscoveryTtlS = 60 * 60;
+};
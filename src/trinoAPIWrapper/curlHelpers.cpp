@@ -0,0 +1,52 @@
+#include "curlHelpers.hpp"
+
+#include "../util/stringTrim.hpp"
+
+
+static size_t
+curlWriteCallback(void* contents, size_t size, size_t nmemb, std::string* s) {
+  size_t totalSize = size * nmemb;
+  s->append(static_cast<char*>(contents), totalSize);
+  return totalSize;
+}
+
+static size_t
+curlHeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata) {
+  std::map<std::string, std::string>* responseHeaderData =
+      (std::map<std::string, std::string>*)userdata;
+  std::string headerData = std::string(buffer, nitems);
+  if (headerData.starts_with("HTTP/")) {
+    // The HTTP/<version> header is not a key value pair, so
+    // it gets some special logic.
+    responseHeaderData->insert({"http", headerData});
+  } else {
+    auto firstColon = headerData.find(':');
+    if (firstColon != std::string::npos) {
+      std::string key   = headerData.substr(0, firstColon);
+      std::string value = headerData.substr(firstColon + 1);
+      // The values usually end in \r\n at a minimum, so we need
+      // to trim that off.
+      trim(value);
+      responseHeaderData->insert({key, value});
+    }
+  }
+  // Return the number of bytes consumed to signal success.
+  return nitems * size;
+}
+
+void setCurlDefaults(CURL* curl,
+                     std::string* responseData,
+                     std::map<std::string, std::string>* responseHeaderData) {
+  // We always want to use SSL.
+  curl_easy_setopt(curl, CURLOPT_SSL_OPTIONS, CURLSSLOPT_NATIVE_CA);
+  // We want to save the response body in a string using a callback.
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlWriteCallback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, responseData);
+  // We want to parse response headers.
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curlHeaderCallback);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, responseHeaderData);
+  // Set a timeout on all requests
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, 10000);
+  // Enable gzip and/or deflate on responses
+  curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "gzip, deflate");
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <curl/curl.h>
+
+/*
+Apply the options every CURL handle in the driver uses: native CA
+certificates, compressed responses, the standard request timeout, and
+callbacks that collect the response body into responseData and the
+response headers into responseHeaderData.
+
+The HTTP status line is stored in responseHeaderData under the key
+"http". All other headers are stored under their names as received.
+*/
+void setCurlDefaults(CURL* curl,
+                     std::string* responseData,
+                     std::map<std::string, std::string>* responseHeaderData);
@@ -0,0 +1,277 @@
+#include "endpointSelector.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <map>
+#include <optional>
+
+#include <nlohmann/json.hpp>
+
+#include "../util/stringSplitAndTrim.hpp"
+#include "../util/writeLog.hpp"
+#include "curlHelpers.hpp"
+#include "httpTimings.hpp"
+#include "serverInfo.hpp"
+
+using json = nlohmann::json;
+
+
+// How often to check the health and latency of each endpoint.
+long long ENDPOINT_PROBE_INTERVAL_S = 10;
+// Probes are cheap, so one that takes longer than this counts as a failure.
+long ENDPOINT_PROBE_TIMEOUT_MS = 2000;
+// Weight of the newest probe in the moving average of probe latencies.
+double ENDPOINT_LATENCY_EWMA_WEIGHT = 0.3;
+
+
+static Endpoint makeEndpoint(std::string hostname, unsigned short port) {
+  Endpoint endpoint;
+  endpoint.hostname     = hostname;
+  endpoint.port         = port;
+  endpoint.baseUrl      = hostname + ":" + std::to_string(port);
+  endpoint.statementUrl = endpoint.baseUrl + "/v1/statement";
+  return endpoint;
+}
+
+std::vector<Endpoint> parseEndpointList(std::string hostname,
+                                        unsigned short port,
+                                        std::string endpointList) {
+  std::vector<Endpoint> endpoints = {makeEndpoint(hostname, port)};
+  for (std::string entry : stringSplitAndTrim(endpointList, ',')) {
+    std::string entryHostname = entry;
+    unsigned short entryPort  = port;
+
+    // A trailing ":digits" is a port, as long as it comes after the scheme.
+    // An entry with a port no server can listen on is left out.
+    size_t schemeEnd = entry.find("://");
+    size_t colon     = entry.rfind(':');
+    if (colon != std::string::npos and
+        (schemeEnd == std::string::npos or colon > schemeEnd) and
+        colon + 1 < entry.size() and
+        std::all_of(entry.begin() + colon + 1, entry.end(), [](char c) {
+          return std::isdigit(static_cast<unsigned char>(c));
+        })) {
+      const char* first   = entry.data() + colon + 1;
+      const char* last    = entry.data() + entry.size();
+      int entryPortNumber = 0;
+      auto [ptr, ec]      = std::from_chars(first, last, entryPortNumber);
+      if (ec != std::errc() or entryPortNumber < 1 or
+          entryPortNumber > 65535) {
+        WriteLog(LL_WARN,
+                 "  WARNING: Ignoring endpoint " + entry +
+                     ", its port is not between 1 and 65535");
+        continue;
+      }
+      entryHostname = entry.substr(0, colon);
+      entryPort     = static_cast<unsigned short>(entryPortNumber);
+    }
+
+    Endpoint endpoint = makeEndpoint(entryHostname, entryPort);
+    bool duplicate =
+        std::any_of(endpoints.begin(), endpoints.end(), [&](Endpoint& e) {
+          return e.baseUrl == endpoint.baseUrl;
+        });
+    if (not duplicate) {
+      endpoints.push_back(endpoint);
+    }
+  }
+  return endpoints;
+}
+
+bool isEndpointUnavailable(CURLcode curlCode, long httpStatusCode) {
+  switch (curlCode) {
+    case CURLE_COULDNT_RESOLVE_HOST:
+    case CURLE_COULDNT_CONNECT:
+    case CURLE_SSL_CONNECT_ERROR:
+      return true;
+    case CURLE_OK:
+      return httpStatusCode == 503;
+    default:
+      return false;
+  }
+}
+
+
+EndpointSelector::EndpointSelector(std::vector<Endpoint> endpoints) {
+  this->endpoints = endpoints;
+  this->states    = std::vector<EndpointState>(endpoints.size());
+}
+
+EndpointSelector::~EndpointSelector() {
+  {
+    std::lock_guard<std::mutex> lock(this->probeMutex);
+    this->probeStopping = true;
+  }
+  this->probeWake.notify_all();
+  if (this->probeThread.joinable()) {
+    this->probeThread.join();
+  }
+}
+
+size_t EndpointSelector::getEndpointCount() {
+  return this->endpoints.size();
+}
+
+const Endpoint& EndpointSelector::getEndpoint(size_t index) {
+  // The endpoint list never changes after construction, so no lock needed.
+  return this->endpoints.at(index);
+}
+
+size_t EndpointSelector::selectEndpoint(const std::set<size_t>& skip) {
+  std::lock_guard<std::mutex> lock(this->stateMutex);
+  std::optional<size_t> firstCandidate;
+  std::optional<size_t> firstHealthy;
+  std::optional<size_t> fastestHealthy;
+  for (size_t i = 0; i < this->endpoints.size(); i++) {
+    if (skip.count(i)) {
+      continue;
+    }
+    if (not firstCandidate) {
+      firstCandidate = i;
+    }
+    EndpointState& state = this->states[i];
+    if (not state.healthy) {
+      continue;
+    }
+    if (not firstHealthy) {
+      firstHealthy = i;
+    }
+    if (state.hasLatency and
+        (not fastestHealthy or
+         state.averageLatencyMs <
+             this->states[*fastestHealthy].averageLatencyMs)) {
+      fastestHealthy = i;
+    }
+  }
+  if (fastestHealthy) {
+    return *fastestHealthy;
+  }
+  if (firstHealthy) {
+    return *firstHealthy;
+  }
+  return firstCandidate.value_or(0);
+}
+
+void EndpointSelector::reportSuccess(size_t index) {
+  std::lock_guard<std::mutex> lock(this->stateMutex);
+  this->states.at(index).healthy = true;
+}
+
+void EndpointSelector::reportFailure(size_t index) {
+  std::lock_guard<std::mutex> lock(this->stateMutex);
+  if (this->states.at(index).healthy) {
+    WriteLog(LL_WARN,
+             "  WARNING: Trino endpoint unavailable: " +
+                 this->endpoints[index].baseUrl);
+  }
+  this->states.at(index).healthy = false;
+}
+
+void EndpointSelector::recordProbe(size_t index,
+                                   bool healthy,
+                                   double latencyMs) {
+  std::lock_guard<std::mutex> lock(this->stateMutex);
+  EndpointState& state = this->states.at(index);
+  if (state.healthy != healthy) {
+    WriteLog(LL_INFO,
+             "  Trino endpoint " + this->endpoints[index].baseUrl + " is " +
+                 (healthy ? "healthy" : "unavailable"));
+  }
+  state.healthy = healthy;
+  if (not healthy) {
+    return;
+  }
+  if (state.hasLatency) {
+    state.averageLatencyMs =
+        ENDPOINT_LATENCY_EWMA_WEIGHT * latencyMs +
+        (1 - ENDPOINT_LATENCY_EWMA_WEIGHT) * state.averageLatencyMs;
+  } else {
+    state.averageLatencyMs = latencyMs;
+    state.hasLatency       = true;
+  }
+}
+
+void EndpointSelector::startProbing() {
+  if (this->endpoints.size() < 2 or this->probeThread.joinable()) {
+    return;
+  }
+  WriteLog(LL_DEBUG,
+           "  Probing " + std::to_string(this->endpoints.size()) +
+               " Trino endpoints");
+  this->probeThread = std::thread(&EndpointSelector::probeLoop, this);
+}
+
+void EndpointSelector::probeLoop() {
+  // The probe thread gets its own CURL handle. /v1/info doesn't need
+  // authentication, so it doesn't need a connection's headers either.
+  std::string responseData;
+  std::map<std::string, std::string> responseHeaderData;
+  CURL* curl = curl_easy_init();
+  setCurlDefaults(curl, &responseData, &responseHeaderData);
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, ENDPOINT_PROBE_TIMEOUT_MS);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, ENDPOINT_PROBE_TIMEOUT_MS);
+
+  std::unique_lock<std::mutex> lock(this->probeMutex);
+  while (not this->probeStopping) {
+    lock.unlock();
+    for (size_t i = 0; i < this->endpoints.size(); i++) {
+      responseData.clear();
+      responseHeaderData.clear();
+      std::string url = this->endpoints[i].baseUrl + "/v1/info";
+      curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+
+      CURLcode res = curl_easy_perform(curl);
+      getHttpTimings().record(curl, HttpInfo);
+      long httpStatusCode = 0;
+      curl_off_t totalUs  = 0;
+      curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpStatusCode);
+      curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &totalUs);
+
+      bool healthy = false;
+      if (res == CURLE_OK and httpStatusCode == 200) {
+        // A coordinator that is still starting can't run queries yet.
+        json info = json::parse(responseData, nullptr, false);
+        healthy = info.is_object() and not info.value("starting", false);
+
+        // Keep the version SQLGetInfo reports current across upgrades.
+        std::optional<std::string> version = parseServerVersion(responseData);
+        if (version) {
+          getServerInfoCache().putVersion(this->endpoints[i].baseUrl,
+                                          *version);
+        }
+      }
+      this->recordProbe(i, healthy, totalUs / 1000.0);
+    }
+    lock.lock();
+
+    this->probeWake.wait_for(
+        lock, std::chrono::seconds(ENDPOINT_PROBE_INTERVAL_S), [this]() {
+          return this->probeStopping;
+        });
+  }
+  curl_easy_cleanup(curl);
+}
+
+
+static std::mutex selectorRegistryMutex;
+static std::map<std::string, std::weak_ptr<EndpointSelector>>
+    selectorRegistry;
+
+std::shared_ptr<EndpointSelector>
+getEndpointSelector(std::vector<Endpoint> endpoints) {
+  std::string key;
+  for (Endpoint& endpoint : endpoints) {
+    key += endpoint.baseUrl + ",";
+  }
+
+  std::lock_guard<std::mutex> lock(selectorRegistryMutex);
+  std::shared_ptr<EndpointSelector> selector = selectorRegistry[key].lock();
+  if (not selector) {
+    selector              = std::make_shared<EndpointSelector>(endpoints);
+    selectorRegistry[key] = selector;
+    selector->startProbing();
+  }
+  return selector;
+}
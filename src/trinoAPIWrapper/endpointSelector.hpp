@@ -0,0 +1,109 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <curl/curl.h>
+
+/*
+A coordinator the driver can send queries to. The hostname includes the
+scheme, the same as the hostname connection option.
+*/
+struct Endpoint {
+    std::string hostname;
+    unsigned short port = 0;
+    // Precomputed because every request uses one of these.
+    std::string baseUrl;
+    std::string statementUrl;
+};
+
+/*
+Build the ordered endpoint list for a connection. The configured hostname
+and port always come first, followed by each comma separated entry of
+endpointList that isn't already in the list. Entries take the same form
+as the hostname option, optionally followed by ":port". Entries without
+a port use the configured port, and entries whose port is outside 1 to
+65535 are skipped with a warning.
+*/
+std::vector<Endpoint> parseEndpointList(std::string hostname,
+                                        unsigned short port,
+                                        std::string endpointList);
+
+/*
+Whether a failed query submission can safely be sent to another
+coordinator. That's only the case when the request never reached a
+coordinator (DNS, TCP, or TLS failures), or when the coordinator turned it
+away with a 503 because it is starting up or shutting down. Anything else
+may have created a query, and sending it again could run it twice.
+*/
+bool isEndpointUnavailable(CURLcode curlCode, long httpStatusCode);
+
+/*
+Chooses which coordinator new queries go to.
+
+Every endpoint is probed with a GET on /v1/info in the background, every
+ENDPOINT_PROBE_INTERVAL_S seconds. A probe succeeds if the coordinator
+answers and isn't still starting. Probe latencies are kept as an
+exponentially weighted moving average. New queries go to the healthy
+endpoint with the lowest average latency, or to the first healthy endpoint
+in list order until latencies have been measured. If no endpoint is
+healthy, list order wins.
+
+Only the query submission is routed. Each query's nextUri points at the
+coordinator that owns it, so a running query always stays there.
+
+Selectors are shared by every connection in the process with the same
+endpoint list, so the probes run once per list rather than once per
+connection. Nothing is probed when there is only one endpoint.
+*/
+class EndpointSelector {
+  public:
+    EndpointSelector(std::vector<Endpoint> endpoints);
+    ~EndpointSelector();
+
+    size_t getEndpointCount();
+    const Endpoint& getEndpoint(size_t index);
+
+    // Return the index of the best endpoint that isn't in skip. If every
+    // endpoint is in skip, the first endpoint is returned.
+    size_t selectEndpoint(const std::set<size_t>& skip = {});
+
+    // Feedback from real requests. A failure takes the endpoint out of
+    // rotation until a probe finds it healthy again.
+    void reportSuccess(size_t index);
+    void reportFailure(size_t index);
+
+    // Record the outcome of a health probe.
+    void recordProbe(size_t index, bool healthy, double latencyMs);
+
+    void startProbing();
+
+  private:
+    struct EndpointState {
+        bool healthy            = true;
+        bool hasLatency         = false;
+        double averageLatencyMs = 0;
+    };
+
+    std::vector<Endpoint> endpoints;
+    std::vector<EndpointState> states;
+    std::mutex stateMutex;
+
+    std::thread probeThread;
+    std::mutex probeMutex;
+    std::condition_variable probeWake;
+    bool probeStopping = false;
+    void probeLoop();
+};
+
+/*
+Return the selector shared by every connection using this endpoint list,
+creating it and starting its probes if this is the first.
+*/
+std::shared_ptr<EndpointSelector>
+getEndpointSelector(std::vector<Endpoint> endpoints);
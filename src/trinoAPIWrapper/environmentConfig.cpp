@@ -1,12 +1,45 @@
 #include <curl/curl.h>
 #include <iostream>
+#include <mutex>
 
+#include "authProvider/tokens/tokenRegistry.hpp"
 #include "environmentConfig.hpp"
+#include "queryReaper.hpp"
+#include "queryWatchdog.hpp"
+
+#include "../util/traceEvents.hpp"
+
+// How long to wait at shutdown for background query terminations.
+long QUERY_REAPER_DRAIN_TIMEOUT_MS = 2000;
+
+// The environments alive in the process. The background services are
+// shared by all of them, so only the last one to go shuts them down.
+static std::mutex environmentsMutex;
+static int liveEnvironments = 0;
 
 EnvironmentConfig::EnvironmentConfig() {
-  curl_global_init(CURL_GLOBAL_DEFAULT);
+  std::lock_guard<std::mutex> lock(environmentsMutex);
+  if (liveEnvironments++ == 0) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+  }
 }
 
 EnvironmentConfig::~EnvironmentConfig() {
+  // Held throughout, so a new environment can't start using the services
+  // while they are being shut down.
+  std::lock_guard<std::mutex> lock(environmentsMutex);
+  if (--liveEnvironments > 0) {
+    return;
+  }
+  // Token writes happen in the background. Make sure they land before
+  // the application is done with the driver.
+  flushTokenRegistry();
+  // No statement is left to time out.
+  stopQueryWatchdog();
+  // Give queries closed just before shutdown a chance to be terminated,
+  // without holding up the application for long if Trino is unreachable.
+  drainQueryReaper(QUERY_REAPER_DRAIN_TIMEOUT_MS);
+  // Write out the spans recorded so far and close the trace file.
+  stopTracing();
   curl_global_cleanup();
 }
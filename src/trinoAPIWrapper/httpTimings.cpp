@@ -0,0 +1,206 @@
+#include "httpTimings.hpp"
+
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+#include "../util/writeLog.hpp"
+
+
+using json = nlohmann::json;
+
+// How often a summary of the timings is logged while requests are sent.
+int HTTP_TIMINGS_LOG_INTERVAL_MS = 60000;
+
+
+static const char* requestKindName(HttpRequestKind kind) {
+  switch (kind) {
+    case HttpSubmit:
+      return "submit";
+    case HttpPagePoll:
+      return "poll";
+    case HttpCancel:
+      return "cancel";
+    case HttpAuth:
+      return "auth";
+    case HttpInfo:
+      return "info";
+  }
+  return "unknown";
+}
+
+static uint64_t nonNegative(curl_off_t value) {
+  return value > 0 ? static_cast<uint64_t>(value) : 0;
+}
+
+static json histogramToJson(const LatencyHistogram& histogram) {
+  return {{"count", histogram.count()},
+          {"min", histogram.min()},
+          {"mean", histogram.mean()},
+          {"p50", histogram.percentile(50)},
+          {"p90", histogram.percentile(90)},
+          {"p99", histogram.percentile(99)},
+          {"p999", histogram.percentile(99.9)},
+          {"max", histogram.max()}};
+}
+
+static void summarizePhase(std::ostringstream& oss,
+                           const char* name,
+                           const LatencyHistogram& histogram) {
+  if (histogram.count() == 0) {
+    return;
+  }
+  oss << " " << name << "=" << histogram.percentile(50) << "/"
+      << histogram.percentile(99);
+}
+
+void HttpTimingRegistry::record(CURL* curl, HttpRequestKind kind) {
+  /*
+  libcurl reports each phase as the time from the start of the request
+  to its end, so the phases are the differences. On a reused connection
+  the connection phases end right away.
+  */
+  char* url                  = nullptr;
+  long connects              = 0;
+  curl_off_t nameLookupUs    = 0;
+  curl_off_t connectUs       = 0;
+  curl_off_t appConnectUs    = 0;
+  curl_off_t preTransferUs   = 0;
+  curl_off_t startTransferUs = 0;
+  curl_off_t totalUs         = 0;
+  curl_off_t uploadBytes     = 0;
+  curl_off_t downloadBytes   = 0;
+  curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &url);
+  curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &connects);
+  curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &nameLookupUs);
+  curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connectUs);
+  curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &appConnectUs);
+  curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME_T, &preTransferUs);
+  curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &startTransferUs);
+  curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &totalUs);
+  curl_easy_getinfo(curl, CURLINFO_SIZE_UPLOAD_T, &uploadBytes);
+  curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &downloadBytes);
+  if (url == nullptr) {
+    return;
+  }
+
+  HttpRequestTiming timing;
+  timing.newConnection = connects > 0;
+  timing.dnsUs         = nonNegative(nameLookupUs);
+  timing.connectUs     = nonNegative(connectUs - nameLookupUs);
+  // Zero for plain HTTP.
+  timing.tlsUs = appConnectUs > 0 ? nonNegative(appConnectUs - connectUs) : 0;
+  // A request that failed before the response started has no response
+  // phases to speak of.
+  if (startTransferUs > 0) {
+    timing.firstByteUs = nonNegative(startTransferUs - preTransferUs);
+    timing.transferUs  = nonNegative(totalUs - startTransferUs);
+  }
+  timing.totalUs       = nonNegative(totalUs);
+  timing.bytesSent     = nonNegative(uploadBytes);
+  timing.bytesReceived = nonNegative(downloadBytes);
+  this->record(httpEndpointOf(url), kind, timing);
+}
+
+void HttpTimingRegistry::record(const std::string& endpoint,
+                                HttpRequestKind kind,
+                                const HttpRequestTiming& timing) {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    HttpTimings& timings = this->timings[{endpoint, kind}];
+    timings.requests++;
+    if (timing.newConnection) {
+      timings.newConnections++;
+      timings.dnsUs.record(timing.dnsUs);
+      timings.connectUs.record(timing.connectUs);
+      if (timing.tlsUs > 0) {
+        timings.tlsUs.record(timing.tlsUs);
+      }
+    }
+    if (timing.firstByteUs > 0 or timing.transferUs > 0) {
+      timings.firstByteUs.record(timing.firstByteUs);
+      timings.transferUs.record(timing.transferUs);
+    }
+    timings.totalUs.record(timing.totalUs);
+    timings.bytesSent.record(timing.bytesSent);
+    timings.bytesReceived.record(timing.bytesReceived);
+  }
+  this->logSummaryIfDue();
+}
+
+std::string HttpTimingRegistry::toJson() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  json result = json::object();
+  for (const auto& [key, timings] : this->timings) {
+    result[key.first][requestKindName(key.second)] = {
+        {"requests", timings.requests},
+        {"newConnections", timings.newConnections},
+        {"dnsUs", histogramToJson(timings.dnsUs)},
+        {"connectUs", histogramToJson(timings.connectUs)},
+        {"tlsUs", histogramToJson(timings.tlsUs)},
+        {"firstByteUs", histogramToJson(timings.firstByteUs)},
+        {"transferUs", histogramToJson(timings.transferUs)},
+        {"totalUs", histogramToJson(timings.totalUs)},
+        {"bytesSent", histogramToJson(timings.bytesSent)},
+        {"bytesReceived", histogramToJson(timings.bytesReceived)}};
+  }
+  return result.dump();
+}
+
+std::string HttpTimingRegistry::summary() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  std::ostringstream oss;
+  for (const auto& [key, timings] : this->timings) {
+    oss << "  " << key.first << " " << requestKindName(key.second) << ": "
+        << timings.requests << " requests, " << timings.newConnections
+        << " connections, p50/p99 us";
+    summarizePhase(oss, "dns", timings.dnsUs);
+    summarizePhase(oss, "connect", timings.connectUs);
+    summarizePhase(oss, "tls", timings.tlsUs);
+    summarizePhase(oss, "firstByte", timings.firstByteUs);
+    summarizePhase(oss, "transfer", timings.transferUs);
+    summarizePhase(oss, "total", timings.totalUs);
+    oss << ", p50/p99 bytes";
+    summarizePhase(oss, "received", timings.bytesReceived);
+    oss << "\n";
+  }
+  return oss.str();
+}
+
+void HttpTimingRegistry::clear() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->timings.clear();
+}
+
+void HttpTimingRegistry::logSummaryIfDue() {
+  if (getLogLevel() > LL_DEBUG) {
+    return;
+  }
+  long long nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count();
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // The first interval starts with the first request.
+    if (this->lastLoggedMs == 0) {
+      this->lastLoggedMs = nowMs;
+    }
+    if (nowMs - this->lastLoggedMs < HTTP_TIMINGS_LOG_INTERVAL_MS) {
+      return;
+    }
+    this->lastLoggedMs = nowMs;
+  }
+  WriteLog(LL_DEBUG, "  HTTP timings by endpoint:\n" + this->summary());
+}
+
+HttpTimingRegistry& getHttpTimings() {
+  static HttpTimingRegistry httpTimings;
+  return httpTimings;
+}
+
+std::string httpEndpointOf(const std::string& url) {
+  size_t schemeEnd = url.find("://");
+  size_t hostStart = schemeEnd == std::string::npos ? 0 : schemeEnd + 3;
+  size_t pathStart = url.find_first_of("/?#", hostStart);
+  return url.substr(0, pathStart);
+}
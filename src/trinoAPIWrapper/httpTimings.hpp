@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <curl/curl.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "../util/latencyHistogram.hpp"
+
+// What a request to a server was for.
+enum HttpRequestKind {
+  HttpSubmit,
+  HttpPagePoll,
+  HttpCancel,
+  HttpAuth,
+  HttpInfo,
+};
+
+/*
+Where the time of every HTTP request the driver sends goes, from libcurl's
+own timings, kept per endpoint and kind of request for the whole
+process. They answer whether slow fetches come from setting up
+connections, from the coordinator taking its time to answer, or from
+the size of the responses.
+
+Each request is split into its phases: resolving the host, the TCP
+connect, the TLS handshake, the wait for the first byte of the response
+after the request was sent, and reading the rest of it. Requests that
+reuse a connection skip the first three, so those are recorded only for
+requests that opened one.
+
+Applications read them as JSON with SQLGetConnectAttr and
+SQL_ATTR_HTTP_TIMINGS. With debug logging on, a summary is logged every
+HTTP_TIMINGS_LOG_INTERVAL_MS while requests are being sent.
+*/
+extern int HTTP_TIMINGS_LOG_INTERVAL_MS;
+
+// The phases of one request. Times are in microseconds.
+struct HttpRequestTiming {
+    bool newConnection     = false;
+    uint64_t dnsUs         = 0;
+    uint64_t connectUs     = 0;
+    uint64_t tlsUs         = 0;
+    uint64_t firstByteUs   = 0;
+    uint64_t transferUs    = 0;
+    uint64_t totalUs       = 0;
+    uint64_t bytesSent     = 0;
+    uint64_t bytesReceived = 0;
+};
+
+// The phases of every request to one endpoint of one kind.
+struct HttpTimings {
+    uint64_t requests       = 0;
+    uint64_t newConnections = 0;
+    LatencyHistogram dnsUs;
+    LatencyHistogram connectUs;
+    LatencyHistogram tlsUs;
+    LatencyHistogram firstByteUs;
+    LatencyHistogram transferUs;
+    LatencyHistogram totalUs;
+    LatencyHistogram bytesSent;
+    LatencyHistogram bytesReceived;
+};
+
+class HttpTimingRegistry {
+  public:
+    // Record the request curl just finished.
+    void record(CURL* curl, HttpRequestKind kind);
+    void record(const std::string& endpoint,
+                HttpRequestKind kind,
+                const HttpRequestTiming& timing);
+    /*
+    Everything recorded so far, as
+
+    {"https://trino:443": {"poll": {"requests": 12, "newConnections": 1,
+      "firstByteUs": {"count": 12, "p50": ..., "p90": ..., "p99": ...,
+      "max": ...}, ...}}}
+    */
+    std::string toJson();
+    // One line per endpoint and kind of request, with the median and
+    // 99th percentile of each phase.
+    std::string summary();
+    void clear();
+
+  private:
+    std::mutex mutex;
+    std::map<std::pair<std::string, HttpRequestKind>, HttpTimings> timings;
+    long long lastLoggedMs = 0;
+
+    void logSummaryIfDue();
+};
+
+// The timings shared by every connection in the process.
+HttpTimingRegistry& getHttpTimings();
+
+// The scheme, host and port of a URL, which the timings are kept by.
+std::string httpEndpointOf(const std::string& url);
@@ -0,0 +1,64 @@
+#include "metadataCache.hpp"
+
+#include <algorithm>
+
+#include "../util/writeLog.hpp"
+
+
+MetadataCache::MetadataCache(size_t maxEntries) {
+  this->maxEntries = maxEntries > 0 ? maxEntries : 1;
+}
+
+std::optional<json> MetadataCache::get(const std::string& key, long ttlMs) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto found = this->entries.find(key);
+  if (found == this->entries.end()) {
+    return std::nullopt;
+  }
+  auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - found->second.storedAt);
+  if (age.count() > ttlMs) {
+    return std::nullopt;
+  }
+  return found->second.response;
+}
+
+void MetadataCache::put(const std::string& key, const json& response) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  Entry entry;
+  entry.storedAt     = std::chrono::steady_clock::now();
+  entry.response     = response;
+  this->entries[key] = entry;
+  while (this->entries.size() > this->maxEntries) {
+    auto oldest = std::min_element(
+        this->entries.begin(),
+        this->entries.end(),
+        [](const auto& a, const auto& b) {
+          return a.second.storedAt < b.second.storedAt;
+        });
+    this->entries.erase(oldest);
+  }
+}
+
+void MetadataCache::invalidate(const std::string& prefix) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto it          = this->entries.lower_bound(prefix);
+  size_t forgotten = 0;
+  while (it != this->entries.end() and
+         it->first.compare(0, prefix.size(), prefix) == 0) {
+    it = this->entries.erase(it);
+    forgotten++;
+  }
+  WriteLog(LL_DEBUG,
+           "  Forgot " + std::to_string(forgotten) + " metadata results");
+}
+
+size_t MetadataCache::size() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->entries.size();
+}
+
+MetadataCache& getMetadataCache() {
+  static MetadataCache metadataCache;
+  return metadataCache;
+}
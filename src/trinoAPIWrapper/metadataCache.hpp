@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+
+using json = nlohmann::json;
+
+/*
+Results of catalog metadata queries, shared by every connection in the
+process.
+
+BI tools building a navigator call SQLTables and SQLColumns once per
+table, and every one of those is a query against system.jdbc that takes
+seconds. Answering the repeats from memory turns minutes of waiting into
+seconds.
+
+Results are stored whole, in the shape sideloadResponse takes, under a
+key that starts with the identity of the connection that fetched them.
+Connections to the same endpoint as the same user share entries. Each
+lookup says how old an entry it is willing to accept, since that comes
+from the asking connection's options.
+
+The cache holds at most maxEntries results. Storing one more drops the
+oldest.
+*/
+class MetadataCache {
+  public:
+    MetadataCache(size_t maxEntries = 1024);
+
+    // The stored result, if there is one no older than ttlMs.
+    std::optional<json> get(const std::string& key, long ttlMs);
+    void put(const std::string& key, const json& response);
+    // Forget every result whose key starts with prefix.
+    void invalidate(const std::string& prefix);
+    size_t size();
+
+  private:
+    struct Entry {
+        std::chrono::steady_clock::time_point storedAt;
+        json response;
+    };
+
+    std::mutex mutex;
+    size_t maxEntries;
+    std::map<std::string, Entry> entries;
+};
+
+// The cache shared by every connection in the process.
+MetadataCache& getMetadataCache();
@@ -0,0 +1,121 @@
+#include "preparedStatementCache.hpp"
+
+#include "../util/writeLog.hpp"
+
+
+PreparedStatementCache::PreparedStatementCache(size_t capacity) {
+  // A connection always needs room for the statement it is executing.
+  this->capacity = capacity > 0 ? capacity : 1;
+}
+
+void PreparedStatementCache::setCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->capacity = capacity > 0 ? capacity : 1;
+  this->evictOverCapacity();
+}
+
+std::string PreparedStatementCache::newName() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return "odbc_statement_" + std::to_string(this->nextNameId++);
+}
+
+std::optional<std::string>
+PreparedStatementCache::findName(const std::string& sql) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto found = this->namesBySql.find(sql);
+  if (found == this->namesBySql.end()) {
+    return std::nullopt;
+  }
+  this->touch(this->entriesByName.at(found->second));
+  return found->second;
+}
+
+std::string PreparedStatementCache::getHeader(const std::string& name) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto found = this->entriesByName.find(name);
+  if (found == this->entriesByName.end()) {
+    return "";
+  }
+  this->touch(found->second);
+  return found->second.header;
+}
+
+bool PreparedStatementCache::add(const std::string& sql,
+                                 const std::string& addedPrepare) {
+  // The header is "name=text", with the text URL encoded. It goes back to
+  // Trino as is, so only the name needs to be picked out of it.
+  size_t separator = addedPrepare.find('=');
+  if (separator == std::string::npos or separator == 0) {
+    WriteLog(LL_ERROR,
+             "  ERROR: Could not parse X-Trino-Added-Prepare: " +
+                 addedPrepare);
+    return false;
+  }
+  std::string name = addedPrepare.substr(0, separator);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto existing = this->entriesByName.find(name);
+  if (existing != this->entriesByName.end()) {
+    this->namesBySql.erase(existing->second.sql);
+    this->recency.erase(existing->second.recency);
+    this->entriesByName.erase(existing);
+  }
+  auto existingSql = this->namesBySql.find(sql);
+  if (existingSql != this->namesBySql.end()) {
+    Entry& replaced = this->entriesByName.at(existingSql->second);
+    this->recency.erase(replaced.recency);
+    this->entriesByName.erase(existingSql->second);
+    this->namesBySql.erase(existingSql);
+  }
+
+  this->recency.push_front(name);
+  Entry entry;
+  entry.sql                 = sql;
+  entry.header              = addedPrepare;
+  entry.recency             = this->recency.begin();
+  this->entriesByName[name] = entry;
+  this->namesBySql[sql]     = name;
+  this->evictOverCapacity();
+  return true;
+}
+
+void PreparedStatementCache::setDescription(const std::string& name,
+                                            const std::string& kind,
+                                            const json& description) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto found = this->entriesByName.find(name);
+  if (found != this->entriesByName.end()) {
+    found->second.descriptions[kind] = description;
+  }
+}
+
+std::optional<json>
+PreparedStatementCache::getDescription(const std::string& name,
+                                       const std::string& kind) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto found = this->entriesByName.find(name);
+  if (found == this->entriesByName.end() or
+      not found->second.descriptions.contains(kind)) {
+    return std::nullopt;
+  }
+  return found->second.descriptions.at(kind);
+}
+
+size_t PreparedStatementCache::size() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->entriesByName.size();
+}
+
+void PreparedStatementCache::touch(Entry& entry) {
+  this->recency.splice(this->recency.begin(), this->recency, entry.recency);
+}
+
+void PreparedStatementCache::evictOverCapacity() {
+  while (this->entriesByName.size() > this->capacity) {
+    std::string name = this->recency.back();
+    this->recency.pop_back();
+    WriteLog(LL_DEBUG, "  Forgetting prepared statement " + name);
+    this->namesBySql.erase(this->entriesByName.at(name).sql);
+    this->entriesByName.erase(name);
+  }
+}
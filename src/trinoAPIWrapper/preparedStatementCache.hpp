@@ -0,0 +1,73 @@
+#pragma once
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+
+using json = nlohmann::json;
+
+/*
+The prepared statements one connection has registered with Trino.
+
+Trino doesn't keep prepared statements on the server. A PREPARE query
+answers with an X-Trino-Added-Prepare header holding the statement's name
+and its URL encoded text, and the client sends that back in an
+X-Trino-Prepared-Statement header with every query that executes it. This
+cache holds those header values, so preparing the same text again on the
+connection is free, and so EXECUTE only needs to carry the one statement
+it refers to.
+
+Whatever DESCRIBE OUTPUT and DESCRIBE INPUT said about a statement is kept
+with it, since it can't change while the statement is registered.
+
+Statements are looked up both by their text and by their name. When the
+cache is full, registering one more forgets the least recently used.
+Forgetting is all it takes to deallocate a statement, since Trino only
+knows about it while the client keeps sending it.
+*/
+class PreparedStatementCache {
+  public:
+    PreparedStatementCache(size_t capacity = 64);
+
+    void setCapacity(size_t capacity);
+    // Make up a name no other statement on this connection has used.
+    std::string newName();
+    // The name the text is registered under, if it still is.
+    std::optional<std::string> findName(const std::string& sql);
+    // The X-Trino-Prepared-Statement value for a statement, or an empty
+    // string if it was forgotten.
+    std::string getHeader(const std::string& name);
+    // Remember a statement from the X-Trino-Added-Prepare value Trino sent
+    // back for it. Returns false if the value can't be understood.
+    bool add(const std::string& sql, const std::string& addedPrepare);
+    // Remember what a DESCRIBE of the given kind ("OUTPUT" or "INPUT")
+    // returned for a statement, and look it up again.
+    void setDescription(const std::string& name,
+                        const std::string& kind,
+                        const json& description);
+    std::optional<json> getDescription(const std::string& name,
+                                       const std::string& kind);
+    size_t size();
+
+  private:
+    struct Entry {
+        std::string sql;
+        std::string header;
+        std::list<std::string>::iterator recency;
+        std::map<std::string, json> descriptions;
+    };
+
+    std::mutex mutex;
+    size_t capacity;
+    unsigned long long nextNameId = 1;
+    std::map<std::string, Entry> entriesByName;
+    std::map<std::string, std::string> namesBySql;
+    // Most recently used first.
+    std::list<std::string> recency;
+
+    void touch(Entry& entry);
+    void evictOverCapacity();
+};
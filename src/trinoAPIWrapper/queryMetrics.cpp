@@ -0,0 +1,57 @@
+#include "queryMetrics.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+
+MetricsTimer::MetricsTimer(uint64_t& counter) : counter(counter) {
+  this->start = std::chrono::steady_clock::now();
+}
+
+MetricsTimer::~MetricsTimer() {
+  auto elapsed = std::chrono::steady_clock::now() - this->start;
+  this->counter +=
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void addQueryMetrics(QueryMetrics& metrics, const QueryMetrics& other) {
+  metrics.httpRequests += other.httpRequests;
+  metrics.bytesReceived += other.bytesReceived;
+  metrics.bytesDecompressed += other.bytesDecompressed;
+  metrics.pages += other.pages;
+  metrics.networkUs += other.networkUs;
+  metrics.decodeUs += other.decodeUs;
+  metrics.conversionUs += other.conversionUs;
+  metrics.waitUs += other.waitUs;
+  metrics.admissionWaitUs += other.admissionWaitUs;
+  metrics.rowsReceived += other.rowsReceived;
+  metrics.peakBufferedRows =
+      std::max(metrics.peakBufferedRows, other.peakBufferedRows);
+  metrics.peakBufferedBytes =
+      std::max(metrics.peakBufferedBytes, other.peakBufferedBytes);
+  metrics.authRefreshes += other.authRefreshes;
+}
+
+static std::string milliseconds(uint64_t microseconds) {
+  std::ostringstream oss;
+  oss << microseconds / 1000 << "." << (microseconds % 1000) / 100 << " ms";
+  return oss.str();
+}
+
+std::string queryMetricsSummary(const QueryMetrics& metrics) {
+  std::ostringstream oss;
+  oss << "requests=" << metrics.httpRequests
+      << " pages=" << metrics.pages
+      << " rows=" << metrics.rowsReceived
+      << " bytes=" << metrics.bytesReceived
+      << " decompressed=" << metrics.bytesDecompressed
+      << " network=" << milliseconds(metrics.networkUs)
+      << " decode=" << milliseconds(metrics.decodeUs)
+      << " conversion=" << milliseconds(metrics.conversionUs)
+      << " wait=" << milliseconds(metrics.waitUs)
+      << " admission=" << milliseconds(metrics.admissionWaitUs)
+      << " peakRows=" << metrics.peakBufferedRows
+      << " peakBytes=" << metrics.peakBufferedBytes
+      << " authRefreshes=" << metrics.authRefreshes;
+  return oss.str();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*
+Counters for where the time and memory of one statement went, so a slow
+query can be pinned on Trino, the network, or the driver. They cover
+the statement's current execution, which is every query an array of
+parameters took, and start over when its cursor is closed.
+
+Applications read them with SQLGetStmtAttr and
+SQL_ATTR_QUERY_METRICS. Every field is a fixed width integer so the
+layout is the same for every compiler. Times are in microseconds.
+*/
+struct QueryMetrics {
+    // Requests sent to Trino, and the bytes of their response bodies as
+    // they came over the wire and after decompression.
+    uint64_t httpRequests      = 0;
+    uint64_t bytesReceived     = 0;
+    uint64_t bytesDecompressed = 0;
+    // Responses that carried rows.
+    uint64_t pages = 0;
+
+    // Time spent waiting on requests to Trino, parsing their JSON, and
+    // converting values into application buffers.
+    uint64_t networkUs    = 0;
+    uint64_t decodeUs     = 0;
+    uint64_t conversionUs = 0;
+    // Time spent sleeping between polls and before retries, and waiting
+    // for a client side query slot.
+    uint64_t waitUs          = 0;
+    uint64_t admissionWaitUs = 0;
+
+    // Rows received from Trino, and the most rows and approximate bytes
+    // held in memory at once while the application read them.
+    uint64_t rowsReceived      = 0;
+    uint64_t peakBufferedRows  = 0;
+    uint64_t peakBufferedBytes = 0;
+
+    // Times the connection had to get new credentials before a request.
+    uint64_t authRefreshes = 0;
+};
+
+/*
+Adds the time between its construction and destruction to a counter.
+
+void function(QueryMetrics& metrics) {
+  MetricsTimer timer(metrics.decodeUs);
+  ...
+}
+*/
+class MetricsTimer {
+  public:
+    MetricsTimer(uint64_t& counter);
+    ~MetricsTimer();
+    MetricsTimer(const MetricsTimer&)            = delete;
+    MetricsTimer& operator=(const MetricsTimer&) = delete;
+
+  private:
+    uint64_t& counter;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Add the counters of other to metrics. The peaks keep the larger value.
+void addQueryMetrics(QueryMetrics& metrics, const QueryMetrics& other);
+
+// The counters as a single line for the log.
+std::string queryMetricsSummary(const QueryMetrics& metrics);
@@ -0,0 +1,203 @@
+#include "queryReaper.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+
+#include <curl/curl.h>
+
+#include "../util/writeLog.hpp"
+#include "curlHelpers.hpp"
+#include "httpTimings.hpp"
+
+
+// How long a single DELETE may take before the reaper gives up on it.
+long QUERY_REAPER_REQUEST_TIMEOUT_MS = 10000;
+// How long the reaper waits on the network, while DELETEs are in flight,
+// before checking for new work.
+int QUERY_REAPER_POLL_MS = 1000;
+
+
+struct ReapRequest {
+    std::string nextUri;
+    std::map<std::string, std::string> headers;
+};
+
+// A DELETE in flight on the multi handle, along with everything curl
+// points into while it runs.
+struct ReapTransfer {
+    CURL* curl                 = nullptr;
+    struct curl_slist* headers = nullptr;
+    std::string nextUri;
+    std::string responseData;
+    std::map<std::string, std::string> responseHeaderData;
+};
+
+static std::mutex reaperMutex;
+static std::condition_variable reaperIdle;
+// Wakes the reaper when it has nothing in flight, so an idle reaper
+// doesn't wake up at all.
+static std::condition_variable reaperWake;
+static std::deque<ReapRequest> reaperQueue;
+// Never destroyed. If the process exits without freeing its environment,
+// a static std::thread would still be joinable when destroyed, which
+// calls std::terminate.
+static std::thread* reaperThread = nullptr;
+static CURLM* reaperMulti  = nullptr;
+static bool reaperRunning  = false;
+static bool reaperStopping = false;
+static int reaperInFlight  = 0;
+
+
+static void startTransfer(CURLM* multi,
+                          std::list<ReapTransfer>& transfers,
+                          ReapRequest& request) {
+  transfers.emplace_back();
+  ReapTransfer& transfer = transfers.back();
+  transfer.nextUri       = request.nextUri;
+  transfer.curl          = curl_easy_init();
+  setCurlDefaults(
+      transfer.curl, &transfer.responseData, &transfer.responseHeaderData);
+  for (auto& pair : request.headers) {
+    std::string header = pair.first + ": " + pair.second;
+    transfer.headers   = curl_slist_append(transfer.headers, header.c_str());
+  }
+  curl_easy_setopt(transfer.curl, CURLOPT_HTTPHEADER, transfer.headers);
+  curl_easy_setopt(transfer.curl, CURLOPT_URL, transfer.nextUri.c_str());
+  curl_easy_setopt(transfer.curl, CURLOPT_CUSTOMREQUEST, "DELETE");
+  curl_easy_setopt(
+      transfer.curl, CURLOPT_TIMEOUT_MS, QUERY_REAPER_REQUEST_TIMEOUT_MS);
+  curl_easy_setopt(transfer.curl, CURLOPT_PRIVATE, &transfer);
+  curl_multi_add_handle(multi, transfer.curl);
+}
+
+static void finishTransfer(CURLM* multi,
+                           std::list<ReapTransfer>& transfers,
+                           ReapTransfer* transfer,
+                           CURLcode result) {
+  getHttpTimings().record(transfer->curl, HttpCancel);
+  long httpStatusCode = 0;
+  curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &httpStatusCode);
+  if (result != CURLE_OK) {
+    WriteLog(LL_WARN,
+             "  WARNING: Background query termination failed for " +
+                 transfer->nextUri + ": " + curl_easy_strerror(result));
+  } else if (httpStatusCode >= 400) {
+    WriteLog(LL_WARN,
+             "  WARNING: Background query termination for " +
+                 transfer->nextUri + " returned HTTP status " +
+                 std::to_string(httpStatusCode));
+  } else {
+    WriteLog(LL_DEBUG, "  Query terminated in the background");
+  }
+  curl_multi_remove_handle(multi, transfer->curl);
+  curl_easy_cleanup(transfer->curl);
+  curl_slist_free_all(transfer->headers);
+  transfers.remove_if([&](ReapTransfer& t) { return &t == transfer; });
+}
+
+static void reaperLoop(CURLM* multi) {
+  std::list<ReapTransfer> transfers;
+  std::unique_lock<std::mutex> lock(reaperMutex);
+  while (not reaperStopping) {
+    if (transfers.empty()) {
+      reaperWake.wait(lock, []() {
+        return reaperStopping or not reaperQueue.empty();
+      });
+      if (reaperStopping) {
+        break;
+      }
+    }
+    while (not reaperQueue.empty()) {
+      startTransfer(multi, transfers, reaperQueue.front());
+      reaperQueue.pop_front();
+    }
+    reaperInFlight = static_cast<int>(transfers.size());
+    lock.unlock();
+
+    int stillRunning = 0;
+    curl_multi_perform(multi, &stillRunning);
+    CURLMsg* message;
+    int messagesLeft;
+    while ((message = curl_multi_info_read(multi, &messagesLeft))) {
+      if (message->msg == CURLMSG_DONE) {
+        ReapTransfer* transfer;
+        curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &transfer);
+        finishTransfer(multi, transfers, transfer, message->data.result);
+      }
+    }
+    // reapQuery wakes this up when there is new work.
+    if (not transfers.empty()) {
+      curl_multi_poll(multi, nullptr, 0, QUERY_REAPER_POLL_MS, nullptr);
+    }
+
+    lock.lock();
+    reaperInFlight = static_cast<int>(transfers.size());
+    if (reaperInFlight == 0 and reaperQueue.empty()) {
+      reaperIdle.notify_all();
+    }
+  }
+  lock.unlock();
+
+  // Whatever is left when the reaper is stopped gets abandoned.
+  for (ReapTransfer& transfer : transfers) {
+    WriteLog(LL_WARN,
+             "  WARNING: Abandoning background termination of " +
+                 transfer.nextUri);
+    curl_multi_remove_handle(multi, transfer.curl);
+    curl_easy_cleanup(transfer.curl);
+    curl_slist_free_all(transfer.headers);
+  }
+}
+
+void reapQuery(std::string nextUri,
+               std::map<std::string, std::string> headers) {
+  std::lock_guard<std::mutex> lock(reaperMutex);
+  ReapRequest request;
+  request.nextUri = nextUri;
+  request.headers = headers;
+  reaperQueue.push_back(request);
+  if (not reaperRunning) {
+    reaperMulti    = curl_multi_init();
+    reaperStopping = false;
+    reaperRunning  = true;
+    reaperThread   = new std::thread(reaperLoop, reaperMulti);
+  } else {
+    reaperWake.notify_one();
+    curl_multi_wakeup(reaperMulti);
+  }
+}
+
+void drainQueryReaper(long timeoutMs) {
+  std::unique_lock<std::mutex> lock(reaperMutex);
+  if (not reaperRunning or reaperStopping) {
+    return;
+  }
+  bool drained = reaperIdle.wait_for(
+      lock, std::chrono::milliseconds(timeoutMs), []() {
+        return reaperQueue.empty() and reaperInFlight == 0;
+      });
+  if (not drained) {
+    WriteLog(LL_WARN,
+             "  WARNING: Timed out waiting for background query "
+             "terminations to finish");
+  }
+  reaperStopping = true;
+  reaperWake.notify_one();
+  curl_multi_wakeup(reaperMulti);
+  lock.unlock();
+
+  reaperThread->join();
+  delete reaperThread;
+  reaperThread = nullptr;
+
+  lock.lock();
+  curl_multi_cleanup(reaperMulti);
+  reaperMulti   = nullptr;
+  reaperRunning = false;
+  // Requests queued after the drain started never got a transfer.
+  reaperQueue.clear();
+}
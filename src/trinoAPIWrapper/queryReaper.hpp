@@ -0,0 +1,30 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+/*
+A process-wide background reaper for queries the application is done
+with.
+
+Terminating a query means sending a DELETE to its nextUri. Doing that
+synchronously makes closing a statement cost a round trip to Trino, and
+closing a connection with many open cursors costs one round trip per
+cursor. Instead, the DELETE is queued here and the caller returns right
+away. A single background thread sends every queued DELETE concurrently
+on a curl multi handle, and sleeps until the next one is queued.
+
+Termination is best effort. Failures are logged but never reported to
+the application, which has already moved on. Trino also abandons any
+query that nobody polls for a while, so a lost DELETE only delays the
+cleanup.
+*/
+
+// Queue a DELETE to nextUri. The headers are sent with the request, which
+// is how it carries the connection's authorization.
+void reapQuery(std::string nextUri, std::map<std::string, std::string> headers);
+
+// Wait up to timeoutMs for queued terminations to finish, then stop the
+// reaper thread. Anything still in flight after that is abandoned. The
+// reaper starts again if another query is queued afterwards.
+void drainQueryReaper(long timeoutMs);
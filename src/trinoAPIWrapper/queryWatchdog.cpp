@@ -0,0 +1,85 @@
+#include "queryWatchdog.hpp"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+
+struct Deadline {
+    std::chrono::steady_clock::time_point expiresAt;
+    std::function<void()> onExpired;
+};
+
+static std::mutex watchdogMutex;
+static std::condition_variable watchdogWake;
+static std::map<unsigned long long, Deadline> deadlines;
+static unsigned long long nextDeadlineId = 1;
+// Never destroyed, for the same reason as the query reaper's thread: a
+// static std::thread that is still joinable at exit calls std::terminate.
+static std::thread* watchdogThread = nullptr;
+static bool watchdogRunning        = false;
+static bool watchdogStopping       = false;
+
+
+static void watchdogLoop() {
+  std::unique_lock<std::mutex> lock(watchdogMutex);
+  while (not watchdogStopping) {
+    if (deadlines.empty()) {
+      watchdogWake.wait(lock);
+      continue;
+    }
+    auto earliest = deadlines.begin();
+    for (auto it = deadlines.begin(); it != deadlines.end(); it++) {
+      if (it->second.expiresAt < earliest->second.expiresAt) {
+        earliest = it;
+      }
+    }
+    if (earliest->second.expiresAt > std::chrono::steady_clock::now()) {
+      watchdogWake.wait_until(lock, earliest->second.expiresAt);
+      continue;
+    }
+    // The callback runs with the lock held, which is what lets
+    // cancelDeadline promise the callback is no longer running.
+    std::function<void()> onExpired = earliest->second.onExpired;
+    deadlines.erase(earliest);
+    onExpired();
+  }
+}
+
+unsigned long long
+scheduleDeadline(std::chrono::steady_clock::time_point deadline,
+                 std::function<void()> onExpired) {
+  std::lock_guard<std::mutex> lock(watchdogMutex);
+  unsigned long long id = nextDeadlineId++;
+  deadlines[id]         = Deadline{deadline, onExpired};
+  if (not watchdogRunning) {
+    watchdogStopping = false;
+    watchdogRunning  = true;
+    watchdogThread   = new std::thread(watchdogLoop);
+  }
+  watchdogWake.notify_all();
+  return id;
+}
+
+void cancelDeadline(unsigned long long id) {
+  std::lock_guard<std::mutex> lock(watchdogMutex);
+  deadlines.erase(id);
+}
+
+void stopQueryWatchdog() {
+  {
+    std::lock_guard<std::mutex> lock(watchdogMutex);
+    if (not watchdogRunning or watchdogStopping) {
+      return;
+    }
+    watchdogStopping = true;
+    deadlines.clear();
+  }
+  watchdogWake.notify_all();
+  watchdogThread->join();
+  std::lock_guard<std::mutex> lock(watchdogMutex);
+  delete watchdogThread;
+  watchdogThread  = nullptr;
+  watchdogRunning = false;
+}
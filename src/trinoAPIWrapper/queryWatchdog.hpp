@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+/*
+A process-wide timer for query deadlines.
+
+A single background thread waits for the earliest scheduled deadline and
+runs its callback when it passes. Callbacks run on the watchdog thread,
+so they must be quick and must not block on the thread that scheduled
+them. Cancelling a deadline while its callback is running waits for the
+callback to finish. After cancelDeadline returns, the callback is
+guaranteed not to be running or to run later, so it is safe to destroy
+anything it refers to.
+*/
+
+// Schedule onExpired to run once deadline passes. Returns an id for
+// cancelDeadline.
+unsigned long long
+scheduleDeadline(std::chrono::steady_clock::time_point deadline,
+                 std::function<void()> onExpired);
+
+// Forget a deadline. Ids that already fired or were never issued are
+// ignored.
+void cancelDeadline(unsigned long long id);
+
+// Stop the watchdog thread without running any remaining callbacks. It
+// starts again if another deadline is scheduled. Deadlines are shared by
+// every environment, so this is only called when the last one is freed.
+void stopQueryWatchdog();
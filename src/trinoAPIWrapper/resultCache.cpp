@@ -0,0 +1,338 @@
+#include "resultCache.hpp"
+
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include "../util/cryptUtils.hpp"
+#include "../util/fileLock.hpp"
+#include "../util/writeLog.hpp"
+
+
+using json = nlohmann::json;
+
+
+// Functions whose results differ between runs of the same statement.
+static const std::set<std::string> NONDETERMINISTIC_WORDS = {
+    "CURRENT_DATE",
+    "CURRENT_TIME",
+    "CURRENT_TIMESTAMP",
+    "LOCALTIME",
+    "LOCALTIMESTAMP",
+    "NOW",
+    "RAND",
+    "RANDOM",
+    "SHUFFLE",
+    "TABLESAMPLE",
+    "UUID",
+};
+
+static long long nowMs() {
+  // Wall clock time, since spilled entries are read by later processes.
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+static std::filesystem::path spillFilePath(const std::string& spillDir,
+                                           const std::string& key) {
+  // FNV-1a, so the name of a key's file is the same in every build. The
+  // key is stored in the file too, in case two keys share a name.
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : key) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream name;
+  name << std::hex << hash << ".cbor";
+  return std::filesystem::path(spillDir) / name.str();
+}
+
+static void writeSpilled(const std::string& spillDir,
+                         const std::string& key,
+                         const SyntheticResultSet& result,
+                         long long storedAtMs) {
+  try {
+    std::error_code ignored;
+    std::filesystem::create_directories(spillDir, ignored);
+    json entry = {{"key", key},
+                  {"storedAtMs", storedAtMs},
+                  {"columns", result.columns},
+                  {"rows", result.rows}};
+    std::vector<std::uint8_t> cbor = json::to_cbor(entry);
+    std::string contents =
+        userEncryptString(std::string(cbor.begin(), cbor.end()));
+    if (not writeFileAtomically(spillFilePath(spillDir, key).wstring(),
+                                contents)) {
+      WriteLog(LL_WARN, "  WARNING: failed to write result cache file");
+    }
+  } catch (const std::exception& e) {
+    WriteLog(LL_WARN,
+             "  WARNING: failed to spill cached results: " +
+                 std::string(e.what()));
+  }
+}
+
+static std::optional<json> readSpilled(const std::string& spillDir,
+                                       const std::string& key,
+                                       long long ttlMs,
+                                       size_t& bytes) {
+  std::filesystem::path filePath = spillFilePath(spillDir, key);
+  std::error_code ignored;
+  if (not std::filesystem::exists(filePath, ignored)) {
+    return std::nullopt;
+  }
+  try {
+    std::ifstream inputFile(filePath, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(inputFile)),
+                         std::istreambuf_iterator<char>());
+    inputFile.close();
+    std::string cbor = userDecryptString(contents);
+    bytes            = cbor.size();
+    json entry       = json::from_cbor(cbor);
+    if (entry.value("key", "") != key) {
+      return std::nullopt;
+    }
+    if (nowMs() - entry.value<long long>("storedAtMs", 0LL) < ttlMs) {
+      return entry;
+    }
+  } catch (const std::exception& e) {
+    WriteLog(LL_WARN,
+             "  WARNING: failed to read result cache file: " +
+                 std::string(e.what()));
+  }
+  // Stale or unreadable, so it's of no use to anyone.
+  std::filesystem::remove(filePath, ignored);
+  return std::nullopt;
+}
+
+ResultCache::ResultCache(long long followTimeoutMs) {
+  this->followTimeoutMs = followTimeoutMs;
+}
+
+std::shared_ptr<const SyntheticResultSet>
+ResultCache::getOrLead(const std::string& key,
+                       const ConnectionOptions& options,
+                       bool& leader,
+                       const void* owner,
+                       std::function<bool()> stopWaiting) {
+  leader = false;
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(this->followTimeoutMs);
+    auto running  = this->inFlight.find(key);
+    if (running != this->inFlight.end()) {
+      if ((owner and running->second.owner == owner) or
+          running->second.thread == std::this_thread::get_id()) {
+        WriteLog(LL_DEBUG,
+                 "  The same query is running on this connection. Running "
+                 "it separately");
+        return nullptr;
+      }
+      WriteLog(LL_DEBUG, "  Waiting for the same query on another statement");
+    }
+    while (this->inFlight.count(key)) {
+      if (stopWaiting and stopWaiting()) {
+        WriteLog(LL_DEBUG, "  Stopped waiting for the same query");
+        return nullptr;
+      }
+      if (this->filled.wait_until(lock, deadline) ==
+              std::cv_status::timeout and
+          this->inFlight.count(key)) {
+        WriteLog(LL_DEBUG,
+                 "  Gave up waiting for the same query on another "
+                 "statement. Running it separately");
+        return nullptr;
+      }
+    }
+    std::shared_ptr<const SyntheticResultSet> cached =
+        this->findFresh(key, options.resultCacheTtlMs);
+    if (cached) {
+      return cached;
+    }
+    this->inFlight[key] = Leader{owner, std::this_thread::get_id()};
+  }
+
+  // Nothing in memory, so read the results back from the spill directory
+  // if an earlier statement left them there. Other statements wait for
+  // this the same way they would for the query.
+  std::optional<json> spilled;
+  size_t spilledBytes = 0;
+  if (not options.resultCacheDir.empty()) {
+    spilled = readSpilled(
+        options.resultCacheDir, key, options.resultCacheTtlMs, spilledBytes);
+  }
+  if (not spilled) {
+    leader = true;
+    return nullptr;
+  }
+  auto result     = std::make_shared<SyntheticResultSet>();
+  result->columns = spilled->at("columns").get<std::vector<json>>();
+  result->rows    = spilled->at("rows").get<std::vector<json>>();
+  // The size of the file stands in for the size of the responses the
+  // rows came from.
+  Entry entry;
+  entry.key        = key;
+  entry.result     = result;
+  entry.storedAtMs = spilled->at("storedAtMs").get<long long>();
+  entry.bytes      = spilledBytes;
+  entry.spilled    = true;
+  this->store(entry, options);
+  return result;
+}
+
+void ResultCache::complete(const std::string& key,
+                           std::shared_ptr<const SyntheticResultSet> result,
+                           size_t bytes,
+                           const ConnectionOptions& options) {
+  Entry entry;
+  entry.key        = key;
+  entry.result     = result;
+  entry.storedAtMs = nowMs();
+  entry.bytes      = bytes;
+  entry.spilled    = false;
+  this->store(entry, options);
+}
+
+void ResultCache::abandon(const std::string& key) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->inFlight.erase(key);
+  this->filled.notify_all();
+}
+
+void ResultCache::wakeFollowers() {
+  // Taking the lock means a caller that just found stopWaiting false is
+  // already waiting, and so gets woken.
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->filled.notify_all();
+}
+
+void ResultCache::store(Entry entry, const ConnectionOptions& options) {
+  /*
+  Keep the results in memory and wake the statements waiting for them.
+  Results that don't fit push out the least recently used, which are
+  written to the spill directory after the lock is released.
+  */
+  std::vector<Entry> evicted;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->inFlight.erase(entry.key);
+    auto found = this->index.find(entry.key);
+    if (found != this->index.end()) {
+      this->totalBytes -= found->second->bytes;
+      this->entries.erase(found->second);
+      this->index.erase(found);
+    }
+    size_t maxBytes = static_cast<size_t>(options.resultCacheMaxBytes);
+    if (entry.bytes <= maxBytes) {
+      this->totalBytes += entry.bytes;
+      this->entries.push_front(entry);
+      this->index[entry.key] = this->entries.begin();
+    } else {
+      evicted.push_back(entry);
+    }
+    while (this->totalBytes > maxBytes) {
+      this->totalBytes -= this->entries.back().bytes;
+      this->index.erase(this->entries.back().key);
+      evicted.push_back(std::move(this->entries.back()));
+      this->entries.pop_back();
+    }
+    this->filled.notify_all();
+  }
+
+  if (options.resultCacheDir.empty()) {
+    return;
+  }
+  long long now = nowMs();
+  for (const Entry& dropped : evicted) {
+    if (not dropped.spilled and
+        now - dropped.storedAtMs < options.resultCacheTtlMs) {
+      writeSpilled(options.resultCacheDir,
+                   dropped.key,
+                   *dropped.result,
+                   dropped.storedAtMs);
+    }
+  }
+}
+
+std::shared_ptr<const SyntheticResultSet>
+ResultCache::findFresh(const std::string& key, long long ttlMs) {
+  auto found = this->index.find(key);
+  if (found == this->index.end()) {
+    return nullptr;
+  }
+  if (nowMs() - found->second->storedAtMs >= ttlMs) {
+    this->totalBytes -= found->second->bytes;
+    this->entries.erase(found->second);
+    this->index.erase(found);
+    return nullptr;
+  }
+  this->entries.splice(this->entries.begin(), this->entries, found->second);
+  return found->second->result;
+}
+
+size_t ResultCache::size() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->entries.size();
+}
+
+size_t ResultCache::bytes() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->totalBytes;
+}
+
+ResultCache& getResultCache() {
+  static ResultCache resultCache;
+  return resultCache;
+}
+
+bool isCacheableQuery(const std::string& sql) {
+  /*
+  Look at the words of the statement outside quotes and comments. The
+  first has to start a query, and none may be a nondeterministic
+  function, wherever it appears.
+  */
+  bool first = true;
+  size_t i   = 0;
+  while (i < sql.size()) {
+    char c = sql[i];
+    if (c == '\'' or c == '"') {
+      size_t end = sql.find(c, i + 1);
+      i          = end == std::string::npos ? sql.size() : end + 1;
+    } else if (sql.compare(i, 2, "--") == 0) {
+      size_t end = sql.find('\n', i);
+      i          = end == std::string::npos ? sql.size() : end + 1;
+    } else if (sql.compare(i, 2, "/*") == 0) {
+      size_t end = sql.find("*/", i + 2);
+      i          = end == std::string::npos ? sql.size() : end + 2;
+    } else if (std::isalpha(static_cast<unsigned char>(c)) or c == '_') {
+      std::string word;
+      while (i < sql.size() and
+             (std::isalnum(static_cast<unsigned char>(sql[i])) or
+              sql[i] == '_')) {
+        word += static_cast<char>(
+            std::toupper(static_cast<unsigned char>(sql[i])));
+        i++;
+      }
+      if (first and word != "SELECT" and word != "WITH") {
+        return false;
+      }
+      first = false;
+      if (NONDETERMINISTIC_WORDS.count(word)) {
+        return false;
+      }
+    } else {
+      i++;
+    }
+  }
+  return not first;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "connectionOptions.hpp"
+#include "syntheticResultSet.hpp"
+
+/*
+The complete results of recently run read-only queries, shared by every
+connection in the process.
+
+Dashboards send the same query from many users within seconds of each
+other. The first statement to run a query becomes its leader: it runs
+the query on Trino and fills the cache entry as its pages arrive. Any
+statement that asks for the same query in the meantime waits for the
+leader instead of running it again, and reads the leader's results when
+they are complete. If the leader fails, is canceled, or is closed before
+reading everything, one of the waiting statements takes over.
+
+Entries are keyed by the identity of the connection and the normalized
+query text, and are answered for resultCacheTtlMs after they were
+stored. The results held in memory are bounded by resultCacheMaxBytes,
+and storing more drops the least recently used. If resultCacheDir is
+set, dropped results are written there, encrypted for the current user,
+and are read back on a miss, so they outlive the process.
+
+The limits come from the connection that asks, so connections with
+different settings share one cache.
+*/
+class ResultCache {
+  public:
+    ResultCache(long long followTimeoutMs = 30000);
+
+    /*
+    The cached results for key, if any are fresh. Otherwise returns null,
+    and sets leader if the caller should run the query and then call
+    complete or abandon. A caller that isn't the leader runs the query
+    without the cache, which happens when:
+    - the leader takes longer than followTimeoutMs,
+    - the leader has the same owner, usually the connection, or runs on
+      the calling thread. Whoever waits might be the one that has to
+      fetch the leader's results for it to ever finish.
+    - stopWaiting returns true, which it is asked again whenever
+      wakeFollowers is called.
+    */
+    std::shared_ptr<const SyntheticResultSet>
+    getOrLead(const std::string& key,
+              const ConnectionOptions& options,
+              bool& leader,
+              const void* owner                = nullptr,
+              std::function<bool()> stopWaiting = nullptr);
+    void complete(const std::string& key,
+                  std::shared_ptr<const SyntheticResultSet> result,
+                  size_t bytes,
+                  const ConnectionOptions& options);
+    void abandon(const std::string& key);
+    // Wake every waiting caller to check its stopWaiting, for example
+    // after a statement was canceled.
+    void wakeFollowers();
+    size_t size();
+    size_t bytes();
+
+  private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const SyntheticResultSet> result;
+        long long storedAtMs;
+        size_t bytes;
+        // Whether the spill directory already holds these results.
+        bool spilled;
+    };
+
+    std::mutex mutex;
+    std::condition_variable filled;
+    long long followTimeoutMs;
+    // Most recently used first.
+    std::list<Entry> entries;
+    std::map<std::string, std::list<Entry>::iterator> index;
+    size_t totalBytes = 0;
+    // Queries a leader is running right now, and who runs them.
+    struct Leader {
+        const void* owner;
+        std::thread::id thread;
+    };
+    std::map<std::string, Leader> inFlight;
+
+    std::shared_ptr<const SyntheticResultSet>
+    findFresh(const std::string& key, long long ttlMs);
+    void store(Entry entry, const ConnectionOptions& options);
+};
+
+// The cache shared by every connection in the process.
+ResultCache& getResultCache();
+
+/*
+Whether the results of a statement may be cached: it reads rather than
+writes, and calls nothing whose result changes from one run to the next,
+like now() or random().
+*/
+bool isCacheableQuery(const std::string& sql);
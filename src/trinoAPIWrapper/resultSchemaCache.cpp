@@ -0,0 +1,76 @@
+#include "resultSchemaCache.hpp"
+
+#include <cctype>
+
+
+ResultSchemaCache::ResultSchemaCache(size_t maxEntries) {
+  this->maxEntries = maxEntries > 0 ? maxEntries : 1;
+}
+
+std::optional<std::vector<json>>
+ResultSchemaCache::get(const std::string& key) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto found = this->index.find(key);
+  if (found == this->index.end()) {
+    return std::nullopt;
+  }
+  this->entries.splice(this->entries.begin(), this->entries, found->second);
+  return found->second->second;
+}
+
+void ResultSchemaCache::put(const std::string& key,
+                            const std::vector<json>& columns) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto found = this->index.find(key);
+  if (found != this->index.end()) {
+    found->second->second = columns;
+    this->entries.splice(this->entries.begin(), this->entries, found->second);
+    return;
+  }
+  this->entries.emplace_front(key, columns);
+  this->index[key] = this->entries.begin();
+  while (this->entries.size() > this->maxEntries) {
+    this->index.erase(this->entries.back().first);
+    this->entries.pop_back();
+  }
+}
+
+size_t ResultSchemaCache::size() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->entries.size();
+}
+
+ResultSchemaCache& getResultSchemaCache() {
+  static ResultSchemaCache resultSchemaCache;
+  return resultSchemaCache;
+}
+
+std::string normalizeQueryText(const std::string& query) {
+  std::string normalized;
+  normalized.reserve(query.size());
+  char quote        = 0;
+  bool pendingSpace = false;
+  for (char c : query) {
+    if (quote == 0 and std::isspace(static_cast<unsigned char>(c))) {
+      pendingSpace = not normalized.empty();
+      continue;
+    }
+    if (pendingSpace) {
+      normalized += ' ';
+      pendingSpace = false;
+    }
+    if (quote == 0 and (c == '\'' or c == '"')) {
+      quote = c;
+    } else if (c == quote) {
+      // A doubled quote inside a quoted string reopens it on the next
+      // character, which comes out the same.
+      quote = 0;
+    }
+    normalized += c;
+  }
+  while (not normalized.empty() and
+         (normalized.back() == ';' or normalized.back() == ' ')) {
+    normalized.pop_back();
+  }
+  return normalized;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using json = nlohmann::json;
+
+/*
+The result columns of recently run queries, shared by every connection in
+the process.
+
+Applications call SQLNumResultCols and SQLDescribeCol right after
+executing, and those have to wait until Trino has planned the query and
+sent its columns, which can take seconds while the query is queued.
+Dashboards run the same statements on every refresh, so the columns from
+the last run let the application set up its grid while the query is
+still queued. The real columns are checked against them when they
+arrive.
+
+Entries are keyed by the identity of the connection and the normalized
+query text. The cache holds at most maxEntries, and storing one more
+drops the least recently used.
+*/
+class ResultSchemaCache {
+  public:
+    ResultSchemaCache(size_t maxEntries = 256);
+
+    std::optional<std::vector<json>> get(const std::string& key);
+    void put(const std::string& key, const std::vector<json>& columns);
+    size_t size();
+
+  private:
+    std::mutex mutex;
+    size_t maxEntries;
+    // Most recently used first.
+    std::list<std::pair<std::string, std::vector<json>>> entries;
+    std::map<std::string, decltype(entries)::iterator> index;
+};
+
+// The cache shared by every connection in the process.
+ResultSchemaCache& getResultSchemaCache();
+
+/*
+Query text with runs of whitespace outside quotes collapsed to a single
+space, and leading and trailing whitespace and semicolons removed, so
+statements that differ only in layout share an entry.
+*/
+std::string normalizeQueryText(const std::string& query);
@@ -0,0 +1,112 @@
+#include "retryPolicy.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include "../util/stringTrim.hpp"
+
+
+RetryPolicy::RetryPolicy(long long baseDelayMs,
+                         long long maxDelayMs,
+                         long long budgetMs,
+                         int maxAttempts) {
+  this->baseDelayMs         = baseDelayMs;
+  this->maxDelayMs          = maxDelayMs;
+  this->budgetMs            = budgetMs;
+  this->maxAttempts         = maxAttempts;
+  this->consecutiveFailures = 0;
+  this->budgetSpentMs       = 0;
+  this->random              = std::mt19937_64(std::random_device()());
+}
+
+long long RetryPolicy::nextDelayMs(CURLcode curlCode,
+                                   long httpStatusCode,
+                                   std::string retryAfter) {
+  bool retryable = false;
+  if (curlCode != CURLE_OK) {
+    retryable = isRetryableCurlCode(curlCode);
+  } else {
+    retryable = isRetryableHttpStatus(httpStatusCode);
+  }
+  if (not retryable or this->consecutiveFailures >= this->maxAttempts) {
+    return -1;
+  }
+
+  long long delayMs = parseRetryAfterMs(retryAfter);
+  if (delayMs < 0) {
+    // Work out the exponential bound without overflowing on long outages.
+    long long boundMs = this->baseDelayMs;
+    for (int i = 0;
+         i < this->consecutiveFailures and boundMs < this->maxDelayMs;
+         i++) {
+      boundMs *= 2;
+    }
+    boundMs = std::min(boundMs, this->maxDelayMs);
+    std::uniform_int_distribution<long long> distribution(0, boundMs);
+    delayMs = distribution(this->random);
+  }
+
+  if (this->budgetSpentMs + delayMs > this->budgetMs) {
+    return -1;
+  }
+  this->budgetSpentMs += delayMs;
+  this->consecutiveFailures++;
+  return delayMs;
+}
+
+void RetryPolicy::recordSuccess() {
+  this->consecutiveFailures = 0;
+}
+
+void RetryPolicy::reset() {
+  this->consecutiveFailures = 0;
+  this->budgetSpentMs       = 0;
+}
+
+int RetryPolicy::getConsecutiveFailures() {
+  return this->consecutiveFailures;
+}
+
+long long RetryPolicy::getBudgetSpentMs() {
+  return this->budgetSpentMs;
+}
+
+
+bool isRetryableCurlCode(CURLcode curlCode) {
+  switch (curlCode) {
+    case CURLE_COULDNT_RESOLVE_HOST:
+    case CURLE_COULDNT_CONNECT:
+    case CURLE_OPERATION_TIMEDOUT:
+    case CURLE_SSL_CONNECT_ERROR:
+    case CURLE_GOT_NOTHING:
+    case CURLE_SEND_ERROR:
+    case CURLE_RECV_ERROR:
+    case CURLE_PARTIAL_FILE:
+    case CURLE_HTTP2:
+    case CURLE_HTTP2_STREAM:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isRetryableHttpStatus(long httpStatusCode) {
+  return httpStatusCode == 429 or httpStatusCode == 502 or
+         httpStatusCode == 503 or httpStatusCode == 504;
+}
+
+long long parseRetryAfterMs(std::string retryAfter) {
+  trim(retryAfter);
+  if (retryAfter.empty() or
+      not std::all_of(retryAfter.begin(), retryAfter.end(), [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c));
+      })) {
+    return -1;
+  }
+  try {
+    return std::stoll(retryAfter) * 1000;
+  } catch (const std::out_of_range&) {
+    return -1;
+  }
+}
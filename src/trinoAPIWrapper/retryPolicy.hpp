@@ -0,0 +1,67 @@
+#pragma once
+
+#include <random>
+#include <string>
+
+#include <curl/curl.h>
+
+/*
+Decides whether, and after how long, to repeat a request that failed.
+
+This is only meant for requests that are safe to send more than once.
+In the Trino protocol that's a GET on a query's nextUri: the coordinator
+answers a repeated token with the same page, so a retry can't skip or
+duplicate rows.
+
+Delays grow exponentially from baseDelayMs up to maxDelayMs with "full
+jitter", meaning each delay is drawn uniformly between zero and the
+exponential bound. That keeps many clients that failed at the same time
+from retrying in lockstep. A Retry-After header from the server, when
+present, takes precedence.
+
+Each policy has a time budget. Once the total time spent waiting to
+retry would exceed budgetMs, it stops retrying. Consecutive failures
+are also capped at maxAttempts. A success resets the consecutive failure
+count but not the budget, so a statement that keeps limping along still
+gives up eventually. Call reset() when the statement is reused.
+*/
+class RetryPolicy {
+  public:
+    RetryPolicy(long long baseDelayMs,
+                long long maxDelayMs,
+                long long budgetMs,
+                int maxAttempts);
+
+    // Return the number of milliseconds to wait before retrying a request
+    // that finished with curlCode and httpStatusCode, or -1 if it should
+    // not be retried. retryAfter is the raw Retry-After header value, or
+    // an empty string.
+    long long nextDelayMs(CURLcode curlCode,
+                          long httpStatusCode,
+                          std::string retryAfter);
+    void recordSuccess();
+    void reset();
+    int getConsecutiveFailures();
+    long long getBudgetSpentMs();
+
+  private:
+    long long baseDelayMs;
+    long long maxDelayMs;
+    long long budgetMs;
+    int maxAttempts;
+    int consecutiveFailures;
+    long long budgetSpentMs;
+    std::mt19937_64 random;
+};
+
+// Transport errors that are likely to go away on their own: refused or
+// reset connections, timeouts, and servers that hung up mid-response.
+bool isRetryableCurlCode(CURLcode curlCode);
+
+// 429 Too Many Requests, and the 502, 503, and 504 codes proxies and load
+// balancers send while a coordinator restarts.
+bool isRetryableHttpStatus(long httpStatusCode);
+
+// Parse a Retry-After header given in delta-seconds. Returns -1 if the
+// value is missing or isn't a number of seconds (HTTP dates are ignored).
+long long parseRetryAfterMs(std::string retryAfter);
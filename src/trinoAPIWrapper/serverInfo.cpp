@@ -0,0 +1,46 @@
+#include "serverInfo.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include "../util/writeLog.hpp"
+
+using json = nlohmann::json;
+
+
+std::optional<std::string>
+ServerInfoCache::getVersion(const std::string& baseUrl) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto found = this->versions.find(baseUrl);
+  if (found == this->versions.end()) {
+    return std::nullopt;
+  }
+  return found->second;
+}
+
+void ServerInfoCache::putVersion(const std::string& baseUrl,
+                                 const std::string& version) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto found = this->versions.find(baseUrl);
+  if (found != this->versions.end() and found->second != version) {
+    WriteLog(LL_INFO,
+             "  Trino endpoint " + baseUrl + " changed version from " +
+                 found->second + " to " + version);
+  }
+  this->versions[baseUrl] = version;
+}
+
+ServerInfoCache& getServerInfoCache() {
+  static ServerInfoCache serverInfoCache;
+  return serverInfoCache;
+}
+
+std::optional<std::string> parseServerVersion(const std::string& response) {
+  json info = json::parse(response, nullptr, false);
+  if (not info.is_object() or not info.contains("nodeVersion") or
+      not info["nodeVersion"].is_object() or
+      not info["nodeVersion"].contains("version") or
+      not info["nodeVersion"]["version"].is_string()) {
+    return std::nullopt;
+  }
+  return info["nodeVersion"]["version"].get<std::string>();
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+/*
+The version of Trino each endpoint runs, shared by every connection in
+the process.
+
+SQLGetInfo(SQL_DBMS_VER) reports the server version, and applications
+ask for it over and over while connecting and whenever a dialog opens.
+Each endpoint's /v1/info is read once, when the first connection to it
+is set up, and remembered here. The endpoint probes keep it current if a
+coordinator is upgraded while the process runs.
+*/
+class ServerInfoCache {
+  public:
+    std::optional<std::string> getVersion(const std::string& baseUrl);
+    void putVersion(const std::string& baseUrl, const std::string& version);
+
+  private:
+    std::mutex mutex;
+    std::map<std::string, std::string> versions;
+};
+
+// The cache shared by every connection in the process.
+ServerInfoCache& getServerInfoCache();
+
+// The version in a /v1/info response, if it has one.
+std::optional<std::string> parseServerVersion(const std::string& response);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <vector>
+
+using json = nlohmann::json;
+
+/*
+A result set the driver answers with itself, rather than one that comes
+from running a query, like the type information from SQLGetTypeInfo.
+The columns are in the shape of the "columns" of a Trino response and
+each row is a JSON array.
+
+A TrinoQuery holds a sideloaded result set through a shared_ptr and reads
+its rows in place, so a result set that never changes can be built once
+and handed to every statement that asks for it.
+*/
+struct SyntheticResultSet {
+    std::vector<json> columns;
+    std::vector<json> rows;
+};
@@ -0,0 +1,236 @@
+#include "tlsSessionCache.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <string>
+
+#include "../util/cryptUtils.hpp"
+#include "../util/fileLock.hpp"
+#include "../util/localAppDataPath.hpp"
+#include "../util/timeUtils.hpp"
+#include "../util/writeLog.hpp"
+
+
+using json = nlohmann::json;
+
+
+int TLS_SESSION_CACHE_JSON_INDENT = 2;
+
+// Don't bother saving sessions that are about to expire. The next process
+// would most likely fail to resume them anyway.
+long long TLS_SESSION_MIN_REMAINING_S = 60;
+// How long to wait on another process updating the file. Like the token
+// cache, holders only keep the lock long enough to rewrite it.
+unsigned long TLS_SESSION_CACHE_LOCK_TIMEOUT_MS = 5000;
+
+
+static std::wstring getTlsSessionCacheFilePath() {
+  return getLocalAppDataTempFilePath(L"TrinoODBCTlsSessionCache.json");
+}
+
+static std::string getTlsSessionCacheKey(std::string hostname,
+                                         unsigned short port) {
+  return hostname + ":" + std::to_string(port);
+}
+
+static json readTlsSessionCacheFile(std::wstring filePath) {
+  if (filePath.empty() or !std::filesystem::exists(filePath)) {
+    return json(json::value_t::object);
+  }
+  std::ifstream inputFile(filePath);
+  json jsonData;
+  try {
+    inputFile >> jsonData;
+  } catch (const std::exception& e) {
+    WriteLog(LL_WARN,
+             "  WARNING: failed to parse TLS session cache file as JSON: " +
+                 std::string(e.what()));
+    jsonData = json(json::value_t::object);
+  }
+  inputFile.close();
+  if (not jsonData.is_object()) {
+    return json(json::value_t::object);
+  }
+  return jsonData;
+}
+
+std::vector<TlsSession> readTlsSessionCache(std::wstring filePath,
+                                            std::string hostname,
+                                            unsigned short port) {
+  if (filePath.empty()) {
+    return {};
+  }
+  // Read under the writers' lock, since they can't rename over the file
+  // while it is open here.
+  json jsonData;
+  {
+    FileLock lock(filePath + L".lock", TLS_SESSION_CACHE_LOCK_TIMEOUT_MS);
+    jsonData = readTlsSessionCacheFile(filePath);
+  }
+  json sessions = jsonData.value(getTlsSessionCacheKey(hostname, port),
+                                 json(json::value_t::array));
+  long long now = getSecondsSinceEpoch();
+  std::vector<TlsSession> result;
+  if (not sessions.is_array()) {
+    return result;
+  }
+
+  for (const json& session : sessions) {
+    if (not session.is_object()) {
+      continue;
+    }
+    TlsSession tlsSession;
+    tlsSession.validUntil = session.value<long long>("validUntil", 0LL);
+    if (tlsSession.validUntil > 0 and tlsSession.validUntil < now) {
+      continue;
+    }
+    try {
+      tlsSession.sessionKey =
+          userDecryptString(session.value("sessionKey", ""));
+      tlsSession.shmac = userDecryptString(session.value("encryptedShmac", ""));
+      tlsSession.sessionData =
+          userDecryptString(session.value("encryptedSessionData", ""));
+    } catch (const std::runtime_error& e) {
+      WriteLog(LL_WARN,
+               "  WARNING: failed to decrypt cached TLS session: " +
+                   std::string(e.what()));
+      continue;
+    }
+    if (tlsSession.sessionKey.empty() or tlsSession.sessionData.empty()) {
+      continue;
+    }
+    result.push_back(tlsSession);
+  }
+  return result;
+}
+
+void writeTlsSessionCache(std::wstring filePath,
+                          std::string hostname,
+                          unsigned short port,
+                          const std::vector<TlsSession>& sessions) {
+  if (filePath.empty()) {
+    return;
+  }
+  // Encrypt before taking the lock, it's the slow part.
+  json encryptedSessions = json(json::value_t::array);
+  for (const TlsSession& tlsSession : sessions) {
+    try {
+      json session = {
+          {"sessionKey", userEncryptString(tlsSession.sessionKey)},
+          {"encryptedShmac", userEncryptString(tlsSession.shmac)},
+          {"encryptedSessionData", userEncryptString(tlsSession.sessionData)},
+          {"validUntil", tlsSession.validUntil}};
+      encryptedSessions.push_back(session);
+    } catch (const std::runtime_error& e) {
+      WriteLog(LL_WARN,
+               "  WARNING: failed to encrypt TLS session for caching: " +
+                   std::string(e.what()));
+    }
+  }
+  if (encryptedSessions.empty()) {
+    return;
+  }
+
+  // Other driver processes update the same file. Hold the lock across the
+  // whole read-modify-write so none of their sessions get lost.
+  FileLock lock(filePath + L".lock", TLS_SESSION_CACHE_LOCK_TIMEOUT_MS);
+  json jsonData = readTlsSessionCacheFile(filePath);
+  jsonData[getTlsSessionCacheKey(hostname, port)] = encryptedSessions;
+  if (not writeFileAtomically(filePath,
+                              jsonData.dump(TLS_SESSION_CACHE_JSON_INDENT))) {
+    WriteLog(LL_WARN, "  WARNING: cannot write TLS session cache file");
+    return;
+  }
+  WriteLog(LL_TRACE,
+           "  Saved " + std::to_string(encryptedSessions.size()) +
+               " TLS sessions");
+}
+
+#if LIBCURL_VERSION_NUM >= 0x080c00
+
+static CURLcode collectTlsSession(CURL* handle,
+                                  void* userptr,
+                                  const char* session_key,
+                                  const unsigned char* shmac,
+                                  size_t shmac_len,
+                                  const unsigned char* sdata,
+                                  size_t sdata_len,
+                                  curl_off_t valid_until,
+                                  int ietf_tls_id,
+                                  const char* alpn,
+                                  size_t earlydata_max) {
+  std::vector<TlsSession>* sessions =
+      static_cast<std::vector<TlsSession>*>(userptr);
+  if (valid_until > 0 and
+      valid_until < getSecondsSinceEpoch() + TLS_SESSION_MIN_REMAINING_S) {
+    return CURLE_OK;
+  }
+  TlsSession session;
+  session.sessionKey = std::string(session_key);
+  session.shmac =
+      std::string(reinterpret_cast<const char*>(shmac), shmac_len);
+  session.sessionData =
+      std::string(reinterpret_cast<const char*>(sdata), sdata_len);
+  session.validUntil = static_cast<long long>(valid_until);
+  sessions->push_back(session);
+  return CURLE_OK;
+}
+
+void importTlsSessions(CURL* curl, std::string hostname, unsigned short port) {
+  std::vector<TlsSession> sessions =
+      readTlsSessionCache(getTlsSessionCacheFilePath(), hostname, port);
+  int imported = 0;
+
+  for (const TlsSession& session : sessions) {
+    CURLcode res = curl_easy_ssls_import(
+        curl,
+        session.sessionKey.c_str(),
+        reinterpret_cast<const unsigned char*>(session.shmac.data()),
+        session.shmac.size(),
+        reinterpret_cast<const unsigned char*>(session.sessionData.data()),
+        session.sessionData.size());
+    if (res != CURLE_OK) {
+      WriteLog(LL_DEBUG,
+               "  Could not import cached TLS session: " +
+                   std::string(curl_easy_strerror(res)));
+      continue;
+    }
+    imported++;
+  }
+  WriteLog(LL_TRACE,
+           "  Imported " + std::to_string(imported) + " cached TLS sessions");
+}
+
+void exportTlsSessions(CURL* curl, std::string hostname, unsigned short port) {
+  if (curl == nullptr) {
+    return;
+  }
+  std::vector<TlsSession> sessions;
+  CURLcode res = curl_easy_ssls_export(curl, collectTlsSession, &sessions);
+  if (res != CURLE_OK) {
+    WriteLog(LL_DEBUG,
+             "  Could not export TLS sessions: " +
+                 std::string(curl_easy_strerror(res)));
+    return;
+  }
+  if (sessions.empty()) {
+    // Nothing worth saving, so leave whatever is on disk alone. An earlier
+    // process may have saved a session that is still good.
+    return;
+  }
+  writeTlsSessionCache(getTlsSessionCacheFilePath(), hostname, port, sessions);
+}
+
+#else
+
+void importTlsSessions(CURL* curl, std::string hostname, unsigned short port) {
+  WriteLog(LL_DEBUG,
+           "  This libcurl can't import TLS sessions, 8.12 or later is "
+           "needed");
+}
+
+void exportTlsSessions(CURL* curl, std::string hostname, unsigned short port) {
+}
+
+#endif
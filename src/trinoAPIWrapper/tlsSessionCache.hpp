@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <curl/curl.h>
+
+/*
+An opt-in, on-disk cache of TLS session tickets.
+
+libcurl keeps TLS sessions in memory, so a brand new process always
+starts out with a full TLS handshake to the coordinator. These helpers
+export the sessions held by a CURL handle to a file in the user's
+%LOCALAPPDATA%\Temp directory and import them into a fresh handle in
+the next process so it can resume the session with an abbreviated
+handshake.
+
+Session data is encrypted with the user's login credentials, the same
+way the token cache is. Entries are grouped by the coordinator host and
+port they were collected for. Every driver process shares the file, so
+it is updated under a lock and replaced atomically.
+
+Exporting and importing sessions needs libcurl 8.12 or later, built with
+SSLS export. With an older libcurl the functions do nothing.
+
+Both functions are best-effort. Any failure is logged and otherwise
+ignored, since the worst case is simply a full TLS handshake.
+*/
+void importTlsSessions(CURL* curl, std::string hostname, unsigned short port);
+void exportTlsSessions(CURL* curl, std::string hostname, unsigned short port);
+
+// One session as libcurl hands it out, before encryption.
+struct TlsSession {
+    std::string sessionKey;
+    std::string shmac;
+    std::string sessionData;
+    // Seconds since the epoch, or 0 if libcurl doesn't know.
+    long long validUntil = 0;
+};
+
+/*
+The file the sessions are kept in, split out from the functions above
+so it can be used without a TLS connection. Reading skips sessions that
+expired or can't be decrypted. Writing replaces the sessions of one
+host and port and keeps the rest of the file.
+*/
+std::vector<TlsSession> readTlsSessionCache(std::wstring filePath,
+                                            std::string hostname,
+                                            unsigned short port);
+void writeTlsSessionCache(std::wstring filePath,
+                          std::string hostname,
+                          unsigned short port,
+                          const std::vector<TlsSession>& sessions);
@@ -3,3 +3,15 @@
 AuthError::AuthError(std::string& message) : std::runtime_error(message) {};
 
 AuthError::AuthError(const char* message) : std::runtime_error(message) {};
+
+CancelledError::CancelledError(const std::string& message)
+    : std::runtime_error(message) {};
+
+CancelledError::CancelledError(const char* message)
+    : std::runtime_error(message) {};
+
+TimeoutError::TimeoutError(const std::string& message)
+    : std::runtime_error(message) {};
+
+TimeoutError::TimeoutError(const char* message)
+    : std::runtime_error(message) {};
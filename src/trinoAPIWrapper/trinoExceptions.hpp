@@ -8,3 +8,19 @@ class AuthError : public std::runtime_error {
     explicit AuthError(std::string& message);
     explicit AuthError(const char* message);
 };
+
+// Thrown when an operation stops because the application canceled it,
+// which ODBC reports as SQLSTATE HY008.
+class CancelledError : public std::runtime_error {
+  public:
+    explicit CancelledError(const std::string& message);
+    explicit CancelledError(const char* message);
+};
+
+// Thrown when the driver gives up waiting on something on the
+// application's behalf, which ODBC reports as SQLSTATE HYT00.
+class TimeoutError : public std::runtime_error {
+  public:
+    explicit TimeoutError(const std::string& message);
+    explicit TimeoutError(const char* message);
+};
@@ -3,29 +3,53 @@
 #include <curl/curl.h>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <ranges>
+#include <set>
 #include <thread>
 
 #include "TrinoOdbcErrorHandler.hpp"
+#include "admissionController.hpp"
+#include "httpTimings.hpp"
+#include "metadataCache.hpp"
+#include "queryReaper.hpp"
+#include "queryWatchdog.hpp"
+#include "resultCache.hpp"
+#include "resultSchemaCache.hpp"
 #include "trinoExceptions.hpp"
 #include "trinoQuery.hpp"
 
 #include <stdexcept>
 
 #include "../util/delimKvpHelper.hpp"
+#include "../util/sqlRowLimit.hpp"
 #include "../util/stringTrim.hpp"
+#include "../util/traceEvents.hpp"
 #include "../util/writeLog.hpp"
 
 // How long should we poll between requests to Trino's nextUri?
 int API_POLL_INTERVAL_MS = 25;
 
+// Backoff for retrying failed requests to Trino's nextUri. The overall
+// time budget comes from the connection options.
+long long API_RETRY_BASE_DELAY_MS = 100;
+long long API_RETRY_MAX_DELAY_MS  = 10000;
+int API_RETRY_MAX_ATTEMPTS        = 10;
+
 TrinoQuery::TrinoQuery(ConnectionConfig* connectionConfig) {
   this->connectionConfig = connectionConfig;
+  this->retryPolicy =
+      RetryPolicy(API_RETRY_BASE_DELAY_MS,
+                  API_RETRY_MAX_DELAY_MS,
+                  connectionConfig->getOptions().retryBudgetMs,
+                  API_RETRY_MAX_ATTEMPTS);
   this->connectionConfig->registerDisconnectCallback(
       std::bind(&TrinoQuery::onConnectionReset, this, std::placeholders::_1));
 }
 
 TrinoQuery::~TrinoQuery() {
+  this->finishQuery();
+  this->logMetrics();
   this->connectionConfig->unregisterDisconnectCallback(
       std::bind(&TrinoQuery::onConnectionReset, this, std::placeholders::_1));
 }
@@ -84,12 +108,33 @@ std::string TrinoQuery::parseTrinoError(const json& errorJson) {
   return oss.str();
 }
 
+static void reshapePage(json& page, const PageReshaper& reshaper) {
+  if (page.contains("columns")) {
+    page["columns"] = reshaper.columns;
+  }
+  if (page.contains("data")) {
+    for (json& row : page["data"]) {
+      row = reshaper.reshapeRow(row);
+    }
+  }
+}
+
 UpdateStatus TrinoQuery::updateSelfFromResponse() {
   WriteLog(LL_TRACE, "  Entering TrinoQuery::updateSelfFromResponse");
-  json response_json = json::parse(this->connectionConfig->responseData);
+  TraceSpan span("TrinoQuery::updateSelfFromResponse");
+  json response_json;
+  {
+    MetricsTimer timer(this->metrics.decodeUs);
+    TraceSpan parseSpan("json::parse");
+    response_json = json::parse(this->connectionConfig->responseData);
+  }
   WriteLog(LL_DEBUG, "  Response is Parsed");
   UpdateStatus updateStatus;
 
+  if (this->pageReshaper.reshapeRow) {
+    reshapePage(response_json, this->pageReshaper);
+  }
+
   if (response_json.contains("error")) {
     this->error = true;
 
@@ -100,6 +145,11 @@ UpdateStatus TrinoQuery::updateSelfFromResponse() {
              TrinoOdbcErrorHandler::OdbcErrorToString(odbcError.value(), true));
   }
 
+  // Before the query can be marked complete, which stores the fill.
+  if (this->resultCacheFill) {
+    this->addToResultCacheFill(response_json);
+  }
+
   if (response_json.contains("queryId")) {
     setQueryId(response_json["queryId"]);
   } else if (response_json.contains("id")) {
@@ -119,26 +169,25 @@ UpdateStatus TrinoQuery::updateSelfFromResponse() {
   }
 
   if (response_json.contains("nextUri")) {
-    this->nextUri = response_json["nextUri"];
+    this->setNextUri(response_json["nextUri"]);
   } else {
     // This marks the point after which no more data will arrive,
     // so the query is now completed.
     this->completed = true;
-    this->nextUri.clear();
+    this->setNextUri("");
+    this->finishQuery();
   }
 
-  if (response_json.contains("columns") and this->columnDescriptions.empty()) {
+  if (response_json.contains("columns") and this->columnsFromCache) {
+    this->confirmCachedColumns(response_json["columns"]);
+    updateStatus.gotColumnInfo = true;
+  } else if (response_json.contains("columns") and
+             this->columnDescriptions.empty()) {
     WriteLog(LL_TRACE, "  Parsing column info from TrinoQuery data result");
-    this->columnsJson = response_json["columns"];
-    std::vector<ColumnDescription> columnDescriptions;
-    std::transform(this->columnsJson.begin(),
-                   this->columnsJson.end(),
-                   std::back_inserter(columnDescriptions),
-                   [](const json& json) { return ColumnDescription(json); });
-    this->columnDescriptions   = columnDescriptions;
+    this->setColumns(response_json["columns"]);
     updateStatus.gotColumnInfo = true;
-    for (std::function f : this->onColumnDataCallbacks) {
-      f(this);
+    if (not this->resultSchemaKey.empty()) {
+      getResultSchemaCache().put(this->resultSchemaKey, this->columnsJson);
     }
   }
 
@@ -154,6 +203,18 @@ UpdateStatus TrinoQuery::updateSelfFromResponse() {
     this->dataJson.insert(this->dataJson.end(),
                           response_json["data"].begin(),
                           response_json["data"].end());
+    this->metrics.pages++;
+    this->metrics.rowsReceived += newRows;
+    this->bufferedBytes += this->connectionConfig->responseData.size();
+    this->metrics.peakBufferedRows =
+        std::max<uint64_t>(this->metrics.peakBufferedRows,
+                           this->dataJson.size());
+    this->metrics.peakBufferedBytes =
+        std::max(this->metrics.peakBufferedBytes, this->bufferedBytes);
+  }
+
+  if (response_json.contains("updateCount")) {
+    this->updateCount = response_json["updateCount"].get<int64_t>();
   }
 
   // All "real" queries contain a state, but sideloaded
@@ -165,18 +226,186 @@ UpdateStatus TrinoQuery::updateSelfFromResponse() {
     }
   }
 
+  if (this->maxRows > 0 and this->getCurrentRowCount() >= this->maxRows and
+      not this->internalQuery) {
+    this->truncateToMaxRows();
+  }
+
+  if (this->internalQuery) {
+    std::string addedPrepare =
+        this->connectionConfig->getResponseHeader("X-Trino-Added-Prepare");
+    if (not addedPrepare.empty()) {
+      this->addedPrepare = addedPrepare;
+    }
+  }
+
   WriteLog(LL_TRACE, "  Exiting TrinoQuery::updateSelfFromResponse");
   return updateStatus;
 }
 
+void TrinoQuery::setColumns(const std::vector<json>& columns) {
+  this->columnsJson = columns;
+  std::vector<ColumnDescription> columnDescriptions;
+  std::transform(this->columnsJson.begin(),
+                 this->columnsJson.end(),
+                 std::back_inserter(columnDescriptions),
+                 [](const json& json) { return ColumnDescription(json); });
+  this->columnDescriptions = columnDescriptions;
+  // The application never sees the columns of the driver's own queries.
+  if (not this->internalQuery) {
+    for (std::function f : this->onColumnDataCallbacks) {
+      f(this);
+    }
+  }
+}
+
+void TrinoQuery::loadCachedColumns() {
+  /*
+  Describe the results with the columns from the last run of the same
+  query, if Trino hasn't sent the real ones yet.
+  */
+  if (this->resultSchemaKey.empty() or not this->columnDescriptions.empty()) {
+    return;
+  }
+  std::optional<std::vector<json>> cached =
+      getResultSchemaCache().get(this->resultSchemaKey);
+  if (cached) {
+    WriteLog(LL_DEBUG, "  Describing results from the result schema cache");
+    this->setColumns(*cached);
+    this->columnsFromCache = true;
+  }
+}
+
+void TrinoQuery::confirmCachedColumns(const std::vector<json>& columns) {
+  /*
+  Check the columns the results were described with against the ones
+  Trino sent. If the query's results changed shape since it last ran,
+  the row descriptors are rebuilt and the application is told with a
+  warning on its next fetch.
+  */
+  this->columnsFromCache = false;
+  if (columns == this->columnsJson) {
+    return;
+  }
+  WriteLog(LL_WARN,
+           "  WARNING: The result columns of query " + this->queryId +
+               " changed since it last ran. Describing them again");
+  getResultSchemaCache().put(this->resultSchemaKey, columns);
+  this->columnDescriptions.clear();
+  this->setColumns(columns);
+  this->columnsChanged = true;
+}
+
+bool TrinoQuery::answerFromResultCache() {
+  /*
+  Answer with the results of the last run of the same query, if they're
+  still fresh. If another statement is running the same query right now,
+  wait for its results rather than running it again. Otherwise this
+  statement runs the query and fills the cache entry for the others.
+
+  Only whole results of read-only queries are cached, so statements with
+  a row limit always run, as do reshaped metadata queries, whose rows
+  aren't the rows of their text. A statement never waits on another statement
+  of its own connection, since the application may have to fetch from
+  that one first, and stops waiting when it is canceled or times out.
+  */
+  const ConnectionOptions options = this->connectionConfig->getOptions();
+  if (options.resultCacheTtlMs <= 0 or this->internalQuery or
+      this->maxRows > 0 or this->pageReshaper.reshapeRow or
+      not isCacheableQuery(this->query)) {
+    return false;
+  }
+  std::string key =
+      this->connectionConfig->getIdentity() + normalizeQueryText(this->query);
+  bool leader = false;
+  std::shared_ptr<const SyntheticResultSet> cached =
+      getResultCache().getOrLead(
+          key, options, leader, this->connectionConfig, [this]() {
+            return this->cancelRequested.load();
+          });
+  if (cached) {
+    WriteLog(LL_DEBUG, "  Answering the query from the result cache");
+    this->sideloadResultSet(cached);
+    return true;
+  }
+  if (not leader and this->cancelRequested) {
+    this->finishQuery();
+    if (this->timedOut) {
+      throw TimeoutError("Query timeout expired");
+    }
+    throw CancelledError("Query submission was canceled");
+  }
+  if (leader) {
+    this->resultCacheKey       = key;
+    this->resultCacheFill      = std::make_shared<SyntheticResultSet>();
+    this->resultCacheFillBytes = 0;
+  }
+  return false;
+}
+
+void TrinoQuery::addToResultCacheFill(const json& response) {
+  /*
+  Copy the rows of a response into the cache entry. The application's
+  copy is dropped as it fetches, so the entry keeps its own. Results too
+  large to cache are given up on, which lets a waiting statement run the
+  query itself.
+  */
+  if (response.contains("columns") and this->resultCacheFill->columns.empty()) {
+    this->resultCacheFill->columns =
+        response["columns"].get<std::vector<json>>();
+  }
+  if (not response.contains("data")) {
+    return;
+  }
+  this->resultCacheFill->rows.insert(this->resultCacheFill->rows.end(),
+                                     response["data"].begin(),
+                                     response["data"].end());
+  this->resultCacheFillBytes += this->connectionConfig->responseData.size();
+  long maxBytes = this->connectionConfig->getOptions().resultCacheMaxBytes;
+  if (this->resultCacheFillBytes > static_cast<size_t>(maxBytes)) {
+    WriteLog(LL_DEBUG,
+             "  Results are larger than the result cache. Not caching them");
+    getResultCache().abandon(this->resultCacheKey);
+    this->resultCacheKey.clear();
+    this->resultCacheFill.reset();
+  }
+}
+
+void TrinoQuery::finishResultCacheFill() {
+  // Store the results if the query read all of them without an error,
+  // and otherwise hand the query to a waiting statement.
+  if (not this->resultCacheFill) {
+    return;
+  }
+  if (this->completed and not this->error and this->maxRows == 0) {
+    getResultCache().complete(this->resultCacheKey,
+                              this->resultCacheFill,
+                              this->resultCacheFillBytes,
+                              this->connectionConfig->getOptions());
+  } else {
+    getResultCache().abandon(this->resultCacheKey);
+  }
+  this->resultCacheKey.clear();
+  this->resultCacheFill.reset();
+}
+
+bool TrinoQuery::takeColumnsChanged() {
+  bool changed         = this->columnsChanged;
+  this->columnsChanged = false;
+  return changed;
+}
+
 void TrinoQuery::onConnectionReset(ConnectionConfig* connectionConfig) {
   // If the connection is about to be reset, terminate any in-flight
-  // queries first so they aren't left abandoned.
-  this->terminate();
+  // queries first so they aren't left abandoned. This happens in the
+  // background so that a connection with many open cursors doesn't wait
+  // on a round trip for each one.
+  this->terminateInBackground();
 }
 
 void TrinoQuery::setQuery(std::string query) {
-  this->query = query;
+  this->query        = query;
+  this->pageReshaper = PageReshaper();
 }
 
 const std::string& TrinoQuery::getQuery() const {
@@ -184,21 +413,120 @@ const std::string& TrinoQuery::getQuery() const {
 }
 
 void TrinoQuery::post() {
-  CURL* curl = this->connectionConfig->getCurl();
+  TraceSpan span("TrinoQuery::post");
+
+  // A statement that is executed again gives up the slot and deadline of
+  // its last query.
+  this->finishQuery();
+  this->admissionWaitMs = 0;
+  this->resultSchemaKey.clear();
+  if (this->connectionConfig->getOptions().resultSchemaCache and
+      not this->internalQuery and not this->pageReshaper.reshapeRow) {
+    // Executions of a prepared statement differ only in their parameters.
+    std::string text = this->isPrepared() ? this->preparedSql : this->query;
+    this->resultSchemaKey =
+        this->connectionConfig->getIdentity() + normalizeQueryText(text);
+  }
+  // The timeout also bounds waiting for the same query on another
+  // statement.
+  if (this->queryTimeoutSeconds > 0) {
+    this->deadlineId = scheduleDeadline(
+        std::chrono::steady_clock::now() +
+            std::chrono::seconds(this->queryTimeoutSeconds),
+        [this]() { this->onDeadlineExpired(); });
+  }
+  if (this->answerFromResultCache()) {
+    return;
+  }
 
-  std::string statementURL = this->connectionConfig->getStatementUrl();
-  curl_easy_setopt(curl, CURLOPT_URL, statementURL.c_str());
-  curl_easy_setopt(curl, CURLOPT_POSTFIELDS, query.c_str());
+  // Ask Trino for no more rows than the application wants, if allowed.
+  std::string postedQuery = this->query;
+  if (this->maxRows > 0 and
+      this->connectionConfig->getOptions().injectRowLimit) {
+    postedQuery = applyRowLimit(this->query, this->maxRows);
+  }
 
-  CURLcode res = curl_easy_perform(curl);
+  std::unique_ptr<struct curl_slist, decltype(&curl_slist_free_all)>
+      preparedHeaders(nullptr, curl_slist_free_all);
+
+  // Submit to the best coordinator. If it can't be reached, or turns the
+  // query away before creating it, move on to the next one.
+  std::set<size_t> triedEndpoints;
+  size_t endpoint;
+  CURLcode res;
+  long httpStatusCode;
+  while (true) {
+    std::string statementURL =
+        this->connectionConfig->getStatementUrl(triedEndpoints, endpoint);
+    // Take a slot before the handle, since getting the handle may refresh
+    // the connection's credentials, and a query waiting for a slot has no
+    // use for them yet.
+    this->admit(this->connectionConfig->getEndpointUrl(endpoint));
+    CURL* curl = this->getCurl();
+    curl_easy_setopt(curl, CURLOPT_URL, statementURL.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postedQuery.c_str());
+    // An EXECUTE carries the statement it refers to, on top of the headers
+    // every request on the connection sends. They are read after the
+    // handle, which has the credentials they carry up to date.
+    if (not this->preparedStatementHeader.empty()) {
+      struct curl_slist* headers = nullptr;
+      for (auto& pair : this->connectionConfig->getRequestHeaders()) {
+        std::string header = pair.first + ": " + pair.second;
+        headers            = curl_slist_append(headers, header.c_str());
+      }
+      std::string header =
+          "X-Trino-Prepared-Statement: " + this->preparedStatementHeader;
+      headers = curl_slist_append(headers, header.c_str());
+      preparedHeaders.reset(headers);
+      curl_easy_setopt(curl, CURLOPT_HTTPHEADER, preparedHeaders.get());
+    }
+    this->watchForCancel(curl);
 
-  if (res != CURLE_OK) {
-    WriteLog(LL_ERROR, std::string("CURL error: ") + curl_easy_strerror(res));
-  }
+    {
+      TraceSpan performSpan("curl_easy_perform");
+      res = curl_easy_perform(curl);
+    }
+    this->recordRequest(curl, HttpSubmit);
 
-  long httpStatusCode = this->connectionConfig->getLastHTTPStatusCode();
+    if (res != CURLE_OK) {
+      WriteLog(LL_ERROR,
+               std::string("CURL error: ") + curl_easy_strerror(res));
+    }
+
+    if (this->cancelRequested) {
+      // The cancel may have come after Trino created the query. If the
+      // response made it back, it says where to send the DELETE.
+      if (res == CURLE_OK and
+          this->connectionConfig->getLastHTTPStatusCode() == 200) {
+        json response =
+            json::parse(this->connectionConfig->responseData, nullptr, false);
+        if (response.is_object() and response.contains("nextUri")) {
+          WriteLog(LL_DEBUG, "  Handing the canceled query to the reaper");
+          reapQuery(response["nextUri"].get<std::string>(),
+                    this->connectionConfig->getRequestHeaders());
+        }
+      }
+      this->finishQuery();
+      if (this->timedOut) {
+        throw TimeoutError("Query timeout expired");
+      }
+      throw CancelledError("Query submission was canceled");
+    }
+
+    httpStatusCode = this->connectionConfig->getLastHTTPStatusCode();
+    if (not isEndpointUnavailable(res, httpStatusCode) or
+        not this->connectionConfig->reportEndpointFailure(endpoint,
+                                                          triedEndpoints)) {
+      break;
+    }
+    WriteLog(LL_WARN,
+             "  WARNING: " + statementURL +
+                 " is unavailable. Submitting to the next endpoint");
+    this->releaseAdmission();
+  }
 
   if (httpStatusCode == 200 and res == CURLE_OK) {
+    this->connectionConfig->reportEndpointSuccess(endpoint);
     updateSelfFromResponse();
     if (this->nextUri.empty()) {
       WriteLog(LL_ERROR,
@@ -206,8 +534,10 @@ void TrinoQuery::post() {
                    std::to_string(httpStatusCode));
       throw std::runtime_error("No NextURI in Trino POST response");
     }
+    this->loadCachedColumns();
   } else {
     // If we get here, there was a problem posting the query.
+    this->finishQuery();
     WriteLog(LL_ERROR,
              "  Error POSTing query. CURL status code was " +
                  std::to_string(httpStatusCode));
@@ -221,21 +551,47 @@ void TrinoQuery::poll(TrinoQueryPollMode mode) {
     return;
   }
 
-  CURL* curl    = this->connectionConfig->getCurl();
+  CURL* curl    = this->getCurl();
   int pollCount = 1;
   while (!this->completed) {
+    TraceSpan span("TrinoQuery::poll");
+    if (this->cancelRequested) {
+      this->setCancelledError();
+      return;
+    }
     // Since we're reusing the curl handle, we need to clear any
     // data returned from it. This is kind of ugly, but it is
     // highly efficient.
     this->connectionConfig->responseData.clear();
     this->connectionConfig->responseHeaderData.clear();
     curl_easy_setopt(curl, CURLOPT_URL, this->nextUri.c_str());
+    this->watchForCancel(curl);
 
     CURLcode res;
-    res = curl_easy_perform(curl);
+    {
+      TraceSpan performSpan("curl_easy_perform");
+      res = curl_easy_perform(curl);
+    }
+    this->recordRequest(curl, HttpPagePoll);
+    long httpStatusCode = this->connectionConfig->getLastHTTPStatusCode();
     UpdateStatus updateStatus;
-    if (res == CURLE_OK) {
+    if (this->cancelRequested) {
+      // The transfer may have been cut short, so whatever came back
+      // can't be trusted.
+      this->setCancelledError();
+      return;
+    } else if (res == CURLE_OK and httpStatusCode == 200) {
+      this->retryPolicy.recordSuccess();
       updateStatus = updateSelfFromResponse();
+    } else {
+      // Re-requesting the same nextUri is safe in the Trino protocol, so
+      // transient failures are retried rather than losing the query.
+      if (not this->waitBeforeRetry(res, httpStatusCode)) {
+        return;
+      }
+      // The wait may have been long enough for the token to need a refresh.
+      curl = this->getCurl();
+      continue;
     }
 
     if (mode == JustOnce) {
@@ -257,13 +613,454 @@ void TrinoQuery::poll(TrinoQueryPollMode mode) {
     if (updateStatus.gotRowData or updateStatus.gotColumnInfo) {
       pollCount = 0;
     } else {
-      std::this_thread::sleep_for(
-          std::chrono::milliseconds(pollCount * API_POLL_INTERVAL_MS));
+      this->waitUnlessCancelled(pollCount * API_POLL_INTERVAL_MS);
     }
     pollCount++;
   }
 }
 
+bool TrinoQuery::waitBeforeRetry(CURLcode curlCode, long httpStatusCode) {
+  /*
+  Wait before retrying a failed request to the nextUri. Returns false, with
+  the error recorded on the query, if the failure isn't worth retrying or
+  the statement has used up its retry budget.
+  */
+  std::string failure =
+      curlCode != CURLE_OK ? std::string(curl_easy_strerror(curlCode))
+                           : "HTTP status " + std::to_string(httpStatusCode);
+  long long delayMs = this->retryPolicy.nextDelayMs(
+      curlCode,
+      httpStatusCode,
+      this->connectionConfig->getResponseHeader("Retry-After"));
+  if (delayMs < 0) {
+    this->setCommunicationError("Failed to read query results from Trino: " +
+                                failure);
+    return false;
+  }
+  WriteLog(LL_WARN,
+           "  WARNING: request for query results failed (" + failure +
+               "). Retrying in " + std::to_string(delayMs) + " ms");
+  // A cancel during the wait is picked up at the top of the poll loop.
+  this->waitUnlessCancelled(delayMs);
+  return true;
+}
+
+void TrinoQuery::setCommunicationError(std::string message) {
+  WriteLog(LL_ERROR, "  ERROR: " + message);
+  TrinoOdbcErrorHandler::OdbcError odbcError;
+  odbcError.ret         = SQL_ERROR;
+  odbcError.sqlstate    = "08S01";
+  odbcError.native      = 0;
+  odbcError.message     = message;
+  odbcError.description = "Communication link failure";
+  odbcError.queryId     = this->queryId;
+  this->odbcError       = odbcError;
+  this->error           = true;
+  this->finishQuery();
+}
+
+void TrinoQuery::setCancelledError() {
+  // A query that ran out of time was canceled by the watchdog, and that
+  // gets reported as a timeout rather than as a cancel.
+  std::string sqlstate = this->timedOut ? "HYT00" : "HY008";
+  std::string message =
+      this->timedOut ? "Query timeout expired" : "Operation canceled";
+  if (this->timedOut) {
+    WriteLog(LL_WARN,
+             "  WARNING: Query " + this->queryId + " exceeded its timeout of " +
+                 std::to_string(this->queryTimeoutSeconds) +
+                 " seconds. Terminating it");
+  } else {
+    WriteLog(LL_INFO, "  Query stopped: " + message);
+  }
+  TrinoOdbcErrorHandler::OdbcError odbcError;
+  odbcError.ret         = SQL_ERROR;
+  odbcError.sqlstate    = sqlstate;
+  odbcError.native      = 0;
+  odbcError.message     = message;
+  odbcError.description = message;
+  odbcError.queryId     = this->queryId;
+  this->odbcError       = odbcError;
+  this->error           = true;
+  // The query is over as far as this statement is concerned. Whoever
+  // requested the cancel already sent the DELETE to Trino.
+  this->setNextUri("");
+  this->finishQuery();
+}
+
+void TrinoQuery::admit(std::string endpoint) {
+  /*
+  Wait for the admission controller to let this query run. Throws a
+  TimeoutError if it has to wait longer than the connection allows, and
+  stops waiting as soon as the statement is canceled or times out.
+  */
+  ConnectionOptions options = this->connectionConfig->getOptions();
+  auto start                = std::chrono::steady_clock::now();
+  bool admitted             = getAdmissionController().acquire(
+      endpoint,
+      options.maxConcurrentQueries,
+      options.maxEndpointQueries,
+      options.admissionTimeoutMs,
+      [this]() { return this->cancelRequested.load(); });
+  long long waitedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  this->admissionWaitMs += waitedMs;
+  this->metrics.admissionWaitUs += static_cast<uint64_t>(waitedMs) * 1000;
+  if (not admitted) {
+    this->finishQuery();
+    if (this->timedOut) {
+      throw TimeoutError("Query timeout expired");
+    }
+    if (this->cancelRequested) {
+      throw CancelledError("Query submission was canceled");
+    }
+    throw TimeoutError("Timed out after " + std::to_string(waitedMs) +
+                       " ms waiting for a free query slot");
+  }
+  if (waitedMs > 0) {
+    WriteLog(LL_DEBUG,
+             "  Query waited " + std::to_string(waitedMs) +
+                 " ms for admission to " + endpoint);
+  }
+  this->admittedEndpoint = endpoint;
+  this->admittedThread   = std::this_thread::get_id();
+}
+
+void TrinoQuery::finishQuery() {
+  // The query is over as far as this process is concerned, whether it
+  // completed, failed, or was abandoned.
+  this->releaseAdmission();
+  if (this->deadlineId) {
+    cancelDeadline(*this->deadlineId);
+    this->deadlineId = std::nullopt;
+  }
+  this->finishResultCacheFill();
+}
+
+void TrinoQuery::onDeadlineExpired() {
+  // Runs on the watchdog thread, so it only touches the atomic flags. The
+  // statement thread owns everything else, the query id included, and
+  // logs which query timed out when it stops.
+  this->timedOut = true;
+  this->requestCancel();
+}
+
+void TrinoQuery::truncateToMaxRows() {
+  /*
+  Drop any rows past the statement's row limit. If the limit was reached
+  before the query finished, there is no point letting Trino produce the
+  rest, so the query is terminated in the background and treated as
+  complete from here on.
+  */
+  int64_t excessRows = this->getCurrentRowCount() - this->maxRows;
+  if (excessRows > 0) {
+    this->dataJson.resize(this->dataJson.size() - excessRows);
+  }
+  if (not this->completed) {
+    WriteLog(LL_DEBUG,
+             "  Reached the row limit of " + std::to_string(this->maxRows) +
+                 ". Terminating the query");
+    if (not this->nextUri.empty()) {
+      reapQuery(this->nextUri, this->connectionConfig->getRequestHeaders());
+    }
+    this->completed = true;
+    this->setNextUri("");
+    this->finishQuery();
+  }
+}
+
+void TrinoQuery::setQueryTimeout(long long seconds) {
+  this->queryTimeoutSeconds = seconds;
+}
+
+void TrinoQuery::setMaxRows(int64_t maxRows) {
+  this->maxRows = maxRows;
+}
+
+bool TrinoQuery::prepare(std::string sql) {
+  /*
+  Register a statement with Trino so it can be executed any number of
+  times with different parameters. If this connection already prepared
+  the same text, that registration is reused without a round trip.
+
+  Returns false if Trino rejected the statement. The error is left on
+  this query for the application to read.
+  */
+  this->clearPrepared();
+  this->preparedSql = sql;
+  std::optional<std::string> name =
+      this->connectionConfig->getPreparedStatements().findName(sql);
+  if (name) {
+    WriteLog(LL_DEBUG, "  Reusing prepared statement " + *name);
+    this->preparedName = *name;
+  } else if (not this->registerPrepared()) {
+    return false;
+  }
+  this->awaitingExecute = true;
+  return true;
+}
+
+bool TrinoQuery::registerPrepared() {
+  PreparedStatementCache& preparedStatements =
+      this->connectionConfig->getPreparedStatements();
+  std::string name = preparedStatements.newName();
+  WriteLog(LL_DEBUG, "  Preparing statement " + name);
+
+  std::vector<json> rows;
+  if (not this->runInternalQuery(
+          "PREPARE " + name + " FROM " + this->preparedSql, rows)) {
+    return false;
+  }
+  if (not preparedStatements.add(this->preparedSql, this->addedPrepare)) {
+    throw std::runtime_error("Trino did not confirm the prepared statement");
+  }
+  this->preparedName = name;
+  this->reset();
+  return true;
+}
+
+bool TrinoQuery::runInternalQuery(std::string text, std::vector<json>& rows) {
+  /*
+  Run a statement of the driver's own to completion and collect its rows.
+  Any prepared statement header that is set goes along with it. Returns
+  false if Trino reported an error, which is left on this query.
+  */
+  this->reset();
+  this->setQuery(text);
+  this->internalQuery = true;
+  try {
+    this->post();
+    this->poll(ToCompletion);
+  } catch (...) {
+    this->internalQuery = false;
+    this->preparedStatementHeader.clear();
+    throw;
+  }
+  this->internalQuery = false;
+  this->preparedStatementHeader.clear();
+  if (this->hasError()) {
+    return false;
+  }
+  rows = this->dataJson;
+  return true;
+}
+
+std::optional<json> TrinoQuery::describePrepared(std::string kind) {
+  /*
+  Run DESCRIBE OUTPUT or DESCRIBE INPUT on the prepared statement, unless
+  the connection already knows the answer. Returns std::nullopt if the
+  statement couldn't be described, with the error left on this query.
+  */
+  PreparedStatementCache& preparedStatements =
+      this->connectionConfig->getPreparedStatements();
+  std::optional<json> description =
+      preparedStatements.getDescription(this->preparedName, kind);
+  if (description) {
+    return description;
+  }
+  std::vector<json> rows;
+  try {
+    std::string header = preparedStatements.getHeader(this->preparedName);
+    if (header.empty()) {
+      if (not this->registerPrepared()) {
+        return std::nullopt;
+      }
+      header = preparedStatements.getHeader(this->preparedName);
+    }
+    WriteLog(LL_DEBUG, "  Describing " + kind + " of " + this->preparedName);
+    this->preparedStatementHeader = header;
+    if (not this->runInternalQuery(
+            "DESCRIBE " + kind + " " + this->preparedName, rows)) {
+      return std::nullopt;
+    }
+  } catch (const CancelledError&) {
+    this->setCancelledError();
+    return std::nullopt;
+  } catch (const std::exception& ex) {
+    this->setCommunicationError(ex.what());
+    return std::nullopt;
+  }
+  this->reset();
+  description = json(rows);
+  preparedStatements.setDescription(this->preparedName, kind, *description);
+  return description;
+}
+
+void TrinoQuery::describeOutput() {
+  // DESCRIBE OUTPUT rows are: Column Name, Catalog, Schema, Table, Type,
+  // Type Size, and Aliased.
+  std::optional<json> rows = this->describePrepared("OUTPUT");
+  if (not rows) {
+    return;
+  }
+  std::vector<json> columns;
+  for (const json& row : *rows) {
+    columns.push_back(columnJsonFromType(row[0], row[4]));
+  }
+  this->setColumns(columns);
+}
+
+const std::vector<std::string>& TrinoQuery::getParameterTypes() {
+  if (not this->parameterTypes and this->isPrepared()) {
+    // DESCRIBE INPUT rows are: Position, Type.
+    std::optional<json> rows = this->describePrepared("INPUT");
+    if (rows) {
+      std::vector<std::string> types((*rows).size());
+      for (const json& row : *rows) {
+        size_t position = row[0].get<size_t>();
+        if (position < types.size()) {
+          types[position] = row[1].get<std::string>();
+        }
+      }
+      this->parameterTypes = types;
+    }
+  }
+  static const std::vector<std::string> noParameters;
+  return this->parameterTypes ? *this->parameterTypes : noParameters;
+}
+
+bool TrinoQuery::executePrepared(const std::vector<std::string>& parameters) {
+  /*
+  Execute the prepared statement with the given parameters, which are
+  already rendered as SQL literals. Only the short EXECUTE goes in the
+  request body. Returns false if the statement had to be registered again
+  and Trino rejected it.
+  */
+  if (this->preparedName.empty()) {
+    throw std::logic_error("Statement is not prepared");
+  }
+  PreparedStatementCache& preparedStatements =
+      this->connectionConfig->getPreparedStatements();
+  std::string header = preparedStatements.getHeader(this->preparedName);
+  if (header.empty()) {
+    WriteLog(LL_DEBUG,
+             "  Prepared statement " + this->preparedName +
+                 " was forgotten. Preparing it again");
+    if (not this->registerPrepared()) {
+      return false;
+    }
+    header = preparedStatements.getHeader(this->preparedName);
+  }
+
+  std::string execute = "EXECUTE " + this->preparedName;
+  for (size_t i = 0; i < parameters.size(); i++) {
+    execute += (i == 0 ? " USING " : ", ") + parameters[i];
+  }
+  this->setQuery(execute);
+  // Columns from DESCRIBE OUTPUT give way to the ones the results carry.
+  this->columnsJson.clear();
+  this->columnDescriptions.clear();
+  this->awaitingExecute         = false;
+  this->preparedStatementHeader = header;
+  try {
+    this->post();
+  } catch (...) {
+    this->preparedStatementHeader.clear();
+    throw;
+  }
+  this->preparedStatementHeader.clear();
+  return true;
+}
+
+void TrinoQuery::executeRewritten(std::string sql) {
+  /*
+  Run a statement the driver wrote in place of the prepared one, such as
+  a multi-row INSERT that covers many sets of parameters at once. Its
+  results stand in for the prepared statement's.
+  */
+  this->setQuery(sql);
+  this->columnsJson.clear();
+  this->columnDescriptions.clear();
+  this->awaitingExecute = false;
+  this->post();
+}
+
+const std::string& TrinoQuery::getPreparedSql() const {
+  return this->preparedSql;
+}
+
+std::optional<json> TrinoQuery::getMetadata(std::string query) {
+  /*
+  Run a catalog metadata query to completion and return its columns and
+  rows, in the shape sideloadResponse takes. The answer comes from the
+  metadata cache if the connection allows it, and is stored there
+  otherwise. Returns std::nullopt if Trino reported an error, which is
+  left on this query.
+  */
+  ConnectionOptions options = this->connectionConfig->getOptions();
+  long ttlMs                = options.metadataCacheTtlMs;
+  std::string key           = this->connectionConfig->getIdentity() + query;
+  MetadataCache& cache      = getMetadataCache();
+  if (ttlMs > 0) {
+    std::optional<json> cached = cache.get(key, ttlMs);
+    if (cached) {
+      WriteLog(LL_DEBUG, "  Answering metadata query from the cache");
+      return cached;
+    }
+  }
+  std::vector<json> rows;
+  if (not this->runInternalQuery(query, rows)) {
+    return std::nullopt;
+  }
+  json response;
+  response["columns"] = this->columnsJson;
+  response["data"]    = rows;
+  if (ttlMs > 0) {
+    cache.put(key, response);
+  }
+  return response;
+}
+
+const bool TrinoQuery::usesMetadataCache() const {
+  return this->connectionConfig->getOptions().metadataCacheTtlMs > 0;
+}
+
+bool TrinoQuery::runMetadataQuery(std::string query, PageReshaper reshaper) {
+  /*
+  Start a catalog metadata query for the application to fetch from. With
+  the metadata cache turned off, the query streams like any other, and
+  the reshaper, if any, is applied to each page as it arrives.
+  Returns false if Trino reported an error.
+  */
+  if (not this->usesMetadataCache()) {
+    this->setQuery(query);
+    this->pageReshaper = std::move(reshaper);
+    this->post();
+    return true;
+  }
+  std::optional<json> response = this->getMetadata(query);
+  if (not response) {
+    return false;
+  }
+  if (reshaper.reshapeRow) {
+    reshapePage(*response, reshaper);
+  }
+  this->reset();
+  this->setQuery(query);
+  this->sideloadResponse(*response);
+  return true;
+}
+
+void TrinoQuery::clearPrepared() {
+  this->preparedSql.clear();
+  this->preparedName.clear();
+  this->parameterTypes  = std::nullopt;
+  this->awaitingExecute = false;
+}
+
+const bool TrinoQuery::isPrepared() const {
+  return not this->preparedName.empty();
+}
+
+void TrinoQuery::releaseAdmission() {
+  if (this->admittedEndpoint) {
+    getAdmissionController().release(*this->admittedEndpoint,
+                                     this->admittedThread);
+    this->admittedEndpoint = std::nullopt;
+  }
+}
+
 /*
  Canceling a query causes it to gracefully stop.
  It may return a few more rows before finishing up,
@@ -281,6 +1078,7 @@ void TrinoQuery::cancel() {
     curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
 
     CURLcode res = curl_easy_perform(curl);
+    getHttpTimings().record(curl, HttpCancel);
     UpdateStatus updateStatus;
     if (res == CURLE_OK) {
       // There's nothing to parse from the result of the DELETE
@@ -306,6 +1104,7 @@ void TrinoQuery::terminate() {
     curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
 
     CURLcode res = curl_easy_perform(curl);
+    getHttpTimings().record(curl, HttpCancel);
     UpdateStatus updateStatus;
     if (res == CURLE_OK) {
       // A success status on the terminate command means it
@@ -321,28 +1120,136 @@ void TrinoQuery::terminate() {
   }
 }
 
+/*
+ Terminating in the background hands the DELETE to the query reaper
+ and returns right away. This is for when the application is done with
+ the query and doesn't need to wait for Trino to acknowledge it, such
+ as when a statement is closed or freed. The query is reset either way.
+*/
+void TrinoQuery::terminateInBackground() {
+  if (not this->getIsCompleted() and this->nextUri.size() > 0) {
+    WriteLog(LL_DEBUG, "  Handing query termination to the reaper");
+    reapQuery(this->nextUri, this->connectionConfig->getRequestHeaders());
+  }
+  this->reset();
+}
+
+/*
+ Cancel the query from any thread, including while another thread is
+ polling it. This never touches the connection's CURL handle, which the
+ polling thread may be in the middle of using. Instead, the DELETE goes
+ out through the query reaper, and the polling thread notices the cancel
+ flag: its progress callback aborts the transfer in flight, and any wait
+ between requests ends early. The poll then returns with SQLSTATE HY008.
+*/
+void TrinoQuery::requestCancel() {
+  std::string uri;
+  {
+    std::lock_guard<std::mutex> lock(this->cancelMutex);
+    this->cancelRequested = true;
+    uri                   = this->cancelUri;
+  }
+  this->cancelWake.notify_all();
+  // The statement may be waiting on another one running the same query,
+  // or for a free query slot.
+  getResultCache().wakeFollowers();
+  getAdmissionController().wakeWaiters();
+  if (not uri.empty()) {
+    reapQuery(uri, this->connectionConfig->getRequestHeaders());
+  }
+}
+
+/*
+ Forget a cancel from before the ODBC call that is starting now. A cancel
+ while nothing runs on the statement has no effect, but one that comes
+ after the call started counts, even before the query is submitted.
+*/
+void TrinoQuery::clearCancel() {
+  std::lock_guard<std::mutex> lock(this->cancelMutex);
+  this->cancelRequested = false;
+  this->timedOut        = false;
+}
+
+const bool TrinoQuery::isCancelRequested() const {
+  return this->cancelRequested;
+}
+
+void TrinoQuery::setNextUri(std::string nextUri) {
+  this->nextUri = nextUri;
+  std::lock_guard<std::mutex> lock(this->cancelMutex);
+  this->cancelUri = nextUri;
+}
+
+bool TrinoQuery::waitUnlessCancelled(long long waitMs) {
+  // Returns true if the wait ended because of a cancel.
+  MetricsTimer timer(this->metrics.waitUs);
+  std::unique_lock<std::mutex> lock(this->cancelMutex);
+  return this->cancelWake.wait_for(
+      lock, std::chrono::milliseconds(waitMs), [this]() {
+        return this->cancelRequested.load();
+      });
+}
+
+static int cancelProgressCallback(void* clientp,
+                                  curl_off_t dltotal,
+                                  curl_off_t dlnow,
+                                  curl_off_t ultotal,
+                                  curl_off_t ulnow) {
+  // Returning non-zero makes curl abort the transfer.
+  TrinoQuery* trinoQuery = static_cast<TrinoQuery*>(clientp);
+  return trinoQuery->isCancelRequested() ? 1 : 0;
+}
+
+void TrinoQuery::watchForCancel(CURL* curl) {
+  // ConnectionConfig::getCurl turns progress callbacks off again, so this
+  // only applies to requests made on behalf of this query.
+  curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, cancelProgressCallback);
+  curl_easy_setopt(curl, CURLOPT_XFERINFODATA, this);
+  curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+}
+
 const int64_t TrinoQuery::getAbsoluteRowCount() const {
   // The ODBC convention for row counts is that -1 represents
   // an as-yet unknown number of rows.
   if (this->completed) {
+    // Statements that change rows return the count as their only row,
+    // but it's the count that ODBC wants.
+    if (this->updateCount) {
+      return *this->updateCount;
+    }
     return this->getCurrentRowCount();
   } else {
     return -1;
   }
 }
 
+const int64_t TrinoQuery::getUpdateCount() const {
+  return this->updateCount.value_or(-1);
+}
+
 const int64_t TrinoQuery::getCurrentRowCount() const {
   // It can be useful to know how many rows are currently available.
   // However, the offset position needs to be included in this value
   // to provide the facade that the checkpointed rows that have
   // been discarded from memory are still around. Add one to the
   // offset position to turn it into a length/size.
+  if (this->syntheticResult) {
+    int64_t rows = static_cast<int64_t>(this->syntheticResult->rows.size());
+    if (this->maxRows > 0) {
+      rows = std::min(rows, this->maxRows);
+    }
+    return rows;
+  }
   return (this->rowOffsetPosition + 1) + this->dataJson.size();
 }
 
 const int16_t TrinoQuery::getColumnCount() {
   if (this->columnDescriptions.empty()) {
-    this->poll(UntilColumnsLoaded);
+    if (this->awaitingExecute) {
+      this->describeOutput();
+    } else {
+      this->poll(UntilColumnsLoaded);
+    }
   }
   // Yes, precision is lost here. However, the maximum column
   // count in a SQL query can be limited to a 16 bit integer
@@ -352,7 +1259,11 @@ const int16_t TrinoQuery::getColumnCount() {
 
 const std::vector<ColumnDescription>& TrinoQuery::getColumnDescriptions() {
   if (this->columnDescriptions.empty()) {
-    this->poll(UntilColumnsLoaded);
+    if (this->awaitingExecute) {
+      this->describeOutput();
+    } else {
+      this->poll(UntilColumnsLoaded);
+    }
   }
   return this->columnDescriptions;
 }
@@ -373,8 +1284,35 @@ void TrinoQuery::sideloadResponse(json artificialResponse) {
    that doesn't actually come from the database, such as
    the type information for supported types for the driver.
    */
-  this->connectionConfig->responseData = artificialResponse.dump();
-  this->updateSelfFromResponse();
+  auto result = std::make_shared<SyntheticResultSet>();
+  if (artificialResponse.contains("columns")) {
+    result->columns =
+        std::move(artificialResponse["columns"].get_ref<json::array_t&>());
+  }
+  if (artificialResponse.contains("data")) {
+    result->rows =
+        std::move(artificialResponse["data"].get_ref<json::array_t&>());
+  }
+  this->sideloadResultSet(result);
+}
+
+void TrinoQuery::sideloadResultSet(
+    std::shared_ptr<const SyntheticResultSet> result) {
+  /*
+  Answer with a result set the driver built itself. Its rows are read
+  where they are rather than copied in, so the same result set can be
+  shared by any number of statements. A sideloaded result set is always
+  complete.
+  */
+  this->dataJson.clear();
+  this->rowOffsetPosition = -1;
+  this->syntheticResult   = result;
+  if (this->columnDescriptions.empty()) {
+    this->setColumns(result->columns);
+  }
+  this->completed = true;
+  this->setNextUri("");
+  this->finishQuery();
 }
 
 /*
@@ -386,19 +1324,34 @@ void TrinoQuery::sideloadResponse(json artificialResponse) {
 */
 void TrinoQuery::reset() {
   WriteLog(LL_TRACE, "  TrinoQuery is resetting");
+  this->logMetrics();
+  this->metrics       = QueryMetrics();
+  this->bufferedBytes = 0;
   this->query.clear();
   this->queryId.clear();
   this->infoUri.clear();
   this->partialCancelUri.clear();
-  this->nextUri.clear();
+  this->setNextUri("");
   this->status.clear();
   this->columnsJson.clear();
   this->dataJson.clear();
+  this->syntheticResult.reset();
+  this->pageReshaper = PageReshaper();
+  this->resultSchemaKey.clear();
+  this->columnsFromCache = false;
+  this->columnsChanged   = false;
   this->columnDescriptions.clear();
   this->error             = false;
   this->completed         = false;
+  this->updateCount       = std::nullopt;
   this->rowOffsetPosition = -1;
   this->odbcError         = std::nullopt;
+  this->retryPolicy.reset();
+  this->finishQuery();
+  this->addedPrepare.clear();
+  // A closed prepared statement is ready to be described or executed
+  // again.
+  this->awaitingExecute = not this->preparedName.empty();
 }
 
 void TrinoQuery::registerColumnDataChangeCallback(
@@ -428,6 +1381,11 @@ void TrinoQuery::checkpointRowPosition(int64_t completedIndex) {
   if (completedIndex < 0) {
     return;
   }
+  // Sideloaded rows aren't owned by this query, so there is nothing to
+  // free.
+  if (this->syntheticResult) {
+    return;
+  }
   // Get the position in dataJson that represents what has been
   // completed already.
   int64_t dataJsonPosition = completedIndex;
@@ -435,6 +1393,9 @@ void TrinoQuery::checkpointRowPosition(int64_t completedIndex) {
     dataJsonPosition -= (this->rowOffsetPosition + 1);
   }
 
+  // The freed rows take their share of the buffered bytes with them.
+  size_t bufferedRows = dataJson.size();
+
   // Watch out for unsigned integer underflow in this comparison!
   if (dataJsonPosition == static_cast<int64_t>(dataJson.size()) - 1) {
     // If we're erasing the whole thing, just clear it.
@@ -447,6 +1408,9 @@ void TrinoQuery::checkpointRowPosition(int64_t completedIndex) {
                        static_cast<std::vector<int64_t>::difference_type>(
                            dataJsonPosition));
   }
+  if (bufferedRows > 0) {
+    this->bufferedBytes = this->bufferedBytes * dataJson.size() / bufferedRows;
+  }
   this->rowOffsetPosition = completedIndex;
 }
 
@@ -457,7 +1421,10 @@ gives callers the ability to track row offsets well beyond the
 number of rows that actually fit into memory from a query.
 */
 const json& TrinoQuery::getRowAtIndex(int64_t index) const {
-  if (this->rowOffsetPosition > -1) {
+  if (this->syntheticResult) {
+    return this->syntheticResult
+        ->rows[static_cast<std::vector<json>::size_type>(index)];
+  } else if (this->rowOffsetPosition > -1) {
     return this->dataJson[static_cast<std::vector<json>::size_type>(
         index - (this->rowOffsetPosition + 1))];
   } else {
@@ -484,3 +1451,45 @@ const bool TrinoQuery::hasError() const {
 const TrinoOdbcErrorHandler::OdbcError& TrinoQuery::getError() const {
   return odbcError.value();
 };
+
+CURL* TrinoQuery::getCurl() {
+  // Getting the handle refreshes the connection's credentials if they
+  // expired, which counts against this query.
+  unsigned long long refreshes = this->connectionConfig->getAuthRefreshCount();
+  CURL* curl                   = this->connectionConfig->getCurl();
+  this->metrics.authRefreshes +=
+      this->connectionConfig->getAuthRefreshCount() - refreshes;
+  return curl;
+}
+
+void TrinoQuery::recordRequest(CURL* curl, HttpRequestKind kind) {
+  // The download size is counted before the body is decompressed, and
+  // the total time covers the whole request, connection setup included.
+  curl_off_t downloadBytes = 0;
+  curl_off_t totalTimeUs   = 0;
+  curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &downloadBytes);
+  curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &totalTimeUs);
+  this->metrics.httpRequests++;
+  this->metrics.bytesReceived += static_cast<uint64_t>(downloadBytes);
+  this->metrics.bytesDecompressed +=
+      this->connectionConfig->responseData.size();
+  this->metrics.networkUs += static_cast<uint64_t>(totalTimeUs);
+  getHttpTimings().record(curl, kind);
+}
+
+void TrinoQuery::logMetrics() {
+  if (this->metrics.httpRequests == 0 or getLogLevel() > LL_DEBUG) {
+    return;
+  }
+  WriteLog(LL_DEBUG,
+           "  Query " + this->queryId +
+               " metrics: " + queryMetricsSummary(this->metrics));
+}
+
+QueryMetrics& TrinoQuery::getMetrics() {
+  return this->metrics;
+}
+
+const long long TrinoQuery::getAdmissionWaitMs() const {
+  return this->admissionWaitMs;
+}
@@ -1,13 +1,22 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "TrinoOdbcErrorHandler.hpp"
 #include "columnDescription.hpp"
 #include "connectionConfig.hpp"
+#include "httpTimings.hpp"
+#include "queryMetrics.hpp"
+#include "retryPolicy.hpp"
+#include "syntheticResultSet.hpp"
 
 using json = nlohmann::json;
 
@@ -16,6 +25,14 @@ struct UpdateStatus {
     bool gotRowData    = false;
 };
 
+// Turns the pages of a metadata query into the result set of an ODBC
+// catalog function: its columns, and one of its rows for each row of the
+// query.
+struct PageReshaper {
+    std::vector<json> columns;
+    std::function<json(const json&)> reshapeRow;
+};
+
 enum TrinoQueryPollMode {
   JustOnce,
   UntilNewData,
@@ -46,15 +63,104 @@ class TrinoQuery {
     std::string status;
     std::vector<json> columnsJson;
     std::vector<json> dataJson;
+    // A sideloaded result set, whose rows are read in place of dataJson.
+    std::shared_ptr<const SyntheticResultSet> syntheticResult;
     std::vector<ColumnDescription> columnDescriptions;
     bool error     = false;
     bool completed = false;
+    // The number of rows an INSERT, UPDATE, or DELETE changed.
+    std::optional<int64_t> updateCount;
     std::vector<std::function<void(TrinoQuery*)>> onColumnDataCallbacks;
     int64_t rowOffsetPosition = -1;
+    // Applied to every page of the current query before it is read, so
+    // caches and the application only ever see the reshaped rows.
+    PageReshaper pageReshaper;
     UpdateStatus updateSelfFromResponse();
     void onConnectionReset(ConnectionConfig* connectionConfig);
     std::string parseTrinoError(const json& errorJson);
     std::optional<TrinoOdbcErrorHandler::OdbcError> odbcError;
+    RetryPolicy retryPolicy = RetryPolicy(0, 0, 0, 0);
+    bool waitBeforeRetry(CURLcode curlCode, long httpStatusCode);
+    void setCommunicationError(std::string message);
+    // The endpoint this query holds an admission slot for, if any, and
+    // the thread the slot is held by.
+    std::optional<std::string> admittedEndpoint;
+    std::thread::id admittedThread;
+    long long admissionWaitMs = 0;
+    void admit(std::string endpoint);
+    void releaseAdmission();
+
+    // Cancellation may be requested from any thread. The nextUri is copied
+    // under cancelMutex so the cancelling thread can terminate the query
+    // on the server without touching the state the polling thread owns.
+    std::atomic<bool> cancelRequested = false;
+    std::mutex cancelMutex;
+    std::condition_variable cancelWake;
+    std::string cancelUri;
+    void setNextUri(std::string nextUri);
+    bool waitUnlessCancelled(long long waitMs);
+    void watchForCancel(CURL* curl);
+    void setCancelledError();
+
+    // Statement attributes. A timeout of zero means no timeout, and a
+    // row limit of zero means no limit.
+    long long queryTimeoutSeconds = 0;
+    int64_t maxRows               = 0;
+    std::optional<unsigned long long> deadlineId;
+    std::atomic<bool> timedOut = false;
+    void finishQuery();
+    void onDeadlineExpired();
+    void truncateToMaxRows();
+
+    // The server-side prepared statement this query executes, if any. The
+    // text is kept so the statement can be registered again if the
+    // connection has forgotten it in the meantime.
+    std::string preparedSql;
+    std::string preparedName;
+    // Sent in X-Trino-Prepared-Statement with the next POST.
+    std::string preparedStatementHeader;
+    // Set while the driver runs a PREPARE or DESCRIBE of its own. Its
+    // results are not the application's, and it may answer with
+    // X-Trino-Added-Prepare.
+    bool internalQuery = false;
+    std::string addedPrepare;
+    bool registerPrepared();
+    // A prepared statement that hasn't been executed yet describes its
+    // results and parameters with DESCRIBE OUTPUT and DESCRIBE INPUT, so
+    // asking about them doesn't run the query.
+    bool awaitingExecute = false;
+    std::optional<std::vector<std::string>> parameterTypes;
+    bool runInternalQuery(std::string text, std::vector<json>& rows);
+    std::optional<json> describePrepared(std::string kind);
+    void describeOutput();
+    void setColumns(const std::vector<json>& columns);
+
+    // The result schema cache entry for this query, if the connection
+    // uses the cache. When the columns came from the cache, the first
+    // real columns from Trino are checked against them.
+    std::string resultSchemaKey;
+    bool columnsFromCache = false;
+    bool columnsChanged   = false;
+    void loadCachedColumns();
+    void confirmCachedColumns(const std::vector<json>& columns);
+
+    // The result cache entry this query fills as its pages arrive, if it
+    // is the first statement in the process to run its text. Other
+    // statements running the same text wait for it to finish.
+    std::string resultCacheKey;
+    std::shared_ptr<SyntheticResultSet> resultCacheFill;
+    size_t resultCacheFillBytes = 0;
+    bool answerFromResultCache();
+    void addToResultCacheFill(const json& response);
+    void finishResultCacheFill();
+
+    // Where the time of the current query went. The buffered bytes are
+    // estimated from the size of the pages the buffered rows came in.
+    QueryMetrics metrics;
+    uint64_t bufferedBytes = 0;
+    CURL* getCurl();
+    void recordRequest(CURL* curl, HttpRequestKind kind);
+    void logMetrics();
 
     friend class MemoryReclamationTest;
 
@@ -66,13 +172,32 @@ class TrinoQuery {
     void post();
     void cancel();
     void terminate();
+    void terminateInBackground();
+    void requestCancel();
+    void clearCancel();
+    void setQueryTimeout(long long seconds);
+    void setMaxRows(int64_t maxRows);
+    bool prepare(std::string sql);
+    bool executePrepared(const std::vector<std::string>& parameters);
+    void executeRewritten(std::string sql);
+    const std::string& getPreparedSql() const;
+    std::optional<json> getMetadata(std::string query);
+    bool runMetadataQuery(std::string query, PageReshaper reshaper = {});
+    const bool usesMetadataCache() const;
+    void clearPrepared();
+    const bool isPrepared() const;
+    const std::vector<std::string>& getParameterTypes();
+    const bool isCancelRequested() const;
     void poll(TrinoQueryPollMode mode);
     const int64_t getCurrentRowCount() const;
     const int64_t getAbsoluteRowCount() const;
+    const int64_t getUpdateCount() const;
     const int16_t getColumnCount();
     const std::vector<ColumnDescription>& getColumnDescriptions();
+    bool takeColumnsChanged();
     const bool getIsCompleted() const;
     void sideloadResponse(json artificialResponse);
+    void sideloadResultSet(std::shared_ptr<const SyntheticResultSet> result);
     void reset();
     void registerColumnDataChangeCallback(std::function<void(TrinoQuery*)> f);
     const bool hasColumnData() const;
@@ -83,4 +208,6 @@ class TrinoQuery {
     const std::string& getQueryId() const;
     const bool hasError() const;
     const TrinoOdbcErrorHandler::OdbcError& getError() const;
+    const long long getAdmissionWaitMs() const;
+    QueryMetrics& getMetrics();
 };
@@ -0,0 +1,333 @@
+#include "bufferToLiteral.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "writeLog.hpp"
+
+std::string quoteSqlString(const std::string& value) {
+  std::string quoted = "'";
+  for (char c : value) {
+    if (c == '\'') {
+      quoted += "''";
+    } else {
+      quoted += c;
+    }
+  }
+  quoted += "'";
+  return quoted;
+}
+
+static std::string textFromBuffer(const void* buffer,
+                                  SQLLEN bufferLength,
+                                  const SQLLEN* strLen_or_IndPtr) {
+  const char* chars = static_cast<const char*>(buffer);
+  if (strLen_or_IndPtr and *strLen_or_IndPtr != SQL_NTS) {
+    return std::string(chars, *strLen_or_IndPtr);
+  }
+  // Null terminated, but never read past the end of the buffer.
+  SQLLEN length = 0;
+  while ((bufferLength <= 0 or length < bufferLength) and
+         chars[length] != '\0') {
+    length++;
+  }
+  return std::string(chars, length);
+}
+
+static std::string textToTypedLiteral(SQLSMALLINT odbcDataType,
+                                      const std::string& text) {
+  std::string quoted = quoteSqlString(text);
+  switch (odbcDataType) {
+    case SQL_BIT: { // -7
+      return "CAST(" + quoted + " AS boolean)";
+    }
+    case SQL_TINYINT: { // -6
+      return "CAST(" + quoted + " AS tinyint)";
+    }
+    case SQL_SMALLINT: { // 5
+      return "CAST(" + quoted + " AS smallint)";
+    }
+    case SQL_INTEGER: { // 4
+      return "CAST(" + quoted + " AS integer)";
+    }
+    case SQL_BIGINT: { // -5
+      return "CAST(" + quoted + " AS bigint)";
+    }
+    case SQL_NUMERIC:   // 2
+    case SQL_DECIMAL: { // 3
+      return "DECIMAL " + quoted;
+    }
+    case SQL_REAL: { // 7
+      return "REAL " + quoted;
+    }
+    case SQL_FLOAT:    // 6
+    case SQL_DOUBLE: { // 8
+      return "DOUBLE " + quoted;
+    }
+    case SQL_TYPE_DATE: { // 91
+      return "DATE " + quoted;
+    }
+    case SQL_TYPE_TIME: { // 92
+      return "TIME " + quoted;
+    }
+    case SQL_TYPE_TIMESTAMP: { // 93
+      return "TIMESTAMP " + quoted;
+    }
+    default: {
+      return quoted;
+    }
+  }
+}
+
+template <typename T>
+static std::string integerLiteral(const void* buffer) {
+  T value;
+  std::memcpy(&value, buffer, sizeof(T));
+  return std::to_string(value);
+}
+
+static std::string floatingLiteral(double value, const std::string& type) {
+  // Plain numbers with a decimal point are decimals to Trino, so give the
+  // value its type explicitly.
+  if (std::isnan(value)) {
+    return type + " 'NaN'";
+  }
+  if (std::isinf(value)) {
+    return type + (value > 0 ? " 'Infinity'" : " '-Infinity'");
+  }
+  char chars[32];
+  std::to_chars_result result =
+      std::to_chars(chars, chars + sizeof(chars), value);
+  return type + " '" + std::string(chars, result.ptr) + "'";
+}
+
+static std::string numericLiteral(const SQL_NUMERIC_STRUCT& numeric) {
+  // The value is a little endian 128 bit integer. Peel decimal digits off
+  // by long division, most significant byte first.
+  unsigned char value[SQL_MAX_NUMERIC_LEN];
+  std::memcpy(value, numeric.val, SQL_MAX_NUMERIC_LEN);
+  std::string digits;
+  bool isZero = false;
+  while (not isZero) {
+    unsigned int remainder = 0;
+    isZero                 = true;
+    for (int i = SQL_MAX_NUMERIC_LEN - 1; i >= 0; i--) {
+      unsigned int current = (remainder << 8) | value[i];
+      value[i]             = static_cast<unsigned char>(current / 10);
+      remainder            = current % 10;
+      if (value[i] != 0) {
+        isZero = false;
+      }
+    }
+    digits.insert(digits.begin(), static_cast<char>('0' + remainder));
+  }
+  int scale = numeric.scale;
+  if (scale > 0) {
+    if (static_cast<int>(digits.size()) <= scale) {
+      digits.insert(0, scale - digits.size() + 1, '0');
+    }
+    digits.insert(digits.size() - scale, ".");
+  } else if (scale < 0) {
+    digits.append(-scale, '0');
+  }
+  // A sign of 1 is positive, 0 is negative.
+  std::string sign = numeric.sign == 0 ? "-" : "";
+  return "DECIMAL '" + sign + digits + "'";
+}
+
+std::optional<std::string> bufferToLiteral(SQLSMALLINT cDataType,
+                                           SQLSMALLINT odbcDataType,
+                                           const void* buffer,
+                                           SQLLEN bufferLength,
+                                           const SQLLEN* strLen_or_IndPtr) {
+  if (strLen_or_IndPtr and *strLen_or_IndPtr == SQL_NULL_DATA) {
+    return "NULL";
+  }
+  // Any other negative length, like SQL_DATA_AT_EXEC, means the value is
+  // sent later with SQLPutData.
+  if (strLen_or_IndPtr and *strLen_or_IndPtr < 0 and
+      *strLen_or_IndPtr != SQL_NTS) {
+    return std::nullopt;
+  }
+  if (buffer == nullptr) {
+    return std::nullopt;
+  }
+  switch (cDataType) {
+    case SQL_C_CHAR: { // 1
+      std::string text = textFromBuffer(buffer, bufferLength, strLen_or_IndPtr);
+      return textToTypedLiteral(odbcDataType, text);
+    }
+    case SQL_C_BINARY: { // -2
+      SQLLEN length = strLen_or_IndPtr ? *strLen_or_IndPtr : bufferLength;
+      const unsigned char* bytes = static_cast<const unsigned char*>(buffer);
+      std::string literal        = "X'";
+      char hex[3];
+      for (SQLLEN i = 0; i < length; i++) {
+        std::snprintf(hex, sizeof(hex), "%02X", bytes[i]);
+        literal += hex;
+      }
+      return literal + "'";
+    }
+    case SQL_C_BIT: { // -7
+      unsigned char value = *static_cast<const unsigned char*>(buffer);
+      if (odbcDataType == SQL_BIT) {
+        return value ? "TRUE" : "FALSE";
+      }
+      return std::to_string(value);
+    }
+    case SQL_C_TINYINT:    // -6
+    case SQL_C_STINYINT: { // -26
+      return integerLiteral<int8_t>(buffer);
+    }
+    case SQL_C_UTINYINT: { // -28
+      return integerLiteral<uint8_t>(buffer);
+    }
+    case SQL_C_SHORT:    // 5
+    case SQL_C_SSHORT: { // -15
+      return integerLiteral<int16_t>(buffer);
+    }
+    case SQL_C_USHORT: { // -17
+      return integerLiteral<uint16_t>(buffer);
+    }
+    case SQL_C_LONG:    // 4
+    case SQL_C_SLONG: { // -16
+      return integerLiteral<int32_t>(buffer);
+    }
+    case SQL_C_ULONG: { // -18
+      return integerLiteral<uint32_t>(buffer);
+    }
+    case SQL_C_SBIGINT: { // -25
+      return integerLiteral<int64_t>(buffer);
+    }
+    case SQL_C_UBIGINT: { // -27
+      return integerLiteral<uint64_t>(buffer);
+    }
+    case SQL_C_FLOAT: { // 7
+      float value;
+      std::memcpy(&value, buffer, sizeof(float));
+      return floatingLiteral(value, "REAL");
+    }
+    case SQL_C_DOUBLE: { // 8
+      double value;
+      std::memcpy(&value, buffer, sizeof(double));
+      return floatingLiteral(value, "DOUBLE");
+    }
+    case SQL_C_NUMERIC: { // 2
+      SQL_NUMERIC_STRUCT numeric;
+      std::memcpy(&numeric, buffer, sizeof(SQL_NUMERIC_STRUCT));
+      return numericLiteral(numeric);
+    }
+    case SQL_C_DATE:        // 9
+    case SQL_C_TYPE_DATE: { // 91
+      SQL_DATE_STRUCT date;
+      std::memcpy(&date, buffer, sizeof(SQL_DATE_STRUCT));
+      char text[32];
+      std::snprintf(text,
+                    sizeof(text),
+                    "DATE '%04d-%02d-%02d'",
+                    date.year,
+                    date.month,
+                    date.day);
+      return std::string(text);
+    }
+    case SQL_C_TIME:        // 10
+    case SQL_C_TYPE_TIME: { // 92
+      SQL_TIME_STRUCT time;
+      std::memcpy(&time, buffer, sizeof(SQL_TIME_STRUCT));
+      char text[32];
+      std::snprintf(text,
+                    sizeof(text),
+                    "TIME '%02d:%02d:%02d'",
+                    time.hour,
+                    time.minute,
+                    time.second);
+      return std::string(text);
+    }
+    case SQL_C_TIMESTAMP:        // 11
+    case SQL_C_TYPE_TIMESTAMP: { // 93
+      SQL_TIMESTAMP_STRUCT timestamp;
+      std::memcpy(&timestamp, buffer, sizeof(SQL_TIMESTAMP_STRUCT));
+      char text[64];
+      int length = std::snprintf(text,
+                                 sizeof(text),
+                                 "TIMESTAMP '%04d-%02d-%02d %02d:%02d:%02d",
+                                 timestamp.year,
+                                 timestamp.month,
+                                 timestamp.day,
+                                 timestamp.hour,
+                                 timestamp.minute,
+                                 timestamp.second);
+      std::string literal(text, length);
+      // The fraction is in nanoseconds. Leave off trailing zeros so the
+      // literal's precision matches the value's.
+      if (timestamp.fraction > 0) {
+        std::snprintf(text,
+                      sizeof(text),
+                      "%09u",
+                      static_cast<unsigned int>(timestamp.fraction));
+        std::string fraction(text);
+        fraction.erase(fraction.find_last_not_of('0') + 1);
+        literal += "." + fraction;
+      }
+      return literal + "'";
+    }
+    default: {
+      WriteLog(LL_ERROR,
+               "  ERROR: Cannot convert bound parameter of C type: " +
+                   std::to_string(cDataType));
+      return std::nullopt;
+    }
+  }
+}
+
+SQLLEN cDataTypeSize(SQLSMALLINT cDataType) {
+  switch (cDataType) {
+    case SQL_C_BIT:        // -7
+    case SQL_C_TINYINT:    // -6
+    case SQL_C_STINYINT:   // -26
+    case SQL_C_UTINYINT: { // -28
+      return sizeof(uint8_t);
+    }
+    case SQL_C_SHORT:    // 5
+    case SQL_C_SSHORT:   // -15
+    case SQL_C_USHORT: { // -17
+      return sizeof(uint16_t);
+    }
+    case SQL_C_LONG:    // 4
+    case SQL_C_SLONG:   // -16
+    case SQL_C_ULONG: { // -18
+      return sizeof(uint32_t);
+    }
+    case SQL_C_SBIGINT:   // -25
+    case SQL_C_UBIGINT: { // -27
+      return sizeof(uint64_t);
+    }
+    case SQL_C_FLOAT: { // 7
+      return sizeof(float);
+    }
+    case SQL_C_DOUBLE: { // 8
+      return sizeof(double);
+    }
+    case SQL_C_NUMERIC: { // 2
+      return sizeof(SQL_NUMERIC_STRUCT);
+    }
+    case SQL_C_DATE:        // 9
+    case SQL_C_TYPE_DATE: { // 91
+      return sizeof(SQL_DATE_STRUCT);
+    }
+    case SQL_C_TIME:        // 10
+    case SQL_C_TYPE_TIME: { // 92
+      return sizeof(SQL_TIME_STRUCT);
+    }
+    case SQL_C_TIMESTAMP:        // 11
+    case SQL_C_TYPE_TIMESTAMP: { // 93
+      return sizeof(SQL_TIMESTAMP_STRUCT);
+    }
+    default: {
+      return 0;
+    }
+  }
+}
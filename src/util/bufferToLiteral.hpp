@@ -0,0 +1,34 @@
+#pragma once
+
+#include "windowsLean.hpp"
+#include <sql.h>
+#include <sqlext.h>
+
+#include <optional>
+#include <string>
+
+// Quote a string as a SQL character literal.
+std::string quoteSqlString(const std::string& value);
+
+/*
+Render a bound parameter value as a Trino SQL literal. This is the
+reverse of columnToBuffer: the C type says how to read the buffer, and
+the SQL type says what kind of value Trino should see. Character data
+bound to a non-character SQL type is handed to Trino as text to convert.
+
+A null indicator renders as NULL. Returns std::nullopt if the C type is
+not supported.
+*/
+std::optional<std::string> bufferToLiteral(SQLSMALLINT cDataType,
+                                           SQLSMALLINT odbcDataType,
+                                           const void* buffer,
+                                           SQLLEN bufferLength,
+                                           const SQLLEN* strLen_or_IndPtr);
+
+/*
+The size of one value of a fixed length C type, which is how far apart
+the values of a column-wise bound parameter array are. Returns 0 for
+character and binary data, whose values are as far apart as the bound
+buffer length says.
+*/
+SQLLEN cDataTypeSize(SQLSMALLINT cDataType);
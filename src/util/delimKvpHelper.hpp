@@ -56,3 +56,6 @@ server and token server to use to authenticate to Trino
 */
 std::map<std::string, std::string>
 parseKVPsFromCommaDelimStr(std::string kvpStr);
+
+// Lowercase an ASCII string.
+std::string toLowercase(std::string s);
@@ -0,0 +1,118 @@
+#include "fileLock.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+#include "windowsLean.hpp"
+
+#include "writeLog.hpp"
+
+
+int FILE_LOCK_RETRY_INTERVAL_MS = 10;
+// How long to keep retrying the rename in writeFileAtomically while some
+// other program, like a virus scanner, has the target file open.
+int FILE_REPLACE_TIMEOUT_MS = 1000;
+
+
+FileLock::FileLock(std::wstring lockFilePath, unsigned long timeoutMs) {
+  this->locked = false;
+  this->handle = CreateFileW(lockFilePath.c_str(),
+                             GENERIC_READ | GENERIC_WRITE,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE |
+                                 FILE_SHARE_DELETE,
+                             NULL,
+                             OPEN_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL,
+                             NULL);
+  if (this->handle == INVALID_HANDLE_VALUE) {
+    WriteLog(LL_WARN,
+             "  WARNING: could not open lock file, error " +
+                 std::to_string(GetLastError()));
+    return;
+  }
+
+  // LockFileEx can block forever, so ask it to fail immediately and retry
+  // until the timeout instead. Contention on these files is short lived.
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeoutMs);
+  while (true) {
+    OVERLAPPED overlapped = {0};
+    if (LockFileEx(this->handle,
+                   LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY,
+                   0,
+                   MAXDWORD,
+                   MAXDWORD,
+                   &overlapped)) {
+      this->locked = true;
+      return;
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      WriteLog(LL_WARN, "  WARNING: timed out waiting for file lock");
+      return;
+    }
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(FILE_LOCK_RETRY_INTERVAL_MS));
+  }
+}
+
+FileLock::~FileLock() {
+  if (this->handle == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  if (this->locked) {
+    OVERLAPPED overlapped = {0};
+    UnlockFileEx(this->handle, 0, MAXDWORD, MAXDWORD, &overlapped);
+  }
+  CloseHandle(this->handle);
+}
+
+bool FileLock::isLocked() {
+  return this->locked;
+}
+
+
+bool writeFileAtomically(std::wstring filePath, std::string contents) {
+  // Include the process id so two processes that both skipped the lock
+  // (because it timed out) don't write into the same temporary file.
+  std::wstring tempPath =
+      filePath + L"." + std::to_wstring(getCurrentProcessIdentifier()) + L".tmp";
+
+  std::ofstream outputFile(tempPath, std::ios::binary | std::ios::trunc);
+  if (!outputFile.is_open()) {
+    WriteLog(LL_ERROR, "  ERROR: cannot open temporary file for writing");
+    return false;
+  }
+  outputFile << contents;
+  outputFile.close();
+  if (outputFile.fail()) {
+    WriteLog(LL_ERROR, "  ERROR: failed writing temporary file");
+    return false;
+  }
+
+  // The rename fails while anyone has the target open without sharing
+  // delete access, which is how the C++ streams open files. The driver's
+  // own readers hold the writers' lock, but other programs don't.
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(FILE_REPLACE_TIMEOUT_MS);
+  while (!MoveFileExW(tempPath.c_str(),
+                      filePath.c_str(),
+                      MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    DWORD error = GetLastError();
+    if ((error != ERROR_SHARING_VIOLATION and error != ERROR_ACCESS_DENIED) or
+        std::chrono::steady_clock::now() >= deadline) {
+      WriteLog(LL_ERROR,
+               "  ERROR: failed to replace file, error " +
+                   std::to_string(error));
+      DeleteFileW(tempPath.c_str());
+      return false;
+    }
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(FILE_LOCK_RETRY_INTERVAL_MS));
+  }
+  return true;
+}
+
+unsigned long getCurrentProcessIdentifier() {
+  return static_cast<unsigned long>(GetCurrentProcessId());
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+
+/*
+An OS-level advisory lock shared by every process on the machine that
+locks the same path. The lock is taken in the constructor and released
+in the destructor.
+
+The lock lives on a separate, empty lock file rather than the file it
+protects, so the protected file can be replaced by an atomic rename
+while the lock is held.
+
+If the lock can't be taken within timeoutMs, isLocked() returns false
+and the caller decides whether to carry on without it.
+*/
+class FileLock {
+  public:
+    FileLock(std::wstring lockFilePath, unsigned long timeoutMs);
+    ~FileLock();
+    FileLock(const FileLock&)            = delete;
+    FileLock& operator=(const FileLock&) = delete;
+    bool isLocked();
+
+  private:
+    void* handle;
+    bool locked;
+};
+
+/*
+Replace the contents of filePath with contents so that readers see
+either the old file or the new one, never a partially written file.
+The data is written to a temporary file next to filePath and then
+renamed over it. A rename held up by another program having filePath
+open is retried for a moment. Returns false if any step fails.
+*/
+bool writeFileAtomically(std::wstring filePath, std::string contents);
+
+// The id of the current process, for tagging data shared between processes.
+unsigned long getCurrentProcessIdentifier();
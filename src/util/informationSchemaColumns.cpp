@@ -0,0 +1,213 @@
+#include "informationSchemaColumns.hpp"
+
+#include "windowsLean.hpp"
+#include <sql.h>
+#include <sqlext.h>
+
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// The JDBC type codes system.jdbc.columns reports for types that have no
+// ODBC type code of their own.
+static const int64_t JDBC_BOOLEAN               = 16;
+static const int64_t JDBC_TIME_WITH_TIMEZONE    = 2013;
+static const int64_t JDBC_ARRAY                 = 2003;
+static const int64_t JDBC_JAVA_OBJECT           = 2000;
+static const int64_t UNBOUNDED_LENGTH           = INT_MAX;
+static const int64_t DEFAULT_DATETIME_PRECISION = 3;
+
+static const std::vector<std::string> INTEGRAL_TYPES = {
+    "bigint", "integer", "smallint", "tinyint"};
+
+// Split "decimal(12,2)" into "decimal" and {12, 2}, and
+// "timestamp(3) with time zone" into "timestamp with time zone" and {3}.
+// Arguments that aren't numbers, like array element types, are dropped.
+static std::string parseType(const std::string& type,
+                             std::vector<int64_t>& arguments) {
+  size_t open  = type.find('(');
+  size_t close = type.rfind(')');
+  if (open == std::string::npos or close == std::string::npos or
+      close < open) {
+    return type;
+  }
+  std::string inside = type.substr(open + 1, close - open - 1);
+  size_t start       = 0;
+  while (start < inside.size()) {
+    size_t end = inside.find(',', start);
+    if (end == std::string::npos) {
+      end = inside.size();
+    }
+    std::string argument = inside.substr(start, end - start);
+    bool isNumber        = false;
+    for (char c : argument) {
+      if (std::isdigit(static_cast<unsigned char>(c))) {
+        isNumber = true;
+      } else if (c != ' ') {
+        isNumber = false;
+        break;
+      }
+    }
+    if (isNumber) {
+      arguments.push_back(std::stoll(argument));
+    }
+    start = end + 1;
+  }
+  if (arguments.empty()) {
+    return type.substr(0, open);
+  }
+  return type.substr(0, open) + type.substr(close + 1);
+}
+
+static bool isIntegral(const std::string& rawType) {
+  for (const std::string& integral : INTEGRAL_TYPES) {
+    if (rawType == integral) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static json dataTypeCode(const std::string& rawType) {
+  if (rawType == "bigint") {
+    return SQL_BIGINT;
+  } else if (rawType == "integer") {
+    return SQL_INTEGER;
+  } else if (rawType == "smallint") {
+    return SQL_SMALLINT;
+  } else if (rawType == "tinyint") {
+    return SQL_TINYINT;
+  } else if (rawType == "boolean") {
+    return JDBC_BOOLEAN;
+  } else if (rawType == "real") {
+    return SQL_REAL;
+  } else if (rawType == "double") {
+    return SQL_DOUBLE;
+  } else if (rawType == "decimal") {
+    return SQL_DECIMAL;
+  } else if (rawType == "varchar") {
+    return SQL_VARCHAR;
+  } else if (rawType == "char") {
+    return SQL_CHAR;
+  } else if (rawType == "varbinary") {
+    return SQL_VARBINARY;
+  } else if (rawType == "date") {
+    return SQL_TYPE_DATE;
+  } else if (rawType == "time") {
+    return SQL_TYPE_TIME;
+  } else if (rawType == "time with time zone") {
+    return JDBC_TIME_WITH_TIMEZONE;
+  } else if (rawType == "timestamp" or
+             rawType == "timestamp with time zone") {
+    // Reported as 2014 by JDBC, which ODBC has no code for.
+    return SQL_TYPE_TIMESTAMP;
+  } else if (rawType == "array") {
+    return JDBC_ARRAY;
+  }
+  return JDBC_JAVA_OBJECT;
+}
+
+static json columnSize(const std::string& rawType,
+                       const std::vector<int64_t>& arguments) {
+  int64_t length    = arguments.empty() ? UNBOUNDED_LENGTH : arguments[0];
+  int64_t precision =
+      arguments.empty() ? DEFAULT_DATETIME_PRECISION : arguments[0];
+  // Fractional seconds add a decimal point and the digits after it.
+  int64_t fraction = precision > 0 ? precision + 1 : 0;
+  if (rawType == "bigint") {
+    return 19;
+  } else if (rawType == "integer") {
+    return 10;
+  } else if (rawType == "smallint") {
+    return 5;
+  } else if (rawType == "tinyint") {
+    return 3;
+  } else if (rawType == "real") {
+    return 24;
+  } else if (rawType == "double") {
+    return 53;
+  } else if (rawType == "decimal") {
+    return arguments.empty() ? json(nullptr) : json(arguments[0]);
+  } else if (rawType == "varchar" or rawType == "char") {
+    return length;
+  } else if (rawType == "varbinary") {
+    return UNBOUNDED_LENGTH;
+  } else if (rawType == "date") {
+    return 14;
+  } else if (rawType == "time") {
+    return 8 + fraction;
+  } else if (rawType == "time with time zone") {
+    return 8 + fraction + 6;
+  } else if (rawType == "timestamp") {
+    return 19 + fraction;
+  } else if (rawType == "timestamp with time zone") {
+    return sizeof(SQL_TIMESTAMP_STRUCT);
+  }
+  return nullptr;
+}
+
+static json decimalDigits(const std::string& rawType,
+                          const std::vector<int64_t>& arguments) {
+  if (isIntegral(rawType)) {
+    return 0;
+  } else if (rawType == "decimal") {
+    return arguments.size() > 1 ? arguments[1] : 0;
+  } else if (rawType.starts_with("time")) {
+    return arguments.empty() ? DEFAULT_DATETIME_PRECISION : arguments[0];
+  }
+  return nullptr;
+}
+
+static json numPrecRadix(const std::string& rawType) {
+  if (isIntegral(rawType) or rawType == "decimal") {
+    return 10;
+  } else if (rawType == "real" or rawType == "double") {
+    return 2;
+  }
+  return nullptr;
+}
+
+static json charOctetLength(const std::string& rawType,
+                            const std::vector<int64_t>& arguments) {
+  if (rawType == "varchar" or rawType == "char") {
+    return arguments.empty() ? UNBOUNDED_LENGTH : arguments[0];
+  } else if (rawType == "varbinary") {
+    return UNBOUNDED_LENGTH;
+  }
+  return nullptr;
+}
+
+json sqlColumnsRowFromInformationSchema(const json& row) {
+  std::string type = row[6].get<std::string>();
+  std::vector<int64_t> arguments;
+  std::string rawType = parseType(type, arguments);
+  bool nullable       = row[5] == "YES";
+
+  std::string typeName = type;
+  if (rawType == "timestamp with time zone") {
+    typeName = "timestamp";
+  }
+  return json::array({
+      row[0],                               // TABLE_CAT
+      row[1],                               // TABLE_SCHEM
+      row[2],                               // TABLE_NAME
+      row[3],                               // COLUMN_NAME
+      dataTypeCode(rawType),                // DATA_TYPE
+      typeName,                             // TYPE_NAME
+      columnSize(rawType, arguments),       // COLUMN_SIZE
+      nullptr,                              // BUFFER_LENGTH
+      decimalDigits(rawType, arguments),    // DECIMAL_DIGITS
+      numPrecRadix(rawType),                // NUM_PREC_RADIX
+      nullable ? 1 : 0,                     // NULLABLE
+      nullptr,                              // REMARKS
+      nullptr,                              // COLUMN_DEF
+      nullptr,                              // SQL_DATA_TYPE
+      nullptr,                              // SQL_DATETIME_SUB
+      charOctetLength(rawType, arguments),  // CHAR_OCTET_LENGTH
+      row[4],                               // ORDINAL_POSITION
+      nullable ? "YES" : "NO",              // IS_NULLABLE
+  });
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+/*
+Turn a row of information_schema.columns into a row of the SQLColumns
+result set. The row must hold table_catalog, table_schema, table_name,
+column_name, ordinal_position, is_nullable, and data_type, in that
+order.
+
+The values follow system.jdbc.columns, with the same adjustments
+SQLColumns makes to it, so a table's columns look the same whichever
+source answered. information_schema has no column comments, so REMARKS
+is always null.
+*/
+json sqlColumnsRowFromInformationSchema(const json& row);
@@ -0,0 +1,183 @@
+#include "insertBatch.hpp"
+
+#include <cctype>
+
+
+// If a comment starts at i, return the index just past it. Otherwise
+// return i.
+static size_t skipComment(const std::string& sql, size_t i) {
+  if (sql.compare(i, 2, "--") == 0) {
+    size_t end = sql.find('\n', i);
+    return end == std::string::npos ? sql.size() : end + 1;
+  }
+  if (sql.compare(i, 2, "/*") == 0) {
+    size_t end = sql.find("*/", i + 2);
+    return end == std::string::npos ? sql.size() : end + 2;
+  }
+  return i;
+}
+
+// Like skipComment, but string literals and quoted identifiers are
+// skipped too. A doubled quote is treated as the end of one literal and
+// the start of the next, which comes to the same thing.
+static size_t skipQuotedOrComment(const std::string& sql, size_t i) {
+  char c = sql[i];
+  if (c == '\'' or c == '"') {
+    size_t end = sql.find(c, i + 1);
+    return end == std::string::npos ? sql.size() : end + 1;
+  }
+  return skipComment(sql, i);
+}
+
+static size_t skipSpaceAndComments(const std::string& sql, size_t i) {
+  while (i < sql.size()) {
+    size_t skipped = skipComment(sql, i);
+    if (skipped != i) {
+      i = skipped;
+    } else if (std::isspace(static_cast<unsigned char>(sql[i]))) {
+      i++;
+    } else {
+      break;
+    }
+  }
+  return i;
+}
+
+static bool isWordChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) or c == '_';
+}
+
+static std::vector<std::string> splitOnMarkers(const std::string& text) {
+  std::vector<std::string> pieces(1);
+  size_t i = 0;
+  while (i < text.size()) {
+    size_t skipped = skipQuotedOrComment(text, i);
+    if (skipped != i) {
+      pieces.back() += text.substr(i, skipped - i);
+      i = skipped;
+    } else if (text[i] == '?') {
+      pieces.emplace_back();
+      i++;
+    } else {
+      pieces.back() += text[i];
+      i++;
+    }
+  }
+  return pieces;
+}
+
+std::optional<InsertTemplate> parseInsertTemplate(const std::string& sql) {
+  // Find the top level VALUES keyword. The statement has to start with
+  // INSERT, and no markers may come before the row.
+  int depth        = 0;
+  size_t i         = 0;
+  size_t valuesEnd = std::string::npos;
+  bool firstWord   = true;
+  while (i < sql.size() and valuesEnd == std::string::npos) {
+    size_t skipped = skipQuotedOrComment(sql, i);
+    if (skipped != i) {
+      i = skipped;
+      continue;
+    }
+    char c = sql[i];
+    if (c == '?') {
+      return std::nullopt;
+    } else if (std::isalpha(static_cast<unsigned char>(c)) or c == '_') {
+      size_t start = i;
+      while (i < sql.size() and isWordChar(sql[i])) {
+        i++;
+      }
+      std::string word = sql.substr(start, i - start);
+      for (char& w : word) {
+        w = static_cast<char>(std::toupper(static_cast<unsigned char>(w)));
+      }
+      if (firstWord and word != "INSERT") {
+        return std::nullopt;
+      }
+      firstWord = false;
+      if (depth == 0 and word == "VALUES") {
+        valuesEnd = i;
+      }
+    } else {
+      if (c == '(') {
+        depth++;
+      } else if (c == ')') {
+        depth--;
+      }
+      i++;
+    }
+  }
+  if (valuesEnd == std::string::npos) {
+    return std::nullopt;
+  }
+
+  // The row runs from its opening parenthesis to the matching one.
+  size_t rowStart = skipSpaceAndComments(sql, valuesEnd);
+  if (rowStart >= sql.size() or sql[rowStart] != '(') {
+    return std::nullopt;
+  }
+  i     = rowStart;
+  depth = 0;
+  while (i < sql.size()) {
+    size_t skipped = skipQuotedOrComment(sql, i);
+    if (skipped != i) {
+      i = skipped;
+      continue;
+    }
+    if (sql[i] == '(') {
+      depth++;
+    } else if (sql[i] == ')') {
+      depth--;
+    }
+    i++;
+    if (depth == 0) {
+      break;
+    }
+  }
+  if (depth != 0) {
+    return std::nullopt;
+  }
+  size_t rowEnd = i;
+
+  // Another row, or any clause after this one, means the statement can't
+  // simply be repeated.
+  i = skipSpaceAndComments(sql, rowEnd);
+  if (i < sql.size() and sql[i] == ';') {
+    i = skipSpaceAndComments(sql, i + 1);
+  }
+  if (i != sql.size()) {
+    return std::nullopt;
+  }
+
+  InsertTemplate insert;
+  insert.head      = sql.substr(0, rowStart);
+  insert.rowPieces = splitOnMarkers(sql.substr(rowStart, rowEnd - rowStart));
+  if (insert.rowPieces.size() < 2) {
+    return std::nullopt;
+  }
+  return insert;
+}
+
+std::string renderInsertRow(const InsertTemplate& insert,
+                            const std::vector<std::string>& literals) {
+  std::string row = insert.rowPieces.at(0);
+  for (size_t i = 1; i < insert.rowPieces.size(); i++) {
+    row += literals.at(i - 1) + insert.rowPieces[i];
+  }
+  return row;
+}
+
+std::string buildInsertBatch(const InsertTemplate& insert,
+                             const std::vector<std::string>& rows,
+                             size_t first,
+                             size_t maxBytes,
+                             size_t& end) {
+  std::string sql = insert.head + rows.at(first);
+  end             = first + 1;
+  while (end < rows.size() and
+         sql.size() + 2 + rows[end].size() <= maxBytes) {
+    sql += ", " + rows[end];
+    end++;
+  }
+  return sql;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+/*
+An INSERT ... VALUES statement with a single row of values, split so the
+row can be repeated. The head is everything up to the row, and the row is
+cut into pieces at its parameter markers, so there is one more piece than
+there are markers.
+*/
+struct InsertTemplate {
+    std::string head;
+    std::vector<std::string> rowPieces;
+};
+
+/*
+Split an INSERT whose only parameter markers are in a single VALUES row,
+with nothing after that row but a semicolon. Returns std::nullopt for any
+other statement, including an INSERT ... SELECT or one with several rows.
+
+String literals, quoted identifiers, and comments are skipped, so a ? or
+a VALUES inside them doesn't count.
+*/
+std::optional<InsertTemplate> parseInsertTemplate(const std::string& sql);
+
+// The template's row with its markers replaced by literals, in order.
+std::string renderInsertRow(const InsertTemplate& insert,
+                            const std::vector<std::string>& literals);
+
+/*
+Join rendered rows, starting at first, into one multi-row INSERT of at
+most maxBytes. A row too long to fit with any other still gets an INSERT
+of its own. Sets end to the index just past the last row used.
+*/
+std::string buildInsertBatch(const InsertTemplate& insert,
+                             const std::vector<std::string>& rows,
+                             size_t first,
+                             size_t maxBytes,
+                             size_t& end);
@@ -0,0 +1,84 @@
+#include "latencyHistogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+  if (value < LATENCY_HISTOGRAM_SUB_BUCKETS) {
+    return static_cast<size_t>(value);
+  }
+  // Keep the top LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1 bits of the value.
+  // The highest is always set, and the rest pick the sub-bucket.
+  int shift = std::bit_width(value) - 1 - LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+  uint64_t subBucket = (value >> shift) - LATENCY_HISTOGRAM_SUB_BUCKETS;
+  return static_cast<size_t>((shift + 1) * LATENCY_HISTOGRAM_SUB_BUCKETS +
+                             subBucket);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+  if (index < LATENCY_HISTOGRAM_SUB_BUCKETS) {
+    return index;
+  }
+  int shift = static_cast<int>(index / LATENCY_HISTOGRAM_SUB_BUCKETS) - 1;
+  uint64_t subBucket = index % LATENCY_HISTOGRAM_SUB_BUCKETS;
+  uint64_t lower = (LATENCY_HISTOGRAM_SUB_BUCKETS + subBucket) << shift;
+  return lower + ((1ULL << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t value) {
+  this->counts[bucketIndex(value)]++;
+  this->total++;
+  this->sum     += value;
+  this->minValue = std::min(this->minValue, value);
+  this->maxValue = std::max(this->maxValue, value);
+}
+
+void LatencyHistogram::add(const LatencyHistogram& other) {
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    this->counts[i] += other.counts[i];
+  }
+  this->total   += other.total;
+  this->sum     += other.sum;
+  this->minValue = std::min(this->minValue, other.minValue);
+  this->maxValue = std::max(this->maxValue, other.maxValue);
+}
+
+uint64_t LatencyHistogram::count() const {
+  return this->total;
+}
+
+uint64_t LatencyHistogram::min() const {
+  return this->total == 0 ? 0 : this->minValue;
+}
+
+uint64_t LatencyHistogram::max() const {
+  return this->maxValue;
+}
+
+double LatencyHistogram::mean() const {
+  if (this->total == 0) {
+    return 0;
+  }
+  return static_cast<double>(this->sum) / static_cast<double>(this->total);
+}
+
+uint64_t LatencyHistogram::percentile(double percent) const {
+  if (this->total == 0) {
+    return 0;
+  }
+  percent = std::clamp(percent, 0.0, 100.0);
+  // The rank of the value asked for, counting from one.
+  uint64_t rank = static_cast<uint64_t>(
+      std::ceil(percent / 100.0 * static_cast<double>(this->total)));
+  rank          = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    seen += this->counts[i];
+    if (seen >= rank) {
+      return std::clamp(bucketUpperBound(i), this->min(), this->maxValue);
+    }
+  }
+  return this->maxValue;
+}
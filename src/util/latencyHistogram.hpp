@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+A histogram of non-negative integers, like durations in microseconds or
+sizes in bytes, laid out the way HdrHistogram does it. Each power of two
+is split into LATENCY_HISTOGRAM_SUB_BUCKETS equal buckets, so any value
+is counted within about 6% of itself, from one microsecond up to days,
+in a fixed amount of memory and without allocating as values are
+recorded.
+
+It isn't synchronized. Whoever shares one guards it.
+*/
+static const int LATENCY_HISTOGRAM_SUB_BUCKET_BITS = 4;
+static const uint64_t LATENCY_HISTOGRAM_SUB_BUCKETS =
+    1ULL << LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+// Values below the sub-bucket count each get their own bucket, and each
+// power of two from there up to 2^64 gets a row of sub-buckets.
+static const size_t LATENCY_HISTOGRAM_BUCKETS =
+    (64 - LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1) *
+    LATENCY_HISTOGRAM_SUB_BUCKETS;
+
+class LatencyHistogram {
+  public:
+    void record(uint64_t value);
+    // Adds the values recorded in other to this one.
+    void add(const LatencyHistogram& other);
+
+    uint64_t count() const;
+    uint64_t min() const;
+    uint64_t max() const;
+    double mean() const;
+    /*
+    The value that percentile percent of the recorded values are at or
+    below, for percent between 0 and 100. It is the top of the bucket
+    the value fell in, but never more than the largest value recorded.
+    Zero if nothing was recorded.
+    */
+    uint64_t percentile(double percent) const;
+
+    static size_t bucketIndex(uint64_t value);
+    // The largest value counted in a bucket.
+    static uint64_t bucketUpperBound(size_t index);
+
+  private:
+    std::array<uint64_t, LATENCY_HISTOGRAM_BUCKETS> counts = {};
+    uint64_t total    = 0;
+    uint64_t sum      = 0;
+    uint64_t minValue = UINT64_MAX;
+    uint64_t maxValue = 0;
+};
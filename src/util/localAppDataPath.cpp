@@ -0,0 +1,17 @@
+#include "localAppDataPath.hpp"
+
+#include "windowsLean.hpp"
+#include <shlobj.h> // For getting windows folder paths.
+
+std::wstring getLocalAppDataTempFilePath(std::wstring fileName) {
+  PWSTR tempPath = nullptr;
+  // https://learn.microsoft.com/en-us/windows/win32/api/shlobj_core/nf-shlobj_core-shgetknownfolderpath
+  if (SUCCEEDED(
+          SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, NULL, &tempPath))) {
+    std::wstring tempPathStr(tempPath);
+    // We are responsible for freeing the memory used to return the tempPath.
+    CoTaskMemFree(tempPath);
+    return tempPathStr + L"\\Temp\\" + fileName;
+  }
+  return L"";
+}
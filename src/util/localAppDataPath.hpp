@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+/*
+Return the full path to a file named fileName that lives in the
+current user's %LOCALAPPDATA%\Temp directory. The driver keeps its
+per-user caches (tokens, TLS sessions, ...) there.
+
+Returns an empty string if the known folder can't be resolved.
+*/
+std::wstring getLocalAppDataTempFilePath(std::wstring fileName);
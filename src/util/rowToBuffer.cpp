@@ -8,6 +8,7 @@
 
 #include "dateAndTimeUtils.hpp"
 #include "decimalHelper.hpp"
+#include "traceEvents.hpp"
 #include "writeLog.hpp"
 
 ColumnToBufferStatus::ColumnToBufferStatus(bool isSuccess,
@@ -316,6 +317,7 @@ ColumnToBufferStatus columnToBuffer(SQLSMALLINT cDataType,
                                     SQLLEN* strLen_or_IndPtr,
                                     SQLCHAR precision,
                                     SQLCHAR scale) {
+  TraceSpan span("columnToBuffer");
   switch (cDataType) {
     case SQL_C_CHAR: { // 1
       // Char pointers are used in a bunch of different ways. How to use
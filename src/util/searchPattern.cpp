@@ -0,0 +1,73 @@
+#include "searchPattern.hpp"
+
+#include "bufferToLiteral.hpp"
+
+
+static bool isEscapable(char c) {
+  return c == '%' or c == '_' or c == '\\';
+}
+
+bool isSearchPattern(const std::string& pattern) {
+  for (size_t i = 0; i < pattern.size(); i++) {
+    if (pattern[i] == '\\' and i + 1 < pattern.size() and
+        isEscapable(pattern[i + 1])) {
+      i++;
+    } else if (pattern[i] == '%' or pattern[i] == '_') {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string unescapeSearchPattern(const std::string& pattern) {
+  std::string name;
+  for (size_t i = 0; i < pattern.size(); i++) {
+    if (pattern[i] == '\\' and i + 1 < pattern.size() and
+        isEscapable(pattern[i + 1])) {
+      i++;
+    }
+    name += pattern[i];
+  }
+  return name;
+}
+
+// Trino rejects an escape character that isn't followed by a wildcard or
+// another escape character, so a backslash that escapes nothing is taken
+// literally and escaped itself.
+static std::string likePattern(const std::string& pattern) {
+  std::string like;
+  for (size_t i = 0; i < pattern.size(); i++) {
+    if (pattern[i] == '\\') {
+      if (i + 1 < pattern.size() and isEscapable(pattern[i + 1])) {
+        like += pattern[i];
+        i++;
+      } else {
+        like += '\\';
+      }
+    }
+    like += pattern[i];
+  }
+  return like;
+}
+
+std::string searchPatternPredicate(const std::string& column,
+                                   const std::string& pattern) {
+  if (isSearchPattern(pattern)) {
+    return column + " LIKE " + quoteSqlString(likePattern(pattern)) +
+           " ESCAPE '\\'";
+  }
+  return column + " = " + quoteSqlString(unescapeSearchPattern(pattern));
+}
+
+std::string quoteSqlIdentifier(const std::string& name) {
+  std::string quoted = "\"";
+  for (char c : name) {
+    if (c == '"') {
+      quoted += "\"\"";
+    } else {
+      quoted += c;
+    }
+  }
+  quoted += "\"";
+  return quoted;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+/*
+Catalog functions like SQLTables and SQLColumns take search patterns, in
+which % matches any run of characters and _ matches any one character.
+A backslash makes the character after it literal, which is the escape
+SQLGetInfo(SQL_SEARCH_PATTERN_ESCAPE) reports.
+*/
+
+// Does the pattern have a wildcard that isn't escaped?
+bool isSearchPattern(const std::string& pattern);
+
+// The name a pattern without wildcards stands for, with escapes removed.
+std::string unescapeSearchPattern(const std::string& pattern);
+
+/*
+A predicate matching column against the pattern, ready to append to a
+WHERE clause. A pattern without wildcards is compared with =, which Trino
+can push down into connectors, and anything else uses LIKE ... ESCAPE.
+*/
+std::string searchPatternPredicate(const std::string& column,
+                                   const std::string& pattern);
+
+// Quote a name as a SQL identifier.
+std::string quoteSqlIdentifier(const std::string& name);
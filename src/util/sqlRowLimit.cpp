@@ -0,0 +1,74 @@
+#include "sqlRowLimit.hpp"
+
+#include <cctype>
+#include <set>
+#include <vector>
+
+
+// Scan the statement and return its keywords that aren't nested in
+// parentheses, uppercased. A top level semicolon is returned as ";".
+static std::vector<std::string> topLevelWords(const std::string& sql) {
+  std::vector<std::string> words;
+  int depth = 0;
+  size_t i  = 0;
+  while (i < sql.size()) {
+    char c = sql[i];
+    if (c == '\'' or c == '"') {
+      // Quotes are escaped by doubling them, which this handles by
+      // treating the escape as the end of one literal and the start of
+      // the next.
+      size_t end = sql.find(c, i + 1);
+      i          = end == std::string::npos ? sql.size() : end + 1;
+    } else if (sql.compare(i, 2, "--") == 0) {
+      size_t end = sql.find('\n', i);
+      i          = end == std::string::npos ? sql.size() : end + 1;
+    } else if (sql.compare(i, 2, "/*") == 0) {
+      size_t end = sql.find("*/", i + 2);
+      i          = end == std::string::npos ? sql.size() : end + 2;
+    } else if (c == '(') {
+      depth++;
+      i++;
+    } else if (c == ')') {
+      depth--;
+      i++;
+    } else if (std::isalpha(static_cast<unsigned char>(c)) or c == '_') {
+      size_t start = i;
+      while (i < sql.size() and
+             (std::isalnum(static_cast<unsigned char>(sql[i])) or
+              sql[i] == '_')) {
+        i++;
+      }
+      if (depth == 0) {
+        std::string word = sql.substr(start, i - start);
+        for (char& w : word) {
+          w = static_cast<char>(std::toupper(static_cast<unsigned char>(w)));
+        }
+        words.push_back(word);
+      }
+    } else {
+      if (c == ';' and depth == 0) {
+        words.push_back(";");
+      }
+      i++;
+    }
+  }
+  return words;
+}
+
+std::string applyRowLimit(const std::string& sql, int64_t maxRows) {
+  static const std::set<std::string> rowLimitingWords = {
+      "LIMIT", "OFFSET", "FETCH", ";"};
+
+  std::vector<std::string> words = topLevelWords(sql);
+  if (maxRows <= 0 or words.empty() or
+      (words.front() != "SELECT" and words.front() != "WITH")) {
+    return sql;
+  }
+  for (const std::string& word : words) {
+    if (rowLimitingWords.count(word)) {
+      return sql;
+    }
+  }
+  // Start on a new line in case the statement ends in a -- comment.
+  return sql + "\nLIMIT " + std::to_string(maxRows);
+}
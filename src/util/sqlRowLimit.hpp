@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/*
+Return sql with a LIMIT clause of maxRows appended, if that can be done
+without changing what the query means apart from its row count. That is
+the case for a single SELECT (or WITH ... SELECT) statement that doesn't
+already end in a LIMIT, OFFSET, or FETCH clause. Any other statement is
+returned unchanged.
+
+String literals, quoted identifiers, comments, and anything inside
+parentheses are skipped when looking for those clauses, so subqueries
+with their own LIMIT are fine.
+*/
+std::string applyRowLimit(const std::string& sql, int64_t maxRows);
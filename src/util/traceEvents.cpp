@@ -0,0 +1,268 @@
+#include "traceEvents.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "fileLock.hpp"
+#include "windowsLean.hpp"
+#include "writeLog.hpp"
+
+
+// How often the background thread writes recorded spans to the file.
+int TRACE_FLUSH_INTERVAL_MS = 1000;
+
+// Spans are buffered in fixed size chunks, so a chunk never moves while
+// the background thread reads it.
+static const size_t TRACE_CHUNK_EVENTS = 1024;
+
+
+struct TraceEvent {
+    const char* name;
+    int64_t startUs;
+    int64_t durationUs;
+};
+
+struct TraceChunk {
+    TraceEvent events[TRACE_CHUNK_EVENTS];
+    // Only the recording thread writes these. The background thread
+    // reads them to find the events that are ready.
+    std::atomic<size_t> count     = 0;
+    std::atomic<TraceChunk*> next = nullptr;
+};
+
+/*
+The spans of one thread. The recording thread appends to the tail chunk,
+and the background thread writes out and frees chunks from the head.
+Once the recording thread has moved on to a new chunk it never touches
+the old one again, which is what makes freeing it safe.
+*/
+struct TraceBuffer {
+    unsigned long threadId;
+    TraceChunk* head;
+    TraceChunk* tail;
+    // Events of the head chunk already in the file.
+    size_t written                 = 0;
+    std::atomic<bool> threadExited = false;
+};
+
+// Marks a thread's buffer as finished when the thread exits. The buffer
+// itself lives on until the background thread has written it out.
+struct ThreadTraceBuffer {
+    TraceBuffer* buffer = nullptr;
+    ~ThreadTraceBuffer() {
+      if (this->buffer) {
+        this->buffer->threadExited.store(true, std::memory_order_release);
+      }
+    }
+};
+
+static std::atomic<bool> tracing = false;
+static thread_local ThreadTraceBuffer threadTraceBuffer;
+static const auto traceEpoch = std::chrono::steady_clock::now();
+
+static std::mutex traceMutex;
+static std::condition_variable traceWake;
+static std::vector<TraceBuffer*> traceBuffers;
+static std::ofstream traceFile;
+// Never destroyed, because a static std::thread that is still joinable at
+// exit calls std::terminate.
+static std::thread* traceThread = nullptr;
+static bool traceStopping       = false;
+static bool traceEventsWritten  = false;
+
+
+static int64_t traceNowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - traceEpoch)
+      .count();
+}
+
+static TraceBuffer* getThreadTraceBuffer() {
+  if (threadTraceBuffer.buffer == nullptr) {
+    TraceBuffer* buffer = new TraceBuffer();
+    buffer->threadId    = GetCurrentThreadId();
+    buffer->head        = new TraceChunk();
+    buffer->tail        = buffer->head;
+    // The only lock a thread takes for tracing, once.
+    std::lock_guard<std::mutex> lock(traceMutex);
+    traceBuffers.push_back(buffer);
+    threadTraceBuffer.buffer = buffer;
+  }
+  return threadTraceBuffer.buffer;
+}
+
+static void recordSpan(const char* name, int64_t startUs, int64_t endUs) {
+  TraceBuffer* buffer = getThreadTraceBuffer();
+  TraceChunk* chunk   = buffer->tail;
+  size_t count        = chunk->count.load(std::memory_order_relaxed);
+  if (count == TRACE_CHUNK_EVENTS) {
+    TraceChunk* next = new TraceChunk();
+    chunk->next.store(next, std::memory_order_release);
+    buffer->tail = next;
+    chunk        = next;
+    count        = 0;
+  }
+  chunk->events[count] = TraceEvent{name, startUs, endUs - startUs};
+  chunk->count.store(count + 1, std::memory_order_release);
+}
+
+static void writeTraceEvent(unsigned long threadId, const TraceEvent& event) {
+  static const unsigned long processId = getCurrentProcessIdentifier();
+  if (traceEventsWritten) {
+    traceFile << ",\n";
+  }
+  traceFile << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":"
+            << processId << ",\"tid\":" << threadId
+            << ",\"ts\":" << event.startUs << ",\"dur\":" << event.durationUs
+            << "}";
+  traceEventsWritten = true;
+}
+
+static void writeTraceBuffers() {
+  // Called with traceMutex held.
+  for (auto it = traceBuffers.begin(); it != traceBuffers.end();) {
+    TraceBuffer* buffer = *it;
+    // Checked first, so every event of an exited thread is seen below.
+    bool exited = buffer->threadExited.load(std::memory_order_acquire);
+    while (true) {
+      TraceChunk* chunk = buffer->head;
+      // The next chunk is only linked once this one is full, so loading
+      // it first means the count read after it is final whenever it is
+      // set. Reading the count first could miss the events recorded in
+      // between, on a chunk that is about to be freed.
+      TraceChunk* next = chunk->next.load(std::memory_order_acquire);
+      size_t count     = chunk->count.load(std::memory_order_acquire);
+      for (size_t i = buffer->written; i < count; i++) {
+        writeTraceEvent(buffer->threadId, chunk->events[i]);
+      }
+      buffer->written = count;
+      if (next == nullptr) {
+        break;
+      }
+      buffer->head    = next;
+      buffer->written = 0;
+      delete chunk;
+    }
+    if (exited) {
+      delete buffer->head;
+      delete buffer;
+      it = traceBuffers.erase(it);
+    } else {
+      it++;
+    }
+  }
+  traceFile.flush();
+}
+
+static void traceLoop() {
+  std::unique_lock<std::mutex> lock(traceMutex);
+  // Writes at least once, even if tracing is stopped before this thread
+  // gets going.
+  do {
+    traceWake.wait_for(lock,
+                       std::chrono::milliseconds(TRACE_FLUSH_INTERVAL_MS),
+                       []() { return traceStopping; });
+    writeTraceBuffers();
+  } while (not traceStopping);
+}
+
+static std::filesystem::path
+traceFilePathForProcess(const std::string& filePath) {
+  std::filesystem::path path(filePath);
+  std::filesystem::path extension = path.extension();
+  path.replace_extension();
+  path += "." + std::to_string(getCurrentProcessIdentifier());
+  path += extension.empty() ? std::filesystem::path(".json") : extension;
+  return path;
+}
+
+void startTracing(const std::string& filePath) {
+  std::lock_guard<std::mutex> lock(traceMutex);
+  if (tracing) {
+    return;
+  }
+  // Appended to, so tracing that starts again after the last environment
+  // was freed adds to the events already in the file.
+  std::filesystem::path path = traceFilePathForProcess(filePath);
+  traceFile.open(path, std::ios::out | std::ios::app);
+  if (not traceFile.is_open()) {
+    WriteLog(LL_WARN,
+             "  WARNING: cannot open trace file " + path.string() +
+                 ". Tracing is off");
+    return;
+  }
+  WriteLog(LL_INFO, "  Writing trace events to " + path.string());
+  std::error_code ignored;
+  traceEventsWritten = std::filesystem::file_size(path, ignored) > 0;
+  if (not traceEventsWritten) {
+    traceFile << "[\n";
+  }
+  traceStopping = false;
+  traceThread   = new std::thread(traceLoop);
+  tracing       = true;
+}
+
+void stopTracing() {
+  std::unique_lock<std::mutex> lock(traceMutex);
+  if (not tracing) {
+    return;
+  }
+  tracing       = false;
+  traceStopping = true;
+  lock.unlock();
+  traceWake.notify_all();
+  traceThread->join();
+
+  // The background thread wrote everything recorded before it stopped. A
+  // span that was being recorded just as tracing stopped is written if
+  // tracing starts again.
+  lock.lock();
+  delete traceThread;
+  traceThread = nullptr;
+  traceFile.close();
+}
+
+/*
+Writes out the spans that are left if the process exits without freeing
+its environments, when the driver is unloaded. The background thread is
+gone by then, and may have been stopped holding the lock, in which case
+those spans are lost rather than risking a hang.
+*/
+struct TraceFileCloser {
+    ~TraceFileCloser() {
+      std::unique_lock<std::mutex> lock(traceMutex, std::try_to_lock);
+      if (lock.owns_lock() and traceFile.is_open()) {
+        writeTraceBuffers();
+        traceFile.close();
+      }
+    }
+};
+
+// Declared after everything it uses, so it is destroyed before them.
+static TraceFileCloser traceFileCloser;
+
+void setTraceFlushInterval(int milliseconds) {
+  std::lock_guard<std::mutex> lock(traceMutex);
+  TRACE_FLUSH_INTERVAL_MS = milliseconds;
+}
+
+bool isTracing() {
+  return tracing.load(std::memory_order_relaxed);
+}
+
+TraceSpan::TraceSpan(const char* name) {
+  this->name    = name;
+  this->startUs = isTracing() ? traceNowUs() : -1;
+}
+
+TraceSpan::~TraceSpan() {
+  if (this->startUs >= 0 and isTracing()) {
+    recordSpan(this->name, this->startUs, traceNowUs());
+  }
+}
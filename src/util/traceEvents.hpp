@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/*
+Optional tracing of where the driver spends its time, written in the
+Chrome trace event format so a session can be opened in Perfetto or
+chrome://tracing and the ODBC calls, network waits and decoding of each
+thread seen side by side.
+
+Tracing is off unless a connection's DSN sets traceFile, and while it is
+off a span costs one atomic load. While it is on, each finished span is
+appended to a buffer owned by the thread that recorded it, without
+taking a lock. A background thread moves the events into the trace file
+about once a second. The rest are written when the last environment is
+freed, or when the driver is unloaded if the application never frees
+it.
+
+The file is a JSON array of events without its closing bracket, which
+the trace viewers accept, so events can be appended as they arrive. If
+tracing starts again later in the same process, it appends to the same
+file. The process id is added to the file name so processes sharing a
+DSN don't write to the same file.
+*/
+
+// Set how often the background thread writes recorded spans to the file.
+void setTraceFlushInterval(int milliseconds);
+
+// Start recording spans into filePath. Only the first path is used until
+// tracing is stopped.
+void startTracing(const std::string& filePath);
+
+// Write every recorded span to the trace file, close it, and stop the
+// background writer. Spans that finish after this are dropped.
+void stopTracing();
+
+bool isTracing();
+
+/*
+Records the time between its construction and destruction as a span on
+the current thread. The name is kept as a pointer, so it has to outlive
+the trace, as a string literal does.
+
+void SQLSomething() {
+  TraceSpan span("SQLSomething");
+  ...
+}
+*/
+class TraceSpan {
+  public:
+    TraceSpan(const char* name);
+    ~TraceSpan();
+    TraceSpan(const TraceSpan&)            = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+  private:
+    const char* name;
+    // Negative when tracing was off as the span started.
+    int64_t startUs;
+};
@@ -1,9 +1,11 @@
 #include <windows.h>
 
+#include <chrono>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <sql.h>
 #include <sqlext.h>
+#include <thread>
 
 #include "../constants.hpp"
 
@@ -48,3 +50,55 @@ TEST_F(SQLCancelTest, TestCancelQuery) {
   ret = SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
   ASSERT_EQ(ret, SQL_SUCCESS);
 }
+
+TEST_F(SQLCancelTest, TestCancelFromAnotherThread) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  std::string query = R"SQL(
+      SELECT *
+      FROM tpch.sf100.customer AS c1
+      JOIN tpch.sf100.customer AS c2
+          ON c1.custkey = c2.custkey
+      WHERE (c1.custkey + c2.custkey) % 7 = 0
+  )SQL";
+  ret               = SQLExecDirect(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  // Cancel while the main thread is busy fetching.
+  std::chrono::steady_clock::time_point cancelSent;
+  std::thread canceler([this, &cancelSent]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    cancelSent = std::chrono::steady_clock::now();
+    SQLCancel(hStmt);
+  });
+
+  // Fetch until the cancel takes effect.
+  do {
+    ret = SQLFetch(hStmt);
+  } while (ret == SQL_SUCCESS);
+  auto returned = std::chrono::steady_clock::now();
+  canceler.join();
+
+  ASSERT_EQ(ret, SQL_ERROR);
+  SQLCHAR sqlState[6];
+  SQLINTEGER nativeError;
+  SQLCHAR message[SQL_MAX_MESSAGE_LENGTH];
+  SQLSMALLINT messageLength;
+  ret = SQLGetDiagRec(SQL_HANDLE_STMT,
+                      hStmt,
+                      1,
+                      sqlState,
+                      &nativeError,
+                      message,
+                      sizeof(message),
+                      &messageLength);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(sqlState)), "HY008");
+  // Control should come back quickly, not after the query finishes.
+  auto cancelLatency = returned - cancelSent;
+  EXPECT_LT(cancelLatency, std::chrono::seconds(2));
+
+  ret = SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+}
@@ -1,15 +1,50 @@
 #include <windows.h>
 
 #include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
 #include <sql.h>
 #include <sqlext.h>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "../../src/driver/constants/connectionAttrs.hpp"
 #include "../constants.hpp"
 
 #include "../fixtures/sqlDriverConnectFixture.hpp"
 
 class ColumnsTest : public SQLDriverConnectFixture {};
 
+class CachedColumnsTest : public SQLDriverConnectFixture {
+  protected:
+    void SetUp() override {
+      return SQLDriverConnectFixture::SetUp("metadataCacheTtlMs=60000;");
+    }
+
+    // How many queries every connection in the process has submitted so
+    // far, from the HTTP timings.
+    long long submittedQueries() {
+      std::vector<char> buffer(1 << 20);
+      SQLINTEGER bufferLength = static_cast<SQLINTEGER>(buffer.size());
+      SQLINTEGER length       = 0;
+
+      SQLRETURN ret = SQLGetConnectAttr(this->hDbc,
+                                        SQL_ATTR_HTTP_TIMINGS,
+                                        buffer.data(),
+                                        bufferLength,
+                                        &length);
+      EXPECT_EQ(ret, SQL_SUCCESS);
+      nlohmann::json timings = nlohmann::json::parse(buffer.data());
+      long long submits      = 0;
+      for (const auto& [endpoint, kinds] : timings.items()) {
+        if (kinds.contains("submit")) {
+          submits += kinds["submit"]["requests"].get<long long>();
+        }
+      }
+      return submits;
+    }
+};
+
 TEST_F(ColumnsTest, GetColumnsForBigint) {
   SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, this->hDbc, &hStmt);
 
@@ -157,3 +192,120 @@ TEST_F(ColumnsTest, GetColumnsForTimestampWithTimeZone) {
 
   SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
 }
+
+TEST_F(CachedColumnsTest, TablesInOneSchemaShareOneLookup) {
+  /*
+  With the metadata cache on, the first SQLColumns for a table fetches
+  the columns of its whole schema, and later tables in that schema are
+  answered from memory. The answers must be the same either way.
+  */
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, this->hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to allocate statement handle";
+  // Start from an empty cache, whatever ran before in this process.
+  ret = SQLSetConnectAttr(
+      this->hDbc, SQL_ATTR_INVALIDATE_METADATA_CACHE, nullptr, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  long long submittedBefore = this->submittedQueries();
+
+  std::string catalog = "tpch";
+  std::string schema  = "tiny";
+
+  std::vector<std::pair<std::string, int>> tables = {{"nation", 4},
+                                                     {"region", 3}};
+  for (const auto& [table, expectedColumns] : tables) {
+    ret = SQLColumns(hStmt,
+                     (SQLCHAR*)catalog.c_str(),
+                     SQL_NTS,
+                     (SQLCHAR*)schema.c_str(),
+                     SQL_NTS,
+                     (SQLCHAR*)table.c_str(),
+                     SQL_NTS,
+                     nullptr,
+                     0);
+    ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to execute SQLColumns";
+    int rows = 0;
+    while (SQLFetch(hStmt) == SQL_SUCCESS) {
+      rows++;
+    }
+    EXPECT_EQ(rows, expectedColumns) << table;
+    ret = SQLCloseCursor(hStmt);
+    ASSERT_EQ(ret, SQL_SUCCESS);
+  }
+  // One query for the schema answered both tables.
+  EXPECT_EQ(this->submittedQueries() - submittedBefore, 1);
+
+  // Forgetting the cached metadata is always allowed.
+  ret = SQLSetConnectAttr(
+      this->hDbc, SQL_ATTR_INVALIDATE_METADATA_CACHE, nullptr, 0);
+  EXPECT_EQ(ret, SQL_SUCCESS);
+
+  SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+}
+
+TEST_F(ColumnsTest, EscapedWildcardsMatchLiterally) {
+  /*
+  A backslash, the escape SQLGetInfo reports, makes _ and % literal, so
+  n\_% matches the columns whose names start with "n_".
+  */
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, this->hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to allocate statement handle";
+
+  std::string catalog = "tpch";
+  std::string schema  = "tiny";
+  std::string table   = "nation";
+  std::string column  = "n\\_%";
+
+  ret = SQLColumns(hStmt,
+                   (SQLCHAR*)catalog.c_str(),
+                   SQL_NTS,
+                   (SQLCHAR*)schema.c_str(),
+                   SQL_NTS,
+                   (SQLCHAR*)table.c_str(),
+                   SQL_NTS,
+                   (SQLCHAR*)column.c_str(),
+                   SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to execute SQLColumns";
+  int rows = 0;
+  while (SQLFetch(hStmt) == SQL_SUCCESS) {
+    rows++;
+  }
+  EXPECT_EQ(rows, 4);
+
+  SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+}
+
+TEST_F(ColumnsTest, CatalogIsNotAPattern) {
+  /*
+  The catalog of SQLColumns is taken literally, so tpc_ names a catalog
+  that doesn't exist rather than matching tpch.
+  */
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, this->hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to allocate statement handle";
+
+  std::string schema = "tiny";
+  std::string table  = "nation";
+
+  std::vector<std::pair<std::string, int>> catalogs = {{"tpc_", 0},
+                                                       {"tpch", 4}};
+  for (const auto& [catalog, expectedColumns] : catalogs) {
+    ret = SQLColumns(hStmt,
+                     (SQLCHAR*)catalog.c_str(),
+                     SQL_NTS,
+                     (SQLCHAR*)schema.c_str(),
+                     SQL_NTS,
+                     (SQLCHAR*)table.c_str(),
+                     SQL_NTS,
+                     nullptr,
+                     0);
+    int rows = 0;
+    if (ret == SQL_SUCCESS) {
+      while (SQLFetch(hStmt) == SQL_SUCCESS) {
+        rows++;
+      }
+      SQLCloseCursor(hStmt);
+    }
+    EXPECT_EQ(rows, expectedColumns) << catalog;
+  }
+
+  SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+}
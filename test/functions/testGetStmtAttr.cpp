@@ -0,0 +1,190 @@
+#include <windows.h>
+
+#include <gtest/gtest.h>
+#include <sql.h>
+#include <sqlext.h>
+#include <string>
+
+#include "../../src/driver/constants/statementAttrs.hpp"
+#include "../../src/trinoAPIWrapper/queryMetrics.hpp"
+#include "../fixtures/sqlDriverConnectFixture.hpp"
+
+class GetStmtAttrTest : public SQLDriverConnectFixture {};
+
+TEST_F(GetStmtAttrTest, QueryMetricsCountTheQuery) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, this->hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to allocate statement handle";
+
+  std::string query = "SELECT * FROM tpch.tiny.nation";
+  ret               = SQLExecDirect(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  SQLBIGINT nationKey = 0;
+  SQLLEN indicator    = 0;
+
+  ret = SQLBindCol(hStmt, 1, SQL_C_SBIGINT, &nationKey, 0, &indicator);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  int rows = 0;
+  while (SQLFetch(hStmt) == SQL_SUCCESS) {
+    rows++;
+  }
+  EXPECT_EQ(rows, 25);
+
+  QueryMetrics metrics;
+  SQLINTEGER length = 0;
+  ret               = SQLGetStmtAttr(
+      hStmt, SQL_ATTR_QUERY_METRICS, &metrics, sizeof(metrics), &length);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(length, sizeof(QueryMetrics));
+  EXPECT_GE(metrics.httpRequests, 2);
+  EXPECT_GE(metrics.pages, 1);
+  EXPECT_EQ(metrics.rowsReceived, 25);
+  EXPECT_GT(metrics.bytesDecompressed, 0);
+  EXPECT_GT(metrics.networkUs, 0);
+  EXPECT_GE(metrics.peakBufferedRows, 1);
+
+  // Closing the cursor starts the counters over.
+  ret = SQLCloseCursor(hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLGetStmtAttr(
+      hStmt, SQL_ATTR_QUERY_METRICS, &metrics, sizeof(metrics), &length);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(metrics.httpRequests, 0);
+
+  SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+}
+
+TEST_F(GetStmtAttrTest, QueryMetricsCoverEveryParameterSet) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, this->hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to allocate statement handle";
+
+  std::string query = "SELECT name FROM tpch.tiny.nation WHERE nationkey = ?";
+  ret               = SQLPrepare(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  // Each set of values is its own query.
+  SQLBIGINT nationKeys[3] = {0, 1, 2};
+  ret = SQLSetStmtAttr(hStmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)3, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLBindParameter(hStmt,
+                         1,
+                         SQL_PARAM_INPUT,
+                         SQL_C_SBIGINT,
+                         SQL_BIGINT,
+                         0,
+                         0,
+                         nationKeys,
+                         0,
+                         nullptr);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLExecute(hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  while (SQLFetch(hStmt) == SQL_SUCCESS) {
+  }
+
+  QueryMetrics metrics;
+  ret = SQLGetStmtAttr(
+      hStmt, SQL_ATTR_QUERY_METRICS, &metrics, sizeof(metrics), nullptr);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_GE(metrics.rowsReceived, 3);
+  EXPECT_GE(metrics.pages, 3);
+  EXPECT_GE(metrics.httpRequests, 6);
+
+  SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+}
+
+TEST_F(GetStmtAttrTest, QueryMetricsNeedRoomForTheStruct) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, this->hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to allocate statement handle";
+
+  QueryMetrics metrics;
+  ret = SQLGetStmtAttr(hStmt, SQL_ATTR_QUERY_METRICS, &metrics, 8, nullptr);
+  EXPECT_EQ(ret, SQL_ERROR);
+
+  SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+}
+
+TEST_F(GetStmtAttrTest, RowNumberFollowsTheFetches) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, this->hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to allocate statement handle";
+
+  // Parameter attributes set on the statement must not leak into the
+  // row number.
+  SQLLEN bindOffset = 0;
+  ret = SQLSetStmtAttr(hStmt, SQL_ATTR_PARAM_BIND_OFFSET_PTR, &bindOffset, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  std::string query = "SELECT * FROM tpch.tiny.nation";
+  ret               = SQLExecDirect(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  SQLULEN first     = 0;
+  SQLULEN second    = 0;
+  SQLINTEGER length = 0;
+  ASSERT_EQ(SQLFetch(hStmt), SQL_SUCCESS);
+  ret = SQLGetStmtAttr(hStmt, SQL_ATTR_ROW_NUMBER, &first, 0, &length);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(length, sizeof(SQLULEN*));
+  ASSERT_EQ(SQLFetch(hStmt), SQL_SUCCESS);
+  ret = SQLGetStmtAttr(hStmt, SQL_ATTR_ROW_NUMBER, &second, 0, &length);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(second, first + 1);
+  EXPECT_NE(first, reinterpret_cast<SQLULEN>(&bindOffset));
+
+  SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+}
+
+TEST_F(GetStmtAttrTest, ParamAttributesRoundTrip) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, this->hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to allocate statement handle";
+
+  SQLLEN bindOffset           = 0;
+  SQLUSMALLINT paramStatus[4] = {0};
+  SQLULEN paramsProcessed     = 0;
+  SQLPOINTER pointer          = nullptr;
+  SQLULEN number              = 0;
+  SQLINTEGER length           = 0;
+  SQLULEN rowSize             = 24;
+  SQLULEN paramsetSize        = 4;
+
+  ret = SQLSetStmtAttr(hStmt, SQL_ATTR_PARAM_BIND_OFFSET_PTR, &bindOffset, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLGetStmtAttr(
+      hStmt, SQL_ATTR_PARAM_BIND_OFFSET_PTR, &pointer, 0, &length);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(pointer, &bindOffset);
+  EXPECT_EQ(length, sizeof(SQLPOINTER));
+
+  ret = SQLSetStmtAttr(hStmt, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER)rowSize, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLGetStmtAttr(hStmt, SQL_ATTR_PARAM_BIND_TYPE, &number, 0, &length);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(number, rowSize);
+  EXPECT_EQ(length, sizeof(SQLULEN));
+
+  ret = SQLSetStmtAttr(hStmt, SQL_ATTR_PARAM_STATUS_PTR, paramStatus, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLGetStmtAttr(hStmt, SQL_ATTR_PARAM_STATUS_PTR, &pointer, 0, &length);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(pointer, paramStatus);
+  EXPECT_EQ(length, sizeof(SQLPOINTER));
+
+  ret = SQLSetStmtAttr(
+      hStmt, SQL_ATTR_PARAMS_PROCESSED_PTR, &paramsProcessed, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLGetStmtAttr(
+      hStmt, SQL_ATTR_PARAMS_PROCESSED_PTR, &pointer, 0, &length);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(pointer, &paramsProcessed);
+  EXPECT_EQ(length, sizeof(SQLPOINTER));
+
+  ret = SQLSetStmtAttr(
+      hStmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)paramsetSize, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLGetStmtAttr(hStmt, SQL_ATTR_PARAMSET_SIZE, &number, 0, &length);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(number, paramsetSize);
+  EXPECT_EQ(length, sizeof(SQLULEN));
+
+  SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+}
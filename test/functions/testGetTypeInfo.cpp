@@ -0,0 +1,58 @@
+#include <windows.h>
+
+#include <gtest/gtest.h>
+#include <sql.h>
+#include <sqlext.h>
+#include <string>
+
+#include "../constants.hpp"
+#include "../fixtures/sqlDriverConnectFixture.hpp"
+
+class GetTypeInfoTest : public SQLDriverConnectFixture {};
+
+TEST_F(GetTypeInfoTest, GetAllTypes) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, this->hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to allocate statement handle";
+
+  ret = SQLGetTypeInfo(hStmt, SQL_ALL_TYPES);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  SQLSMALLINT columns = 0;
+  ret                 = SQLNumResultCols(hStmt, &columns);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(columns, 19);
+
+  int rows = 0;
+  while (SQLFetch(hStmt) == SQL_SUCCESS) {
+    rows++;
+  }
+  EXPECT_EQ(rows, 14);
+
+  SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+}
+
+TEST_F(GetTypeInfoTest, StatementsShareTheSameAnswer) {
+  /*
+  The type information is built once and shared, so asking again on a
+  fresh statement has to give the same rows as the first time.
+  */
+  for (int attempt = 0; attempt < 2; attempt++) {
+    SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, this->hDbc, &hStmt);
+    ASSERT_EQ(ret, SQL_SUCCESS) << "Failed to allocate statement handle";
+
+    ret = SQLGetTypeInfo(hStmt, SQL_VARCHAR);
+    ASSERT_EQ(ret, SQL_SUCCESS);
+    ret = SQLFetch(hStmt);
+    ASSERT_EQ(ret, SQL_SUCCESS);
+
+    SQLCHAR typeName[64] = {0};
+    SQLSMALLINT dataType = 0;
+    SQLGetData(hStmt, 1, SQL_C_CHAR, typeName, sizeof(typeName), NULL);
+    SQLGetData(hStmt, 2, SQL_C_SSHORT, &dataType, 0, NULL);
+    EXPECT_STREQ(reinterpret_cast<const char*>(typeName), "VARCHAR");
+    EXPECT_EQ(dataType, SQL_VARCHAR);
+    EXPECT_EQ(SQLFetch(hStmt), SQL_NO_DATA);
+
+    SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+  }
+}
@@ -0,0 +1,187 @@
+#include <windows.h>
+
+#include <gtest/gtest.h>
+#include <sql.h>
+#include <sqlext.h>
+#include <string>
+
+#include "../constants.hpp"
+
+#include "../fixtures/sqlDriverConnectFixture.hpp"
+
+class SQLPrepareTest : public SQLDriverConnectFixture {};
+
+TEST_F(SQLPrepareTest, TestExecuteWithDifferentParameters) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  std::string query = "SELECT name FROM tpch.tiny.nation WHERE nationkey = ?";
+  ret               = SQLPrepare(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  SQLBIGINT nationKey = 0;
+  SQLLEN keyIndicator = 0;
+
+  ret = SQLBindParameter(hStmt,
+                         1,
+                         SQL_PARAM_INPUT,
+                         SQL_C_SBIGINT,
+                         SQL_BIGINT,
+                         0,
+                         0,
+                         &nationKey,
+                         0,
+                         &keyIndicator);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  char name[64]        = {0};
+  SQLLEN nameIndicator = 0;
+  ret = SQLBindCol(hStmt, 1, SQL_C_CHAR, name, sizeof(name), &nameIndicator);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  // The same prepared statement, executed twice with a new value.
+  ret = SQLExecute(hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLFetch(hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(std::string(name), "ALGERIA");
+  ret = SQLCloseCursor(hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  nationKey = 1;
+  ret       = SQLExecute(hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLFetch(hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(std::string(name), "ARGENTINA");
+
+  ret = SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+}
+
+TEST_F(SQLPrepareTest, TestExecuteWithoutPrepare) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  ret = SQLExecute(hStmt);
+  EXPECT_EQ(ret, SQL_ERROR);
+
+  ret = SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+}
+
+TEST_F(SQLPrepareTest, TestPrepareInvalidStatement) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  std::string query = "SELEC nothing";
+  ret               = SQLPrepare(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  EXPECT_EQ(ret, SQL_ERROR);
+
+  ret = SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+}
+
+TEST_F(SQLPrepareTest, TestDescribeBeforeExecute) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  std::string query = R"SQL(
+      SELECT nationkey, name
+      FROM tpch.tiny.nation
+      WHERE regionkey = ?
+  )SQL";
+  ret               = SQLPrepare(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  // The result shape comes from DESCRIBE OUTPUT, without executing.
+  SQLSMALLINT columnCount = 0;
+  ret                     = SQLNumResultCols(hStmt, &columnCount);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(columnCount, 2);
+
+  SQLCHAR columnName[64] = {0};
+  SQLSMALLINT nameLength = 0;
+  SQLSMALLINT dataType   = 0;
+  SQLULEN columnSize     = 0;
+  SQLSMALLINT digits     = 0;
+  SQLSMALLINT nullable   = 0;
+  ret                    = SQLDescribeCol(hStmt,
+                       2,
+                       columnName,
+                       sizeof(columnName),
+                       &nameLength,
+                       &dataType,
+                       &columnSize,
+                       &digits,
+                       &nullable);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(std::string((char*)columnName), "name");
+  EXPECT_EQ(dataType, SQL_VARCHAR);
+
+  // The parameters come from DESCRIBE INPUT.
+  SQLSMALLINT paramCount = 0;
+  ret                    = SQLNumParams(hStmt, &paramCount);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(paramCount, 1);
+
+  SQLSMALLINT paramType = 0;
+  SQLULEN paramSize     = 0;
+  ret = SQLDescribeParam(hStmt, 1, &paramType, &paramSize, &digits, &nullable);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(paramType, SQL_BIGINT);
+
+  ret = SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+}
+
+TEST_F(SQLPrepareTest, TestParameterArray) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  std::string query = "SELECT name FROM tpch.tiny.nation WHERE nationkey = ?";
+  ret               = SQLPrepare(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  // Three sets of values, bound column-wise.
+  SQLBIGINT nationKeys[3]  = {0, 1, 2};
+  SQLUSMALLINT statuses[3] = {0};
+  SQLULEN paramsProcessed  = 0;
+  ret = SQLSetStmtAttr(hStmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)3, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLSetStmtAttr(hStmt, SQL_ATTR_PARAM_STATUS_PTR, statuses, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLSetStmtAttr(
+      hStmt, SQL_ATTR_PARAMS_PROCESSED_PTR, &paramsProcessed, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLBindParameter(hStmt,
+                         1,
+                         SQL_PARAM_INPUT,
+                         SQL_C_SBIGINT,
+                         SQL_BIGINT,
+                         0,
+                         0,
+                         nationKeys,
+                         0,
+                         nullptr);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+
+  ret = SQLExecute(hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(paramsProcessed, 3);
+  for (SQLUSMALLINT status : statuses) {
+    EXPECT_EQ(status, SQL_PARAM_SUCCESS);
+  }
+
+  // The results are those of the last set of values.
+  char name[64]        = {0};
+  SQLLEN nameIndicator = 0;
+  ret = SQLBindCol(hStmt, 1, SQL_C_CHAR, name, sizeof(name), &nameIndicator);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLFetch(hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(std::string(name), "BRAZIL");
+
+  ret = SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+}
@@ -0,0 +1,129 @@
+#include <windows.h>
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <sql.h>
+#include <sqlext.h>
+#include <string>
+#include <thread>
+
+#include "../fixtures/sqlDriverConnectFixture.hpp"
+
+class SQLQueryLimitsTest : public SQLDriverConnectFixture {
+  protected:
+    // Marks this run's queries so system.runtime.queries can find them.
+    std::string marker =
+        "odbc_limits_" +
+        std::to_string(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+
+    // A query that runs for much longer than any of the tests wait.
+    std::string longQuery() {
+      return "SELECT orderkey FROM tpch.sf1000.lineitem /* " + this->marker +
+             " */";
+    }
+
+    std::string sqlState() {
+      SQLCHAR state[6] = {0};
+      SQLINTEGER nativeError;
+      SQLCHAR message[SQL_MAX_MESSAGE_LENGTH];
+      SQLSMALLINT messageLength;
+      SQLGetDiagRec(SQL_HANDLE_STMT,
+                    hStmt,
+                    1,
+                    state,
+                    &nativeError,
+                    message,
+                    sizeof(message),
+                    &messageLength);
+      return std::string(reinterpret_cast<char*>(state));
+    }
+
+    /*
+    The state Trino reports for the marked query, once it is no longer
+    running. Gives up after a while and returns the last state seen.
+    */
+    std::string serverStateOfMarkedQuery() {
+      SQLHSTMT stmt = nullptr;
+      EXPECT_EQ(SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &stmt), SQL_SUCCESS);
+      std::string sql = "SELECT state FROM system.runtime.queries "
+                        "WHERE query LIKE '%/* " +
+                        this->marker + " */' AND query LIKE 'SELECT orderkey%'";
+      std::string state;
+      auto giveUpAt =
+          std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (std::chrono::steady_clock::now() < giveUpAt) {
+        SQLRETURN ret = SQLExecDirect(stmt, (SQLCHAR*)sql.c_str(), SQL_NTS);
+        EXPECT_EQ(ret, SQL_SUCCESS);
+        SQLCHAR value[64] = {0};
+        SQLLEN indicator  = 0;
+        if (SQLFetch(stmt) == SQL_SUCCESS) {
+          SQLGetData(stmt, 1, SQL_C_CHAR, value, sizeof(value), &indicator);
+          state = reinterpret_cast<char*>(value);
+        }
+        SQLCloseCursor(stmt);
+        if (state == "FAILED" or state == "FINISHED") {
+          break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      }
+      SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+      return state;
+    }
+};
+
+TEST_F(SQLQueryLimitsTest, QueryTimeoutStopsTheQueryOnTheServer) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLSetStmtAttr(hStmt, SQL_ATTR_QUERY_TIMEOUT, (SQLPOINTER)1, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  SQLULEN timeout = 0;
+  ret = SQLGetStmtAttr(hStmt, SQL_ATTR_QUERY_TIMEOUT, &timeout, 0, nullptr);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(timeout, 1);
+
+  std::string query = this->longQuery();
+  auto started      = std::chrono::steady_clock::now();
+  ret               = SQLExecDirect(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  // The timeout may hit while executing or while fetching.
+  while (ret == SQL_SUCCESS) {
+    ret = SQLFetch(hStmt);
+  }
+  auto returned = std::chrono::steady_clock::now();
+
+  ASSERT_EQ(ret, SQL_ERROR);
+  EXPECT_EQ(this->sqlState(), "HYT00");
+  EXPECT_LT(returned - started, std::chrono::seconds(5));
+  // The driver sent the DELETE, so Trino failed the query.
+  EXPECT_EQ(this->serverStateOfMarkedQuery(), "FAILED");
+
+  ret = SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+}
+
+TEST_F(SQLQueryLimitsTest, MaxRowsTruncatesAndStopsTheQuery) {
+  SQLRETURN ret = SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  ret = SQLSetStmtAttr(hStmt, SQL_ATTR_MAX_ROWS, (SQLPOINTER)5, 0);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  SQLULEN maxRows = 0;
+  ret = SQLGetStmtAttr(hStmt, SQL_ATTR_MAX_ROWS, &maxRows, 0, nullptr);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(maxRows, 5);
+
+  std::string query = this->longQuery();
+  ret               = SQLExecDirect(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  int rows = 0;
+  while ((ret = SQLFetch(hStmt)) == SQL_SUCCESS) {
+    rows++;
+  }
+  EXPECT_EQ(ret, SQL_NO_DATA);
+  EXPECT_EQ(rows, 5);
+  // Without the rewrite to a LIMIT, Trino would have kept producing rows
+  // nobody reads. The driver terminated it instead.
+  EXPECT_EQ(this->serverStateOfMarkedQuery(), "FAILED");
+
+  ret = SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+}
@@ -0,0 +1,65 @@
+#include <windows.h>
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <sql.h>
+#include <sqlext.h>
+#include <vector>
+
+#include "../fixtures/sqlDriverConnectFixture.hpp"
+
+class SQLResultCacheTest : public SQLDriverConnectFixture {
+  protected:
+    void SetUp() override {
+      return SQLDriverConnectFixture::SetUp("resultCacheTtlMs=60000;");
+    }
+
+    std::vector<SQLBIGINT> fetchAll(SQLHSTMT stmt) {
+      std::vector<SQLBIGINT> values;
+      SQLBIGINT value  = 0;
+      SQLLEN indicator = 0;
+      SQLRETURN ret =
+          SQLBindCol(stmt, 1, SQL_C_SBIGINT, &value, 0, &indicator);
+      EXPECT_EQ(ret, SQL_SUCCESS);
+      while ((ret = SQLFetch(stmt)) == SQL_SUCCESS) {
+        values.push_back(value);
+      }
+      EXPECT_EQ(ret, SQL_NO_DATA);
+      return values;
+    }
+};
+
+TEST_F(SQLResultCacheTest, SameQueryOnOneConnectionDoesNotWait) {
+  SQLHSTMT first  = nullptr;
+  SQLHSTMT second = nullptr;
+  ASSERT_EQ(SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &first), SQL_SUCCESS);
+  ASSERT_EQ(SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &second), SQL_SUCCESS);
+  std::string query =
+      "SELECT nationkey FROM tpch.tiny.nation ORDER BY nationkey";
+
+  // The first statement leads the query, and its results are not read
+  // until the second statement has them.
+  SQLRETURN ret = SQLExecDirect(first, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  auto start = std::chrono::steady_clock::now();
+  ret        = SQLExecDirect(second, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::seconds(10));
+
+  std::vector<SQLBIGINT> secondRows = this->fetchAll(second);
+  std::vector<SQLBIGINT> firstRows  = this->fetchAll(first);
+  EXPECT_EQ(firstRows.size(), 25);
+  EXPECT_EQ(secondRows, firstRows);
+
+  // Now that the first statement read everything, the results are
+  // cached.
+  ASSERT_EQ(SQLFreeStmt(second, SQL_CLOSE), SQL_SUCCESS);
+  ASSERT_EQ(SQLFreeStmt(second, SQL_UNBIND), SQL_SUCCESS);
+  ret = SQLExecDirect(second, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(this->fetchAll(second), firstRows);
+
+  EXPECT_EQ(SQLFreeHandle(SQL_HANDLE_STMT, first), SQL_SUCCESS);
+  EXPECT_EQ(SQLFreeHandle(SQL_HANDLE_STMT, second), SQL_SUCCESS);
+}
@@ -0,0 +1,116 @@
+#include <windows.h>
+
+#include <gtest/gtest.h>
+#include <sql.h>
+#include <sqlext.h>
+#include <string>
+
+#include "../fixtures/sqlDriverConnectFixture.hpp"
+
+class SQLResultSchemaCacheTest : public SQLDriverConnectFixture {
+  protected:
+    const std::string table = "memory.default.odbc_result_schema_test";
+
+    void SetUp() override {
+      return SQLDriverConnectFixture::SetUp("resultSchemaCache=true;");
+    }
+
+    void TearDown() override {
+      if (hStmt) {
+        SQLFreeHandle(SQL_HANDLE_STMT, hStmt);
+      }
+      this->run("DROP TABLE IF EXISTS " + this->table);
+      SQLDriverConnectFixture::TearDown();
+    }
+
+    // Run a statement to completion on a statement handle of its own.
+    void run(std::string sql) {
+      SQLHSTMT stmt = nullptr;
+      ASSERT_EQ(SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &stmt), SQL_SUCCESS);
+      SQLRETURN ret = SQLExecDirect(stmt, (SQLCHAR*)sql.c_str(), SQL_NTS);
+      EXPECT_EQ(ret, SQL_SUCCESS) << sql;
+      while (SQLFetch(stmt) == SQL_SUCCESS) {
+      }
+      SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+    }
+
+    SQLSMALLINT columnCount() {
+      SQLSMALLINT count = 0;
+      EXPECT_EQ(SQLNumResultCols(hStmt, &count), SQL_SUCCESS);
+      return count;
+    }
+
+    std::string sqlState() {
+      SQLCHAR state[6] = {0};
+      SQLINTEGER nativeError;
+      SQLCHAR message[SQL_MAX_MESSAGE_LENGTH];
+      SQLSMALLINT messageLength;
+      SQLGetDiagRec(SQL_HANDLE_STMT,
+                    hStmt,
+                    1,
+                    state,
+                    &nativeError,
+                    message,
+                    sizeof(message),
+                    &messageLength);
+      return std::string(reinterpret_cast<char*>(state));
+    }
+};
+
+TEST_F(SQLResultSchemaCacheTest, FewerColumnsThanDescribedWarnWithoutRows) {
+  /*
+  The columns cached from the last run describe the results until Trino
+  sends the real ones. When the table lost a column in between, the
+  fetch that finds out warns with 01000, even when there are no rows.
+  */
+  std::string query = "SELECT * FROM " + this->table;
+  this->run("DROP TABLE IF EXISTS " + this->table);
+  this->run("CREATE TABLE " + this->table + " AS SELECT 1 AS a, 2 AS b");
+  ASSERT_EQ(SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt), SQL_SUCCESS);
+  SQLRETURN ret = SQLExecDirect(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(this->columnCount(), 2);
+  EXPECT_EQ(SQLFetch(hStmt), SQL_SUCCESS);
+  EXPECT_EQ(SQLFetch(hStmt), SQL_NO_DATA);
+  ASSERT_EQ(SQLCloseCursor(hStmt), SQL_SUCCESS);
+
+  this->run("DROP TABLE " + this->table);
+  this->run("CREATE TABLE " + this->table + " (a integer)");
+  ret = SQLExecDirect(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(SQLFetch(hStmt), SQL_NO_DATA);
+  EXPECT_EQ(this->sqlState(), "01000");
+  EXPECT_EQ(this->columnCount(), 1);
+
+  // The next run is described correctly from the start.
+  ASSERT_EQ(SQLCloseCursor(hStmt), SQL_SUCCESS);
+  ret = SQLExecDirect(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(this->columnCount(), 1);
+  EXPECT_EQ(SQLFetch(hStmt), SQL_NO_DATA);
+}
+
+TEST_F(SQLResultSchemaCacheTest, FewerColumnsThanDescribedWarnWithRows) {
+  std::string query = "SELECT * FROM " + this->table;
+  this->run("DROP TABLE IF EXISTS " + this->table);
+  this->run("CREATE TABLE " + this->table + " AS SELECT 1 AS a, 2 AS b");
+  ASSERT_EQ(SQLAllocHandle(SQL_HANDLE_STMT, hDbc, &hStmt), SQL_SUCCESS);
+  SQLRETURN ret = SQLExecDirect(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(SQLFetch(hStmt), SQL_SUCCESS);
+  ASSERT_EQ(SQLCloseCursor(hStmt), SQL_SUCCESS);
+
+  this->run("DROP TABLE " + this->table);
+  this->run("CREATE TABLE " + this->table + " AS SELECT 7 AS a");
+  ret = SQLExecDirect(hStmt, (SQLCHAR*)query.c_str(), SQL_NTS);
+  ASSERT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(SQLFetch(hStmt), SQL_SUCCESS_WITH_INFO);
+  EXPECT_EQ(this->sqlState(), "01000");
+  EXPECT_EQ(this->columnCount(), 1);
+  SQLINTEGER value = 0;
+  SQLLEN indicator = 0;
+  ret = SQLGetData(hStmt, 1, SQL_C_SLONG, &value, 0, &indicator);
+  EXPECT_EQ(ret, SQL_SUCCESS);
+  EXPECT_EQ(value, 7);
+  EXPECT_EQ(SQLFetch(hStmt), SQL_NO_DATA);
+}
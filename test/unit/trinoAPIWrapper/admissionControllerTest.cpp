@@ -0,0 +1,163 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../../src/trinoAPIWrapper/admissionController.hpp"
+
+/*
+Threads that stay alive for the whole test, to hold slots. A thread that
+already holds a slot never waits, so limits are only tested across
+holders, and the ids of finished threads may be reused.
+*/
+class Holders {
+  public:
+    Holders(int count) {
+      for (int i = 0; i < count; i++) {
+        this->threads.emplace_back([this]() {
+          std::unique_lock<std::mutex> lock(this->mutex);
+          this->finished.wait(lock, [this]() { return this->done; });
+        });
+      }
+    }
+    ~Holders() {
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->done = true;
+      }
+      this->finished.notify_all();
+      for (std::thread& thread : this->threads) {
+        thread.join();
+      }
+    }
+    std::thread::id operator[](int i) {
+      return this->threads[i].get_id();
+    }
+
+  private:
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+    std::vector<std::thread> threads;
+};
+
+TEST(AdmissionControllerTest, UnlimitedNeverWaits) {
+  AdmissionController controller;
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(controller.acquire("a", 0, 0, 1));
+  }
+  EXPECT_EQ(controller.getRunningCount(), 100);
+  for (int i = 0; i < 100; i++) {
+    controller.release("a");
+  }
+  EXPECT_EQ(controller.getRunningCount(), 0);
+}
+
+TEST(AdmissionControllerTest, ProcessLimitTimesOut) {
+  AdmissionController controller;
+  Holders holders(3);
+  EXPECT_TRUE(controller.acquire("a", 2, 0, 10, nullptr, holders[0]));
+  EXPECT_TRUE(controller.acquire("b", 2, 0, 10, nullptr, holders[1]));
+  EXPECT_FALSE(controller.acquire("c", 2, 0, 10, nullptr, holders[2]));
+  EXPECT_EQ(controller.getWaitingCount(), 0);
+  controller.release("a", holders[0]);
+  EXPECT_TRUE(controller.acquire("c", 2, 0, 10, nullptr, holders[2]));
+}
+
+TEST(AdmissionControllerTest, EndpointLimitOnlyAffectsThatEndpoint) {
+  AdmissionController controller;
+  Holders holders(3);
+  EXPECT_TRUE(controller.acquire("a", 0, 1, 10, nullptr, holders[0]));
+  EXPECT_FALSE(controller.acquire("a", 0, 1, 10, nullptr, holders[1]));
+  EXPECT_TRUE(controller.acquire("b", 0, 1, 10, nullptr, holders[2]));
+}
+
+TEST(AdmissionControllerTest, AThreadNeverWaitsOnItsOwnSlot) {
+  // Like a single threaded application that executes a statement before
+  // reading all of another one's results.
+  AdmissionController controller;
+  EXPECT_TRUE(controller.acquire("a", 1, 0, 10000));
+  auto started = std::chrono::steady_clock::now();
+  EXPECT_TRUE(controller.acquire("a", 1, 0, 10000));
+  EXPECT_LT(std::chrono::steady_clock::now() - started,
+            std::chrono::seconds(1));
+  EXPECT_EQ(controller.getRunningCount(), 2);
+
+  // Other threads still wait for the limit.
+  Holders holders(1);
+  EXPECT_FALSE(controller.acquire("a", 1, 0, 10, nullptr, holders[0]));
+  controller.release("a");
+  controller.release("a");
+  EXPECT_TRUE(controller.acquire("a", 1, 0, 10, nullptr, holders[0]));
+}
+
+TEST(AdmissionControllerTest, StopWaitingEndsTheWait) {
+  AdmissionController controller;
+  EXPECT_TRUE(controller.acquire("a", 1, 0, 10));
+  std::atomic<bool> stop     = false;
+  std::atomic<bool> admitted = true;
+  std::thread waiter([&]() {
+    admitted = controller.acquire(
+        "a", 1, 0, 60000, [&]() { return stop.load(); });
+  });
+  while (controller.getWaitingCount() == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  auto stopped = std::chrono::steady_clock::now();
+  stop         = true;
+  controller.wakeWaiters();
+  waiter.join();
+  EXPECT_LT(std::chrono::steady_clock::now() - stopped,
+            std::chrono::seconds(1));
+  EXPECT_FALSE(admitted);
+  EXPECT_EQ(controller.getWaitingCount(), 0);
+  EXPECT_EQ(controller.getRunningCount(), 1);
+}
+
+TEST(AdmissionControllerTest, ReleaseWakesWaiter) {
+  AdmissionController controller;
+  EXPECT_TRUE(controller.acquire("a", 1, 0, 10));
+  std::atomic<bool> admitted = false;
+  std::thread waiter([&]() {
+    admitted = controller.acquire("a", 1, 0, 10000);
+  });
+  while (controller.getWaitingCount() == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_FALSE(admitted);
+  controller.release("a");
+  waiter.join();
+  EXPECT_TRUE(admitted);
+  EXPECT_EQ(controller.getRunningCount(), 1);
+}
+
+TEST(AdmissionControllerTest, WaitersAreAdmittedInOrder) {
+  AdmissionController controller;
+  EXPECT_TRUE(controller.acquire("a", 1, 0, 10));
+
+  std::mutex orderMutex;
+  std::vector<int> order;
+  std::vector<std::thread> waiters;
+  for (int i = 0; i < 5; i++) {
+    waiters.emplace_back([&, i]() {
+      EXPECT_TRUE(controller.acquire("a", 1, 0, 10000));
+      {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(i);
+      }
+      controller.release("a");
+    });
+    // Make sure each waiter is in line before starting the next.
+    while (controller.getWaitingCount() < i + 1) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  controller.release("a");
+  for (std::thread& waiter : waiters) {
+    waiter.join();
+  }
+  EXPECT_EQ(order, std::vector<int>({0, 1, 2, 3, 4}));
+}
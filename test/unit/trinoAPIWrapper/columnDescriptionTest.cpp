@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include "../../../src/trinoAPIWrapper/columnDescription.hpp"
+
+TEST(ColumnDescriptionTest, SimpleType) {
+  ColumnDescription description(columnJsonFromType("id", "bigint"));
+  EXPECT_EQ(description.getName(), "id");
+  EXPECT_EQ(description.getType(), "bigint");
+  EXPECT_EQ(description.getRawType(), "bigint");
+  EXPECT_TRUE(description.getTypeArguments().empty());
+}
+
+TEST(ColumnDescriptionTest, NumericArguments) {
+  ColumnDescription varchar(columnJsonFromType("name", "varchar(25)"));
+  EXPECT_EQ(varchar.getRawType(), "varchar");
+  EXPECT_EQ(varchar.getTypeArguments()[0]["value"], 25);
+
+  ColumnDescription decimal(columnJsonFromType("price", "decimal(12,2)"));
+  EXPECT_EQ(decimal.getRawType(), "decimal");
+  EXPECT_EQ(decimal.getTypeArguments()[0]["value"], 12);
+  EXPECT_EQ(decimal.getTypeArguments()[1]["value"], 2);
+}
+
+TEST(ColumnDescriptionTest, ArgumentInsideName) {
+  ColumnDescription description(
+      columnJsonFromType("at", "timestamp(3) with time zone"));
+  EXPECT_EQ(description.getRawType(), "timestamp with time zone");
+  EXPECT_EQ(description.getTypeArguments()[0]["value"], 3);
+}
+
+TEST(ColumnDescriptionTest, UnboundedVarchar) {
+  ColumnDescription description(columnJsonFromType("comment", "varchar"));
+  EXPECT_EQ(description.getRawType(), "varchar");
+  EXPECT_EQ(description.getTypeArguments()[0]["value"], 2147483647);
+}
+
+TEST(ColumnDescriptionTest, ContainerType) {
+  ColumnDescription description(
+      columnJsonFromType("tags", "array(varchar(10))"));
+  EXPECT_EQ(description.getRawType(), "array");
+  EXPECT_TRUE(description.getTypeArguments().empty());
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "../../../src/trinoAPIWrapper/endpointSelector.hpp"
+
+TEST(EndpointSelectorTest, ParseEmptyListKeepsPrimary) {
+  std::vector<Endpoint> endpoints =
+      parseEndpointList("https://trino.example.com", 443, "");
+  ASSERT_EQ(endpoints.size(), 1);
+  EXPECT_EQ(endpoints[0].baseUrl, "https://trino.example.com:443");
+  EXPECT_EQ(endpoints[0].statementUrl,
+            "https://trino.example.com:443/v1/statement");
+}
+
+TEST(EndpointSelectorTest, ParseListWithAndWithoutPorts) {
+  std::vector<Endpoint> endpoints =
+      parseEndpointList("https://a.example.com",
+                        443,
+                        "https://b.example.com:8443, https://c.example.com");
+  ASSERT_EQ(endpoints.size(), 3);
+  EXPECT_EQ(endpoints[0].baseUrl, "https://a.example.com:443");
+  EXPECT_EQ(endpoints[1].hostname, "https://b.example.com");
+  EXPECT_EQ(endpoints[1].port, 8443);
+  EXPECT_EQ(endpoints[2].baseUrl, "https://c.example.com:443");
+}
+
+TEST(EndpointSelectorTest, ParseListSkipsDuplicates) {
+  std::vector<Endpoint> endpoints =
+      parseEndpointList("http://localhost",
+                        8080,
+                        "http://localhost:8080,http://localhost,"
+                        "http://localhost:8081");
+  ASSERT_EQ(endpoints.size(), 2);
+  EXPECT_EQ(endpoints[1].baseUrl, "http://localhost:8081");
+}
+
+TEST(EndpointSelectorTest, ParseListSkipsPortsOutOfRange) {
+  std::vector<Endpoint> endpoints =
+      parseEndpointList("http://localhost",
+                        8080,
+                        "http://a.example.com:70000,"
+                        "http://b.example.com:0,"
+                        "http://c.example.com:99999999999999999999999,"
+                        "http://d.example.com:65535");
+  ASSERT_EQ(endpoints.size(), 2);
+  EXPECT_EQ(endpoints[0].baseUrl, "http://localhost:8080");
+  EXPECT_EQ(endpoints[1].baseUrl, "http://d.example.com:65535");
+}
+
+TEST(EndpointSelectorTest, EndpointUnavailable) {
+  EXPECT_TRUE(isEndpointUnavailable(CURLE_COULDNT_CONNECT, 0));
+  EXPECT_TRUE(isEndpointUnavailable(CURLE_COULDNT_RESOLVE_HOST, 0));
+  EXPECT_TRUE(isEndpointUnavailable(CURLE_OK, 503));
+  // These may have reached a coordinator, so resubmitting isn't safe.
+  EXPECT_FALSE(isEndpointUnavailable(CURLE_OPERATION_TIMEDOUT, 0));
+  EXPECT_FALSE(isEndpointUnavailable(CURLE_OK, 502));
+  EXPECT_FALSE(isEndpointUnavailable(CURLE_OK, 200));
+}
+
+TEST(EndpointSelectorTest, ListOrderUntilLatencyIsKnown) {
+  EndpointSelector selector(
+      parseEndpointList("http://a", 8080, "http://b,http://c"));
+  EXPECT_EQ(selector.selectEndpoint(), 0);
+  selector.reportFailure(0);
+  EXPECT_EQ(selector.selectEndpoint(), 1);
+}
+
+TEST(EndpointSelectorTest, PrefersFastestHealthyEndpoint) {
+  EndpointSelector selector(
+      parseEndpointList("http://a", 8080, "http://b,http://c"));
+  selector.recordProbe(0, true, 50);
+  selector.recordProbe(1, true, 10);
+  selector.recordProbe(2, true, 20);
+  EXPECT_EQ(selector.selectEndpoint(), 1);
+  selector.recordProbe(1, false, 0);
+  EXPECT_EQ(selector.selectEndpoint(), 2);
+  selector.recordProbe(1, true, 10);
+  EXPECT_EQ(selector.selectEndpoint(), 1);
+}
+
+TEST(EndpointSelectorTest, SkipsTriedEndpoints) {
+  EndpointSelector selector(
+      parseEndpointList("http://a", 8080, "http://b,http://c"));
+  EXPECT_EQ(selector.selectEndpoint({0}), 1);
+  EXPECT_EQ(selector.selectEndpoint({0, 1}), 2);
+  EXPECT_EQ(selector.selectEndpoint({0, 1, 2}), 0);
+}
+
+TEST(EndpointSelectorTest, FallsBackToListOrderWhenAllUnavailable) {
+  EndpointSelector selector(
+      parseEndpointList("http://a", 8080, "http://b,http://c"));
+  selector.reportFailure(0);
+  selector.reportFailure(1);
+  selector.reportFailure(2);
+  EXPECT_EQ(selector.selectEndpoint(), 0);
+  EXPECT_EQ(selector.selectEndpoint({0}), 1);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "../../../src/trinoAPIWrapper/httpTimings.hpp"
+
+using json = nlohmann::json;
+
+TEST(HttpTimingsTest, EndpointIsSchemeHostAndPort) {
+  EXPECT_EQ(httpEndpointOf("https://trino:8443/v1/statement/q/1"),
+            "https://trino:8443");
+  EXPECT_EQ(httpEndpointOf("http://trino"), "http://trino");
+  EXPECT_EQ(httpEndpointOf("https://idp.example.com?x=1"),
+            "https://idp.example.com");
+}
+
+TEST(HttpTimingsTest, KeepsTimingsPerEndpointAndKind) {
+  HttpTimingRegistry registry;
+  HttpRequestTiming newConnection;
+  newConnection.newConnection = true;
+  newConnection.dnsUs         = 500;
+  newConnection.connectUs     = 1000;
+  newConnection.tlsUs         = 8000;
+  newConnection.firstByteUs   = 20000;
+  newConnection.transferUs    = 3000;
+  newConnection.totalUs       = 32500;
+  newConnection.bytesReceived = 4096;
+  HttpRequestTiming reused;
+  reused.firstByteUs   = 15000;
+  reused.transferUs    = 2000;
+  reused.totalUs       = 17000;
+  reused.bytesReceived = 8192;
+
+  registry.record("https://a:443", HttpPagePoll, newConnection);
+  registry.record("https://a:443", HttpPagePoll, reused);
+  registry.record("https://a:443", HttpSubmit, reused);
+  registry.record("https://b:443", HttpAuth, newConnection);
+
+  json timings = json::parse(registry.toJson());
+  json poll    = timings["https://a:443"]["poll"];
+  EXPECT_EQ(poll["requests"], 2);
+  EXPECT_EQ(poll["newConnections"], 1);
+  // Connection phases only count requests that opened a connection.
+  EXPECT_EQ(poll["tlsUs"]["count"], 1);
+  EXPECT_EQ(poll["tlsUs"]["max"], 8000);
+  EXPECT_EQ(poll["firstByteUs"]["count"], 2);
+  EXPECT_EQ(poll["firstByteUs"]["max"], 20000);
+  EXPECT_EQ(poll["bytesReceived"]["min"], 4096);
+  EXPECT_EQ(timings["https://a:443"]["submit"]["requests"], 1);
+  EXPECT_EQ(timings["https://b:443"]["auth"]["newConnections"], 1);
+  EXPECT_FALSE(timings["https://b:443"].contains("poll"));
+
+  std::string summary = registry.summary();
+  EXPECT_NE(summary.find("https://a:443 poll: 2 requests"), std::string::npos);
+
+  registry.clear();
+  EXPECT_EQ(registry.toJson(), "{}");
+}
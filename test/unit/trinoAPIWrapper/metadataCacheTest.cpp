@@ -0,0 +1,42 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "../../../src/trinoAPIWrapper/metadataCache.hpp"
+
+TEST(MetadataCacheTest, ReturnsStoredResult) {
+  MetadataCache cache;
+  EXPECT_FALSE(cache.get("a", 1000).has_value());
+  cache.put("a", json({{"data", json::array({1})}}));
+  EXPECT_EQ(cache.get("a", 1000).value()["data"], json::array({1}));
+}
+
+TEST(MetadataCacheTest, ExpiresByCallerTtl) {
+  MetadataCache cache;
+  cache.put("a", json::object());
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(cache.get("a", 5).has_value());
+  EXPECT_TRUE(cache.get("a", 60000).has_value());
+}
+
+TEST(MetadataCacheTest, InvalidatesByPrefix) {
+  MetadataCache cache;
+  cache.put("one|tables", json::object());
+  cache.put("one|columns", json::object());
+  cache.put("two|tables", json::object());
+  cache.invalidate("one|");
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_TRUE(cache.get("two|tables", 60000).has_value());
+}
+
+TEST(MetadataCacheTest, DropsOldestOverCapacity) {
+  MetadataCache cache(2);
+  cache.put("a", json::object());
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  cache.put("b", json::object());
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  cache.put("c", json::object());
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_FALSE(cache.get("a", 60000).has_value());
+  EXPECT_TRUE(cache.get("c", 60000).has_value());
+}
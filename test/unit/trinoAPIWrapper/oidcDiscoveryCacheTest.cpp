@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+
+#include "../../../src/trinoAPIWrapper/authProvider/oidcDiscoveryCache.hpp"
+
+static const long long DEFAULT_TTL_S = 3600;
+
+static long long lifetimeOf(std::map<std::string, std::string> headers) {
+  return getCacheLifetimeSeconds(headers, DEFAULT_TTL_S);
+}
+
+TEST(OidcDiscoveryCacheTest, NoCacheControlUsesTheDefault) {
+  EXPECT_EQ(lifetimeOf({}), DEFAULT_TTL_S);
+  EXPECT_EQ(lifetimeOf({{"Content-Type", "application/json"}}),
+            DEFAULT_TTL_S);
+  EXPECT_EQ(getCacheLifetimeSeconds({}, 0), 0);
+}
+
+TEST(OidcDiscoveryCacheTest, NoStoreAndNoCacheAreNotCached) {
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "no-store"}}), 0);
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "no-cache"}}), 0);
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "max-age=600, no-store"}}), 0);
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "no-cache, max-age=600"}}), 0);
+}
+
+TEST(OidcDiscoveryCacheTest, MaxAgeIsUsed) {
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "max-age=600"}}), 600);
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "public, max-age=600"}}), 600);
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "max-age=600, public"}}), 600);
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "max-age=0"}}), 0);
+}
+
+TEST(OidcDiscoveryCacheTest, MalformedMaxAgeUsesTheDefault) {
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "max-age="}}), DEFAULT_TTL_S);
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "max-age=soon"}}), DEFAULT_TTL_S);
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "max-age=60s"}}), DEFAULT_TTL_S);
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "max-age=99999999999999999999"}}),
+            DEFAULT_TTL_S);
+  EXPECT_EQ(lifetimeOf({{"Cache-Control", "public"}}), DEFAULT_TTL_S);
+}
+
+TEST(OidcDiscoveryCacheTest, HeaderNamesAndValuesIgnoreCase) {
+  EXPECT_EQ(lifetimeOf({{"cache-control", "max-age=600"}}), 600);
+  EXPECT_EQ(lifetimeOf({{"CACHE-CONTROL", "Max-Age=600"}}), 600);
+  EXPECT_EQ(lifetimeOf({{"Cache-control", "No-Store"}}), 0);
+}
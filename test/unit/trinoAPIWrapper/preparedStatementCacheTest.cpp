@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "../../../src/trinoAPIWrapper/preparedStatementCache.hpp"
+
+TEST(PreparedStatementCacheTest, FindsStatementByTextAndName) {
+  PreparedStatementCache cache(4);
+  EXPECT_FALSE(cache.findName("SELECT ?").has_value());
+  EXPECT_TRUE(cache.add("SELECT ?", "s1=SELECT+%3F"));
+  EXPECT_EQ(cache.findName("SELECT ?").value(), "s1");
+  EXPECT_EQ(cache.getHeader("s1"), "s1=SELECT+%3F");
+  EXPECT_EQ(cache.getHeader("s2"), "");
+}
+
+TEST(PreparedStatementCacheTest, RejectsMalformedHeader) {
+  PreparedStatementCache cache(4);
+  EXPECT_FALSE(cache.add("SELECT 1", "no separator"));
+  EXPECT_FALSE(cache.add("SELECT 1", "=SELECT+1"));
+  EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(PreparedStatementCacheTest, EvictsLeastRecentlyUsed) {
+  PreparedStatementCache cache(2);
+  cache.add("SELECT 1", "s1=SELECT+1");
+  cache.add("SELECT 2", "s2=SELECT+2");
+  // Using s1 makes s2 the oldest.
+  EXPECT_EQ(cache.getHeader("s1"), "s1=SELECT+1");
+  cache.add("SELECT 3", "s3=SELECT+3");
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.getHeader("s2"), "");
+  EXPECT_FALSE(cache.findName("SELECT 2").has_value());
+  EXPECT_EQ(cache.findName("SELECT 1").value(), "s1");
+  EXPECT_EQ(cache.findName("SELECT 3").value(), "s3");
+}
+
+TEST(PreparedStatementCacheTest, ReplacesStatementWithSameText) {
+  PreparedStatementCache cache(4);
+  cache.add("SELECT 1", "s1=SELECT+1");
+  cache.add("SELECT 1", "s2=SELECT+1");
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.findName("SELECT 1").value(), "s2");
+  EXPECT_EQ(cache.getHeader("s1"), "");
+}
+
+TEST(PreparedStatementCacheTest, ShrinkingEvicts) {
+  PreparedStatementCache cache(4);
+  cache.add("SELECT 1", "s1=SELECT+1");
+  cache.add("SELECT 2", "s2=SELECT+2");
+  cache.add("SELECT 3", "s3=SELECT+3");
+  cache.setCapacity(1);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.getHeader("s3"), "s3=SELECT+3");
+}
+
+TEST(PreparedStatementCacheTest, NamesAreUnique) {
+  PreparedStatementCache cache;
+  EXPECT_NE(cache.newName(), cache.newName());
+}
+
+TEST(PreparedStatementCacheTest, KeepsDescriptionsWithStatement) {
+  PreparedStatementCache cache(1);
+  cache.add("SELECT 1", "s1=SELECT+1");
+  EXPECT_FALSE(cache.getDescription("s1", "OUTPUT").has_value());
+  cache.setDescription("s1", "OUTPUT", json::array({"a"}));
+  EXPECT_EQ(cache.getDescription("s1", "OUTPUT").value(), json::array({"a"}));
+  EXPECT_FALSE(cache.getDescription("s1", "INPUT").has_value());
+  // Evicting the statement forgets its descriptions too.
+  cache.add("SELECT 2", "s2=SELECT+2");
+  EXPECT_FALSE(cache.getDescription("s1", "OUTPUT").has_value());
+}
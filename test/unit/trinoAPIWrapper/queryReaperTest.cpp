@@ -0,0 +1,109 @@
+#include <winsock2.h>
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../../../src/trinoAPIWrapper/queryReaper.hpp"
+
+// A server that takes connections but never answers them, so a DELETE
+// sent to it stays in flight until the server goes away.
+class SilentServer {
+  public:
+    SilentServer() {
+      this->listener          = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+      sockaddr_in address     = {};
+      address.sin_family      = AF_INET;
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      address.sin_port        = 0;
+      bind(this->listener,
+           reinterpret_cast<sockaddr*>(&address),
+           sizeof(address));
+      listen(this->listener, SOMAXCONN);
+      int length = sizeof(address);
+      getsockname(
+          this->listener, reinterpret_cast<sockaddr*>(&address), &length);
+      this->port = ntohs(address.sin_port);
+    }
+
+    ~SilentServer() {
+      this->close();
+    }
+
+    // Connections that were never accepted are reset.
+    void close() {
+      if (this->listener != INVALID_SOCKET) {
+        closesocket(this->listener);
+        this->listener = INVALID_SOCKET;
+      }
+    }
+
+    std::string nextUri() {
+      return "http://127.0.0.1:" + std::to_string(this->port) +
+             "/v1/statement/executing/test/1";
+    }
+
+  private:
+    SOCKET listener;
+    unsigned short port = 0;
+};
+
+static long long
+millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+class QueryReaperTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      WSADATA wsaData;
+      WSAStartup(MAKEWORD(2, 2), &wsaData);
+    }
+
+    void TearDown() override {
+      drainQueryReaper(0);
+      WSACleanup();
+    }
+};
+
+TEST_F(QueryReaperTest, QueuingATerminationDoesNotWaitForIt) {
+  SilentServer server;
+  auto start = std::chrono::steady_clock::now();
+  reapQuery(server.nextUri(), {{"X-Trino-User", "test"}});
+  reapQuery(server.nextUri(), {{"X-Trino-User", "test"}});
+  EXPECT_LT(millisecondsSince(start), 500);
+}
+
+TEST_F(QueryReaperTest, DrainGivesUpAfterItsTimeout) {
+  SilentServer server;
+  reapQuery(server.nextUri(), {});
+  // The DELETE can't finish, so the drain waits out its whole timeout
+  // and no longer.
+  auto start = std::chrono::steady_clock::now();
+  drainQueryReaper(300);
+  long long elapsedMs = millisecondsSince(start);
+  EXPECT_GE(elapsedMs, 300);
+  EXPECT_LT(elapsedMs, 3000);
+}
+
+TEST_F(QueryReaperTest, DrainReturnsOnceTheTerminationsFinish) {
+  SilentServer server;
+  reapQuery(server.nextUri(), {});
+  server.close();
+  auto start = std::chrono::steady_clock::now();
+  drainQueryReaper(10000);
+  EXPECT_LT(millisecondsSince(start), 5000);
+}
+
+TEST_F(QueryReaperTest, TheReaperStartsAgainAfterADrain) {
+  SilentServer server;
+  reapQuery(server.nextUri(), {});
+  drainQueryReaper(0);
+  reapQuery(server.nextUri(), {});
+  server.close();
+  auto start = std::chrono::steady_clock::now();
+  drainQueryReaper(10000);
+  EXPECT_LT(millisecondsSince(start), 5000);
+}
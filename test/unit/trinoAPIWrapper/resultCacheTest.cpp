@@ -0,0 +1,221 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+#include "../../../src/trinoAPIWrapper/resultCache.hpp"
+
+static ConnectionOptions cacheOptions(long ttlMs, long maxBytes) {
+  ConnectionOptions options;
+  options.resultCacheTtlMs    = ttlMs;
+  options.resultCacheMaxBytes = maxBytes;
+  return options;
+}
+
+static std::shared_ptr<const SyntheticResultSet> oneRow(int value) {
+  auto result     = std::make_shared<SyntheticResultSet>();
+  result->columns = {json({{"name", "x"}, {"type", "integer"}})};
+  result->rows    = {json::array({value})};
+  return result;
+}
+
+TEST(ResultCacheTest, AnswersUntilResultsExpire) {
+  ResultCache cache;
+  ConnectionOptions options = cacheOptions(20, 1000);
+  bool leader               = false;
+  EXPECT_EQ(cache.getOrLead("a", options, leader), nullptr);
+  EXPECT_TRUE(leader);
+  cache.complete("a", oneRow(1), 10, options);
+
+  auto cached = cache.getOrLead("a", options, leader);
+  ASSERT_NE(cached, nullptr);
+  EXPECT_FALSE(leader);
+  EXPECT_EQ(cached->rows[0][0], 1);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  EXPECT_EQ(cache.getOrLead("a", options, leader), nullptr);
+  EXPECT_TRUE(leader);
+  EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(ResultCacheTest, EvictsLeastRecentlyUsedByBytes) {
+  ResultCache cache;
+  ConnectionOptions options = cacheOptions(60000, 25);
+  bool leader               = false;
+  cache.getOrLead("a", options, leader);
+  cache.complete("a", oneRow(1), 10, options);
+  cache.getOrLead("b", options, leader);
+  cache.complete("b", oneRow(2), 10, options);
+  // Using a makes b the least recently used.
+  EXPECT_NE(cache.getOrLead("a", options, leader), nullptr);
+  cache.getOrLead("c", options, leader);
+  cache.complete("c", oneRow(3), 10, options);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.bytes(), 20);
+  EXPECT_NE(cache.getOrLead("a", options, leader), nullptr);
+  EXPECT_EQ(cache.getOrLead("b", options, leader), nullptr);
+  EXPECT_TRUE(leader);
+  cache.abandon("b");
+
+  // Results larger than the whole cache are never kept.
+  cache.getOrLead("d", options, leader);
+  cache.complete("d", oneRow(4), 100, options);
+  EXPECT_EQ(cache.getOrLead("d", options, leader), nullptr);
+  EXPECT_TRUE(leader);
+}
+
+TEST(ResultCacheTest, FollowersWaitForTheLeader) {
+  ResultCache cache;
+  ConnectionOptions options = cacheOptions(60000, 1000);
+  bool leader               = false;
+  EXPECT_EQ(cache.getOrLead("a", options, leader), nullptr);
+  ASSERT_TRUE(leader);
+
+  std::atomic<int> answered = 0;
+  std::thread follower([&]() {
+    bool followerLeads = false;
+    auto cached        = cache.getOrLead("a", options, followerLeads);
+    if (cached and not followerLeads) {
+      answered = cached->rows[0][0].get<int>();
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(answered, 0);
+  cache.complete("a", oneRow(7), 10, options);
+  follower.join();
+  EXPECT_EQ(answered, 7);
+}
+
+TEST(ResultCacheTest, AbandonedQueryPassesToAFollower) {
+  ResultCache cache;
+  ConnectionOptions options = cacheOptions(60000, 1000);
+  bool leader               = false;
+  cache.getOrLead("a", options, leader);
+  ASSERT_TRUE(leader);
+
+  std::atomic<bool> followerLeads = false;
+  std::thread follower([&]() {
+    bool leads = false;
+    EXPECT_EQ(cache.getOrLead("a", options, leads), nullptr);
+    followerLeads = leads;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  cache.abandon("a");
+  follower.join();
+  EXPECT_TRUE(followerLeads);
+}
+
+TEST(ResultCacheTest, FollowersStopWaitingAfterTimeout) {
+  ResultCache cache(10);
+  ConnectionOptions options = cacheOptions(60000, 1000);
+  bool leader               = false;
+  cache.getOrLead("a", options, leader);
+  ASSERT_TRUE(leader);
+
+  std::atomic<bool> followerLeads = true;
+  std::thread follower([&]() {
+    bool leads = true;
+    EXPECT_EQ(cache.getOrLead("a", options, leads), nullptr);
+    followerLeads = leads;
+  });
+  follower.join();
+  EXPECT_FALSE(followerLeads);
+}
+
+TEST(ResultCacheTest, SameOwnerOrThreadDoesNotWait) {
+  // Long enough that a wait would fail the test.
+  ResultCache cache(60000);
+  ConnectionOptions options = cacheOptions(60000, 1000);
+  int connection            = 0;
+  bool leader               = false;
+  cache.getOrLead("a", options, leader, &connection);
+  ASSERT_TRUE(leader);
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(cache.getOrLead("a", options, leader), nullptr);
+  EXPECT_FALSE(leader);
+  std::thread sameConnection([&]() {
+    bool leads = true;
+    EXPECT_EQ(cache.getOrLead("a", options, leads, &connection), nullptr);
+    EXPECT_FALSE(leads);
+  });
+  sameConnection.join();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(ResultCacheTest, StopWaitingEndsTheWait) {
+  ResultCache cache(60000);
+  ConnectionOptions options = cacheOptions(60000, 1000);
+  bool leader               = false;
+  cache.getOrLead("a", options, leader);
+  ASSERT_TRUE(leader);
+
+  std::atomic<bool> canceled = false;
+  std::atomic<bool> waiting  = true;
+  std::thread follower([&]() {
+    bool leads       = true;
+    auto stopWaiting = [&]() { return canceled.load(); };
+    EXPECT_EQ(cache.getOrLead("a", options, leads, nullptr, stopWaiting),
+              nullptr);
+    EXPECT_FALSE(leads);
+    waiting = false;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_TRUE(waiting);
+  canceled = true;
+  cache.wakeFollowers();
+  follower.join();
+  EXPECT_FALSE(waiting);
+}
+
+TEST(ResultCacheTest, ResultsPushedOutOfMemoryAreReadBackFromDisk) {
+  std::filesystem::path dir =
+      std::filesystem::temp_directory_path() / "resultCacheTest";
+  std::filesystem::remove_all(dir);
+  ConnectionOptions options = cacheOptions(60000, 15);
+  options.resultCacheDir    = dir.string();
+  {
+    ResultCache cache;
+    bool leader = false;
+    cache.getOrLead("a", options, leader);
+    cache.complete("a", oneRow(1), 10, options);
+    // Only one entry fits, so a is written to the directory.
+    cache.getOrLead("b", options, leader);
+    cache.complete("b", oneRow(2), 10, options);
+    EXPECT_EQ(cache.size(), 1);
+  }
+
+  // A later process finds a on disk.
+  ResultCache cache;
+  bool leader = true;
+  auto cached = cache.getOrLead("a", options, leader);
+  ASSERT_NE(cached, nullptr);
+  EXPECT_FALSE(leader);
+  EXPECT_EQ(cached->rows[0][0], 1);
+  EXPECT_EQ(cached->columns[0]["name"], "x");
+  EXPECT_EQ(cache.getOrLead("b", options, leader), nullptr);
+  EXPECT_TRUE(leader);
+  cache.abandon("b");
+
+  // Results on disk expire like the ones in memory.
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  ResultCache laterCache;
+  EXPECT_EQ(laterCache.getOrLead("a", cacheOptions(20, 15), leader), nullptr);
+  EXPECT_TRUE(leader);
+  std::filesystem::remove_all(dir);
+}
+
+TEST(ResultCacheTest, CachesOnlyDeterministicQueries) {
+  EXPECT_TRUE(isCacheableQuery("SELECT * FROM orders"));
+  EXPECT_TRUE(isCacheableQuery("with t as (select 1) select * from t"));
+  EXPECT_TRUE(isCacheableQuery("SELECT 'now()' AS label"));
+  EXPECT_TRUE(isCacheableQuery("SELECT updated_now FROM t"));
+  EXPECT_FALSE(isCacheableQuery("INSERT INTO t SELECT * FROM orders"));
+  EXPECT_FALSE(isCacheableQuery("SHOW TABLES"));
+  EXPECT_FALSE(isCacheableQuery("SELECT now()"));
+  EXPECT_FALSE(isCacheableQuery("SELECT * FROM t WHERE d = current_date"));
+  EXPECT_FALSE(isCacheableQuery("SELECT * FROM t TABLESAMPLE BERNOULLI (5)"));
+  EXPECT_FALSE(isCacheableQuery("-- just a comment"));
+}
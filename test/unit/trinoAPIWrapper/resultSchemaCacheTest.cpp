@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include "../../../src/trinoAPIWrapper/resultSchemaCache.hpp"
+
+static std::vector<json> columnsNamed(const std::string& name) {
+  return {json({{"name", name}, {"type", "bigint"}})};
+}
+
+TEST(ResultSchemaCacheTest, ReturnsStoredColumns) {
+  ResultSchemaCache cache;
+  EXPECT_FALSE(cache.get("a").has_value());
+  cache.put("a", columnsNamed("x"));
+  EXPECT_EQ(cache.get("a").value(), columnsNamed("x"));
+  cache.put("a", columnsNamed("y"));
+  EXPECT_EQ(cache.get("a").value(), columnsNamed("y"));
+  EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(ResultSchemaCacheTest, EvictsLeastRecentlyUsed) {
+  ResultSchemaCache cache(2);
+  cache.put("a", columnsNamed("a"));
+  cache.put("b", columnsNamed("b"));
+  // Using a makes b the least recently used.
+  EXPECT_TRUE(cache.get("a").has_value());
+  cache.put("c", columnsNamed("c"));
+  EXPECT_TRUE(cache.get("a").has_value());
+  EXPECT_FALSE(cache.get("b").has_value());
+  EXPECT_TRUE(cache.get("c").has_value());
+}
+
+TEST(ResultSchemaCacheTest, NormalizesWhitespaceOutsideQuotes) {
+  EXPECT_EQ(normalizeQueryText("  SELECT  a,\n\tb FROM t ;\n"),
+            "SELECT a, b FROM t");
+  EXPECT_EQ(normalizeQueryText("SELECT 'a  b' FROM \"my  table\""),
+            "SELECT 'a  b' FROM \"my  table\"");
+  EXPECT_EQ(normalizeQueryText("SELECT 'it''s  here'  x"),
+            "SELECT 'it''s  here' x");
+}
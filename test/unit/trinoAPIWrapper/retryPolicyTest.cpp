@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../../../src/trinoAPIWrapper/retryPolicy.hpp"
+
+TEST(RetryPolicyTest, RetryableStatusCodes) {
+  EXPECT_TRUE(isRetryableHttpStatus(429));
+  EXPECT_TRUE(isRetryableHttpStatus(502));
+  EXPECT_TRUE(isRetryableHttpStatus(503));
+  EXPECT_TRUE(isRetryableHttpStatus(504));
+  EXPECT_FALSE(isRetryableHttpStatus(400));
+  EXPECT_FALSE(isRetryableHttpStatus(401));
+  EXPECT_FALSE(isRetryableHttpStatus(404));
+  EXPECT_FALSE(isRetryableHttpStatus(500));
+}
+
+TEST(RetryPolicyTest, RetryableCurlCodes) {
+  EXPECT_TRUE(isRetryableCurlCode(CURLE_COULDNT_CONNECT));
+  EXPECT_TRUE(isRetryableCurlCode(CURLE_OPERATION_TIMEDOUT));
+  EXPECT_TRUE(isRetryableCurlCode(CURLE_RECV_ERROR));
+  EXPECT_FALSE(isRetryableCurlCode(CURLE_URL_MALFORMAT));
+  EXPECT_FALSE(isRetryableCurlCode(CURLE_PEER_FAILED_VERIFICATION));
+}
+
+TEST(RetryPolicyTest, ParseRetryAfter) {
+  EXPECT_EQ(parseRetryAfterMs("3"), 3000);
+  EXPECT_EQ(parseRetryAfterMs(" 0 "), 0);
+  EXPECT_EQ(parseRetryAfterMs(""), -1);
+  EXPECT_EQ(parseRetryAfterMs("-1"), -1);
+  EXPECT_EQ(parseRetryAfterMs("Wed, 21 Oct 2015 07:28:00 GMT"), -1);
+}
+
+TEST(RetryPolicyTest, DelaysStayWithinBounds) {
+  RetryPolicy policy(100, 1000, 1000000, 20);
+  long long bound = 100;
+  for (int i = 0; i < 10; i++) {
+    long long delay = policy.nextDelayMs(CURLE_OK, 503, "");
+    EXPECT_GE(delay, 0);
+    EXPECT_LE(delay, bound);
+    bound = std::min(bound * 2, 1000LL);
+  }
+  EXPECT_EQ(policy.getConsecutiveFailures(), 10);
+}
+
+TEST(RetryPolicyTest, NonRetryableFailureIsNotRetried) {
+  RetryPolicy policy(100, 1000, 10000, 5);
+  EXPECT_EQ(policy.nextDelayMs(CURLE_OK, 404, ""), -1);
+  EXPECT_EQ(policy.nextDelayMs(CURLE_URL_MALFORMAT, 0, ""), -1);
+  EXPECT_EQ(policy.getConsecutiveFailures(), 0);
+}
+
+TEST(RetryPolicyTest, RetryAfterTakesPrecedence) {
+  RetryPolicy policy(100, 1000, 10000, 5);
+  EXPECT_EQ(policy.nextDelayMs(CURLE_OK, 429, "2"), 2000);
+  EXPECT_EQ(policy.getBudgetSpentMs(), 2000);
+}
+
+TEST(RetryPolicyTest, StopsWhenBudgetIsSpent) {
+  RetryPolicy policy(100, 1000, 5000, 10);
+  EXPECT_EQ(policy.nextDelayMs(CURLE_OK, 503, "4"), 4000);
+  EXPECT_EQ(policy.nextDelayMs(CURLE_OK, 503, "4"), -1);
+}
+
+TEST(RetryPolicyTest, StopsAfterMaxAttempts) {
+  RetryPolicy policy(1, 1, 10000, 3);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_GE(policy.nextDelayMs(CURLE_COULDNT_CONNECT, 0, ""), 0);
+  }
+  EXPECT_EQ(policy.nextDelayMs(CURLE_COULDNT_CONNECT, 0, ""), -1);
+}
+
+TEST(RetryPolicyTest, SuccessResetsAttemptsButNotBudget) {
+  RetryPolicy policy(100, 1000, 10000, 2);
+  policy.nextDelayMs(CURLE_OK, 503, "1");
+  policy.nextDelayMs(CURLE_OK, 503, "1");
+  EXPECT_EQ(policy.nextDelayMs(CURLE_OK, 503, "1"), -1);
+  policy.recordSuccess();
+  EXPECT_EQ(policy.getConsecutiveFailures(), 0);
+  EXPECT_EQ(policy.nextDelayMs(CURLE_OK, 503, "1"), 1000);
+  EXPECT_EQ(policy.getBudgetSpentMs(), 3000);
+  policy.reset();
+  EXPECT_EQ(policy.getBudgetSpentMs(), 0);
+}
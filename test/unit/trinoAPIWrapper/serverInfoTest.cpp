@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+
+#include "../../../src/trinoAPIWrapper/serverInfo.hpp"
+
+TEST(ServerInfoTest, ParsesNodeVersion) {
+  std::string info = R"({"nodeVersion":{"version":"476"},"coordinator":true,
+                         "starting":false,"uptime":"1.00h"})";
+  EXPECT_EQ(parseServerVersion(info), "476");
+}
+
+TEST(ServerInfoTest, RejectsResponsesWithoutVersion) {
+  EXPECT_FALSE(parseServerVersion("").has_value());
+  EXPECT_FALSE(parseServerVersion("<html></html>").has_value());
+  EXPECT_FALSE(parseServerVersion(R"({"nodeVersion":{}})").has_value());
+  EXPECT_FALSE(
+      parseServerVersion(R"({"nodeVersion":{"version":476}})").has_value());
+}
+
+TEST(ServerInfoTest, RemembersVersionPerEndpoint) {
+  ServerInfoCache cache;
+  EXPECT_FALSE(cache.getVersion("https://a:443").has_value());
+  cache.putVersion("https://a:443", "475");
+  cache.putVersion("https://b:443", "476");
+  EXPECT_EQ(cache.getVersion("https://a:443"), "475");
+  EXPECT_EQ(cache.getVersion("https://b:443"), "476");
+  cache.putVersion("https://a:443", "477");
+  EXPECT_EQ(cache.getVersion("https://a:443"), "477");
+}
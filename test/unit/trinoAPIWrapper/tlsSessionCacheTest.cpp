@@ -0,0 +1,108 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../../../src/trinoAPIWrapper/tlsSessionCache.hpp"
+#include "../../../src/util/timeUtils.hpp"
+
+class TlsSessionCacheTest : public ::testing::Test {
+  protected:
+    std::filesystem::path filePath;
+
+    void SetUp() override {
+      this->filePath = std::filesystem::temp_directory_path() /
+                       "tlsSessionCacheTest.json";
+      std::filesystem::remove(this->filePath);
+    }
+
+    void TearDown() override {
+      std::filesystem::remove(this->filePath);
+      std::filesystem::remove(this->filePath.wstring() + L".lock");
+    }
+};
+
+static TlsSession makeSession(std::string name, long long validUntil) {
+  TlsSession session;
+  session.sessionKey  = name;
+  session.shmac       = std::string("\x01\x00\x02", 3);
+  session.sessionData = std::string("ticket\0", 7) + name;
+  session.validUntil  = validUntil;
+  return session;
+}
+
+TEST_F(TlsSessionCacheTest, SessionsRoundTripThroughTheFile) {
+  long long later = getSecondsSinceEpoch() + 3600;
+  writeTlsSessionCache(this->filePath.wstring(),
+                       "trino",
+                       443,
+                       {makeSession("first", later), makeSession("second", 0)});
+
+  std::vector<TlsSession> sessions =
+      readTlsSessionCache(this->filePath.wstring(), "trino", 443);
+  ASSERT_EQ(sessions.size(), 2);
+  EXPECT_EQ(sessions[0].sessionKey, "first");
+  EXPECT_EQ(sessions[0].shmac, std::string("\x01\x00\x02", 3));
+  EXPECT_EQ(sessions[0].sessionData, makeSession("first", 0).sessionData);
+  EXPECT_EQ(sessions[0].validUntil, later);
+  EXPECT_EQ(sessions[1].sessionKey, "second");
+  EXPECT_EQ(sessions[1].validUntil, 0);
+
+  // Nothing is written in the clear.
+  std::ifstream input(this->filePath);
+  std::string contents((std::istreambuf_iterator<char>(input)),
+                       std::istreambuf_iterator<char>());
+  EXPECT_EQ(contents.find("first"), std::string::npos);
+}
+
+TEST_F(TlsSessionCacheTest, WritingKeepsOtherEndpoints) {
+  writeTlsSessionCache(
+      this->filePath.wstring(), "trino", 443, {makeSession("a", 0)});
+  writeTlsSessionCache(
+      this->filePath.wstring(), "trino", 8443, {makeSession("b", 0)});
+  writeTlsSessionCache(
+      this->filePath.wstring(), "trino", 8443, {makeSession("c", 0)});
+
+  std::vector<TlsSession> sessions =
+      readTlsSessionCache(this->filePath.wstring(), "trino", 443);
+  ASSERT_EQ(sessions.size(), 1);
+  EXPECT_EQ(sessions[0].sessionKey, "a");
+  sessions = readTlsSessionCache(this->filePath.wstring(), "trino", 8443);
+  ASSERT_EQ(sessions.size(), 1);
+  EXPECT_EQ(sessions[0].sessionKey, "c");
+  EXPECT_TRUE(
+      readTlsSessionCache(this->filePath.wstring(), "other", 443).empty());
+}
+
+TEST_F(TlsSessionCacheTest, ExpiredSessionsAreSkipped) {
+  long long now = getSecondsSinceEpoch();
+  writeTlsSessionCache(
+      this->filePath.wstring(),
+      "trino",
+      443,
+      {makeSession("expired", now - 10), makeSession("fresh", now + 3600)});
+
+  std::vector<TlsSession> sessions =
+      readTlsSessionCache(this->filePath.wstring(), "trino", 443);
+  ASSERT_EQ(sessions.size(), 1);
+  EXPECT_EQ(sessions[0].sessionKey, "fresh");
+}
+
+TEST_F(TlsSessionCacheTest, MissingOrBrokenFileHasNoSessions) {
+  EXPECT_TRUE(
+      readTlsSessionCache(this->filePath.wstring(), "trino", 443).empty());
+
+  std::ofstream output(this->filePath);
+  output << "{not json";
+  output.close();
+  EXPECT_TRUE(
+      readTlsSessionCache(this->filePath.wstring(), "trino", 443).empty());
+
+  // A broken file is replaced on the next write.
+  writeTlsSessionCache(
+      this->filePath.wstring(), "trino", 443, {makeSession("a", 0)});
+  EXPECT_EQ(readTlsSessionCache(this->filePath.wstring(), "trino", 443).size(),
+            1);
+}
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "../../../src/trinoAPIWrapper/authProvider/tokens/tokenCache.hpp"
+#include "../../../src/util/fileLock.hpp"
+#include "../../../src/util/localAppDataPath.hpp"
+#include "../../../src/util/timeUtils.hpp"
+
+using json = nlohmann::json;
+
+/*
+These work on the real token cache file, under an identity of their own
+that is removed again afterwards.
+*/
+class TokenCacheTest : public ::testing::Test {
+  protected:
+    std::string tokenId =
+        "tokenCacheTest__" +
+        std::to_string(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+    std::filesystem::path filePath =
+        getLocalAppDataTempFilePath(L"TrinoODBCTokenCache.json");
+    std::wstring lockPath =
+        getLocalAppDataTempFilePath(L"TrinoODBCTokenCache.json.lock");
+
+    void TearDown() override {
+      this->update([this](json& cache) { cache.erase(this->tokenId); });
+    }
+
+    json readEntry() {
+      FileLock lock(this->lockPath, 5000);
+      std::ifstream input(this->filePath);
+      json cache = json::parse(input, nullptr, false);
+      if (not cache.is_object() or not cache.contains(this->tokenId)) {
+        return json::object();
+      }
+      return cache[this->tokenId];
+    }
+
+    // Change the file the way another driver process would.
+    void update(std::function<void(json&)> change) {
+      FileLock lock(this->lockPath, 5000);
+      json cache = json::object();
+      {
+        std::ifstream input(this->filePath);
+        if (input.is_open()) {
+          cache = json::parse(input, nullptr, false);
+        }
+      }
+      if (not cache.is_object()) {
+        cache = json::object();
+      }
+      change(cache);
+      writeFileAtomically(this->filePath.wstring(), cache.dump());
+    }
+
+    // Make the claim on this identity look like another process's.
+    void handClaimToAnotherProcess(long long refreshingUntil) {
+      this->update([&](json& cache) {
+        cache[this->tokenId]["refreshingProcess"] =
+            getCurrentProcessIdentifier() + 1;
+        cache[this->tokenId]["refreshingUntil"] = refreshingUntil;
+      });
+    }
+};
+
+TEST_F(TokenCacheTest, ClaimHoldsOffOtherProcessesUntilReleased) {
+  ASSERT_TRUE(claimTokenRefresh(this->tokenId));
+  json entry = this->readEntry();
+  EXPECT_EQ(entry.value<unsigned long>("refreshingProcess", 0UL),
+            getCurrentProcessIdentifier());
+  EXPECT_GT(entry.value<long long>("refreshingUntil", 0LL),
+            getSecondsSinceEpoch());
+  // The process that holds the claim can take it again.
+  EXPECT_TRUE(claimTokenRefresh(this->tokenId));
+
+  releaseTokenRefreshClaim(this->tokenId);
+  entry = this->readEntry();
+  EXPECT_FALSE(entry.contains("refreshingProcess"));
+  EXPECT_FALSE(entry.contains("refreshingUntil"));
+
+  this->handClaimToAnotherProcess(getSecondsSinceEpoch() + 60);
+  EXPECT_FALSE(claimTokenRefresh(this->tokenId));
+  // Only the process that made a claim releases it.
+  releaseTokenRefreshClaim(this->tokenId);
+  EXPECT_TRUE(this->readEntry().contains("refreshingProcess"));
+}
+
+TEST_F(TokenCacheTest, ClaimOfADeadProcessLapses) {
+  this->handClaimToAnotherProcess(getSecondsSinceEpoch() - 1);
+  EXPECT_TRUE(claimTokenRefresh(this->tokenId));
+  EXPECT_EQ(this->readEntry().value<unsigned long>("refreshingProcess", 0UL),
+            getCurrentProcessIdentifier());
+}
+
+TEST_F(TokenCacheTest, WritingTheTokenPublishesItAndClearsTheClaim) {
+  ASSERT_TRUE(claimTokenRefresh(this->tokenId));
+  writeTokenCache(TokenCacheEntry("", "refresh-token", this->tokenId));
+
+  json entry = this->readEntry();
+  EXPECT_FALSE(entry.contains("refreshingProcess"));
+  EXPECT_TRUE(entry.contains("encryptedRefreshToken"));
+  EXPECT_EQ(readTokenCache(this->tokenId).getRefreshToken(), "refresh-token");
+}
+
+TEST_F(TokenCacheTest, ReadingWaitsForTheWriter) {
+  writeTokenCache(TokenCacheEntry("", "refresh-token", this->tokenId));
+  // A reader holds the writers' lock while the file is open, so it never
+  // blocks the rename of a refreshed token.
+  std::optional<FileLock> lock;
+  lock.emplace(this->lockPath, 5000);
+  ASSERT_TRUE(lock->isLocked());
+  auto started = std::chrono::steady_clock::now();
+  std::thread reader([this]() {
+    EXPECT_EQ(readTokenCache(this->tokenId).getRefreshToken(),
+              "refresh-token");
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  lock.reset();
+  reader.join();
+  EXPECT_GE(std::chrono::steady_clock::now() - started,
+            std::chrono::milliseconds(100));
+}
@@ -0,0 +1,257 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../../src/trinoAPIWrapper/authProvider/tokenCacheAuthProviderBase.hpp"
+#include "../../../src/trinoAPIWrapper/authProvider/tokens/tokenRegistry.hpp"
+#include "../../../src/util/fileLock.hpp"
+#include "../../../src/util/localAppDataPath.hpp"
+#include "../../../src/util/timeUtils.hpp"
+
+using json = nlohmann::json;
+
+static std::string toBase64url(const std::string& data) {
+  static const char* alphabet =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+  std::string encoded;
+  int value = 0;
+  int bits  = -6;
+  for (unsigned char c : data) {
+    value = (value << 8) + c;
+    bits += 8;
+    while (bits >= 0) {
+      encoded.push_back(alphabet[(value >> bits) & 0x3F]);
+      bits -= 6;
+    }
+  }
+  if (bits > -6) {
+    encoded.push_back(alphabet[((value << 8) >> (bits + 8)) & 0x3F]);
+  }
+  return encoded;
+}
+
+// An unsigned JWT, which is all the driver looks at.
+static std::string makeToken(json claims) {
+  return "e30." + toBase64url(claims.dump()) + ".signature";
+}
+
+static std::string tokenExpiringIn(long long seconds) {
+  return makeToken({{"exp", getSecondsSinceEpoch() + seconds}});
+}
+
+/*
+These go through the real token cache file, under identities of their
+own that are removed again afterwards.
+*/
+class TokenRegistryTest : public ::testing::Test {
+  protected:
+    std::string tokenId = "tokenRegistryTest__" + this->uniqueSuffix();
+
+    static std::string uniqueSuffix() {
+      return std::to_string(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    void TearDown() override {
+      flushTokenRegistry();
+      std::filesystem::path filePath =
+          getLocalAppDataTempFilePath(L"TrinoODBCTokenCache.json");
+      FileLock lock(
+          getLocalAppDataTempFilePath(L"TrinoODBCTokenCache.json.lock"), 5000);
+      json cache = json::object();
+      {
+        std::ifstream input(filePath);
+        if (input.is_open()) {
+          cache = json::parse(input, nullptr, false);
+        }
+      }
+      if (cache.is_object()) {
+        for (auto it = cache.begin(); it != cache.end();) {
+          if (it.key().starts_with("tokenRegistryTest__")) {
+            it = cache.erase(it);
+          } else {
+            it++;
+          }
+        }
+        writeFileAtomically(filePath.wstring(), cache.dump());
+      }
+    }
+
+    // Start every caller at once, so they all find the token expired.
+    template <typename Call> void runConcurrently(int callers, Call call) {
+      std::atomic<bool> go = false;
+      std::vector<std::thread> threads;
+      for (int i = 0; i < callers; i++) {
+        threads.emplace_back([&, i]() {
+          while (not go) {
+            std::this_thread::yield();
+          }
+          call(i);
+        });
+      }
+      go = true;
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+    }
+};
+
+TEST_F(TokenRegistryTest, ConcurrentCallersShareOneRefresh) {
+  const int callers              = 16;
+  std::string token              = tokenExpiringIn(3600);
+  std::atomic<int> providerCalls = 0;
+  std::vector<std::string> results(callers);
+
+  this->runConcurrently(callers, [&](int i) {
+    results[i] = refreshSharedToken(this->tokenId, [&]() {
+                   providerCalls++;
+                   // Long enough for every other caller to start waiting.
+                   std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                   return token;
+                 }).getAccessToken();
+  });
+
+  EXPECT_EQ(providerCalls, 1);
+  for (const std::string& result : results) {
+    EXPECT_EQ(result, token);
+  }
+  EXPECT_EQ(getSharedToken(this->tokenId).getAccessToken(), token);
+}
+
+TEST_F(TokenRegistryTest, FailedRefreshReachesEveryWaiter) {
+  const int callers              = 8;
+  std::atomic<int> providerCalls = 0;
+  std::atomic<int> failures      = 0;
+
+  this->runConcurrently(callers, [&](int) {
+    try {
+      refreshSharedToken(this->tokenId, [&]() -> std::string {
+        providerCalls++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        throw std::runtime_error("identity provider is down");
+      });
+    } catch (const std::runtime_error& e) {
+      EXPECT_EQ(std::string(e.what()), "identity provider is down");
+      failures++;
+    }
+  });
+
+  // Nobody is left waiting, and each waiter got to try for itself.
+  EXPECT_EQ(failures, callers);
+  EXPECT_GE(providerCalls, 1);
+  EXPECT_LE(providerCalls, callers);
+
+  // A failed refresh gives up its claim, so the next one goes ahead.
+  std::string token = tokenExpiringIn(3600);
+  EXPECT_EQ(refreshSharedToken(this->tokenId, [&]() { return token; })
+                .getAccessToken(),
+            token);
+}
+
+TEST_F(TokenRegistryTest, RefreshedTokensAreWrittenBack) {
+  std::string token = tokenExpiringIn(3600);
+  refreshSharedToken(this->tokenId, [&]() { return token; });
+  flushTokenRegistry();
+  EXPECT_EQ(readTokenCache(this->tokenId).getAccessToken(), token);
+}
+
+TEST_F(TokenRegistryTest, FreshTokensAreNotRefreshedAgain) {
+  std::string token = tokenExpiringIn(3600);
+  refreshSharedToken(this->tokenId, [&]() { return token; });
+  int providerCalls = 0;
+  TokenCacheEntry entry =
+      refreshSharedToken(this->tokenId, [&]() -> std::string {
+        providerCalls++;
+        return tokenExpiringIn(7200);
+      });
+  EXPECT_EQ(providerCalls, 0);
+  EXPECT_EQ(entry.getAccessToken(), token);
+
+  // Unless the caller asks for one that lasts longer than this one does.
+  entry = refreshSharedToken(
+      this->tokenId, [&]() { return tokenExpiringIn(7200); }, 7200);
+  EXPECT_NE(entry.getAccessToken(), token);
+}
+
+
+// A provider that hands out tokens without calling anybody.
+class FakeTokenProvider : public TokenCacheAuthProviderBase {
+  public:
+    std::atomic<int> calls = 0;
+    std::string nextToken;
+
+    FakeTokenProvider(std::string connectionName, std::string nextToken)
+        : TokenCacheAuthProviderBase("localhost", 8080, connectionName) {
+      this->nextToken = nextToken;
+    }
+
+    ~FakeTokenProvider() {
+      this->stopBackgroundRefresh();
+    }
+
+    std::string authorization() {
+      return this->getHeaders()["Authorization"];
+    }
+
+  protected:
+    std::string obtainAccessToken(
+        CURL* curl,
+        std::string* responseData,
+        std::map<std::string, std::string>* responseHeaderData) override {
+      this->calls++;
+      return this->nextToken;
+    }
+
+    bool supportsBackgroundRefresh() override {
+      return true;
+    }
+};
+
+class BackgroundRefreshTest : public TokenRegistryTest {
+  protected:
+    std::string connectionName = "tokenRegistryTest__" + this->uniqueSuffix();
+    std::string providerTokenId =
+        getTokenIdentity("localhost", 8080, this->connectionName);
+};
+
+TEST_F(BackgroundRefreshTest, TokensAreRefreshedBeforeTheyExpire) {
+  // Inside the refresh lead time, though not expired yet. Tokens count as
+  // expired ten minutes early, and are refreshed two minutes before that.
+  std::string expiring = tokenExpiringIn(10 * 60 + 30);
+  refreshSharedToken(this->providerTokenId, [&]() { return expiring; });
+
+  std::string refreshed = tokenExpiringIn(3600);
+  FakeTokenProvider provider(this->connectionName, refreshed);
+  EXPECT_FALSE(provider.isExpired());
+  EXPECT_EQ(provider.authorization(), "Bearer " + expiring);
+  provider.startBackgroundRefresh();
+
+  auto giveUpAt = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (provider.authorization() != "Bearer " + refreshed and
+         std::chrono::steady_clock::now() < giveUpAt) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(provider.authorization(), "Bearer " + refreshed);
+  EXPECT_EQ(provider.calls, 1);
+  EXPECT_EQ(getSharedToken(this->providerTokenId).getAccessToken(),
+            refreshed);
+}
+
+TEST_F(BackgroundRefreshTest, TokensWithoutExpiryAreLeftAlone) {
+  // Such a token always counts as expired, which used to have the
+  // background thread call the identity provider over and over.
+  std::string noExpiry = makeToken({{"sub", "user"}});
+  refreshSharedToken(this->providerTokenId, [&]() { return noExpiry; });
+
+  FakeTokenProvider provider(this->connectionName, tokenExpiringIn(3600));
+  provider.startBackgroundRefresh();
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(provider.calls, 0);
+}
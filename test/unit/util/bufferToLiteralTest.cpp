@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../../../src/util/bufferToLiteral.hpp"
+
+TEST(BufferToLiteralTest, QuotesStrings) {
+  EXPECT_EQ(quoteSqlString("abc"), "'abc'");
+  EXPECT_EQ(quoteSqlString("it's"), "'it''s'");
+  EXPECT_EQ(quoteSqlString(""), "''");
+}
+
+TEST(BufferToLiteralTest, NullIndicator) {
+  SQLLEN indicator = SQL_NULL_DATA;
+  EXPECT_EQ(bufferToLiteral(SQL_C_SLONG, SQL_INTEGER, nullptr, 0, &indicator),
+            "NULL");
+}
+
+TEST(BufferToLiteralTest, CharUsesLengthOrTerminator) {
+  char text[]      = "O'Brien and more";
+  SQLLEN indicator = 7;
+  EXPECT_EQ(bufferToLiteral(
+                SQL_C_CHAR, SQL_VARCHAR, text, sizeof(text), &indicator),
+            "'O''Brien'");
+  indicator = SQL_NTS;
+  EXPECT_EQ(bufferToLiteral(
+                SQL_C_CHAR, SQL_VARCHAR, text, sizeof(text), &indicator),
+            "'O''Brien and more'");
+  EXPECT_EQ(
+      bufferToLiteral(SQL_C_CHAR, SQL_VARCHAR, text, sizeof(text), nullptr),
+      "'O''Brien and more'");
+}
+
+TEST(BufferToLiteralTest, CharConvertsToSqlType) {
+  char text[] = "42";
+  EXPECT_EQ(bufferToLiteral(SQL_C_CHAR, SQL_INTEGER, text, 3, nullptr),
+            "CAST('42' AS integer)");
+  char date[] = "2025-03-10";
+  EXPECT_EQ(bufferToLiteral(SQL_C_CHAR, SQL_TYPE_DATE, date, 11, nullptr),
+            "DATE '2025-03-10'");
+}
+
+TEST(BufferToLiteralTest, Integers) {
+  int32_t slong = -12345;
+  EXPECT_EQ(bufferToLiteral(SQL_C_SLONG, SQL_INTEGER, &slong, 0, nullptr),
+            "-12345");
+  uint64_t ubigint = 18446744073709551615ULL;
+  EXPECT_EQ(bufferToLiteral(SQL_C_UBIGINT, SQL_DECIMAL, &ubigint, 0, nullptr),
+            "18446744073709551615");
+  unsigned char bit = 1;
+  EXPECT_EQ(bufferToLiteral(SQL_C_BIT, SQL_BIT, &bit, 0, nullptr), "TRUE");
+}
+
+TEST(BufferToLiteralTest, Floating) {
+  double value = 1.5;
+  EXPECT_EQ(bufferToLiteral(SQL_C_DOUBLE, SQL_DOUBLE, &value, 0, nullptr),
+            "DOUBLE '1.5'");
+  float single = 0.25f;
+  EXPECT_EQ(bufferToLiteral(SQL_C_FLOAT, SQL_REAL, &single, 0, nullptr),
+            "REAL '0.25'");
+}
+
+TEST(BufferToLiteralTest, Numeric) {
+  SQL_NUMERIC_STRUCT numeric;
+  std::memset(&numeric, 0, sizeof(numeric));
+  // 12345 with a scale of 3 is 12.345
+  numeric.val[0] = 0x39;
+  numeric.val[1] = 0x30;
+  numeric.scale  = 3;
+  numeric.sign   = 0;
+  EXPECT_EQ(bufferToLiteral(SQL_C_NUMERIC, SQL_DECIMAL, &numeric, 0, nullptr),
+            "DECIMAL '-12.345'");
+  numeric.val[0] = 5;
+  numeric.val[1] = 0;
+  numeric.sign   = 1;
+  EXPECT_EQ(bufferToLiteral(SQL_C_NUMERIC, SQL_DECIMAL, &numeric, 0, nullptr),
+            "DECIMAL '0.005'");
+}
+
+TEST(BufferToLiteralTest, Timestamp) {
+  SQL_TIMESTAMP_STRUCT timestamp = {2025, 3, 10, 12, 34, 56, 789000000};
+  SQLSMALLINT cType              = SQL_C_TYPE_TIMESTAMP;
+  SQLSMALLINT sqlType            = SQL_TYPE_TIMESTAMP;
+  EXPECT_EQ(bufferToLiteral(cType, sqlType, &timestamp, 0, nullptr),
+            "TIMESTAMP '2025-03-10 12:34:56.789'");
+  timestamp.fraction = 0;
+  EXPECT_EQ(bufferToLiteral(cType, sqlType, &timestamp, 0, nullptr),
+            "TIMESTAMP '2025-03-10 12:34:56'");
+}
+
+TEST(BufferToLiteralTest, Binary) {
+  unsigned char bytes[] = {0x00, 0xAB, 0x10};
+  SQLLEN length         = 3;
+  EXPECT_EQ(
+      bufferToLiteral(SQL_C_BINARY, SQL_VARBINARY, bytes, 3, &length),
+      "X'00AB10'");
+}
+
+TEST(BufferToLiteralTest, DataAtExecutionIsUnsupported) {
+  int32_t value    = 1;
+  SQLLEN indicator = SQL_DATA_AT_EXEC;
+  EXPECT_FALSE(
+      bufferToLiteral(SQL_C_SLONG, SQL_INTEGER, &value, 0, &indicator)
+          .has_value());
+}
+
+TEST(BufferToLiteralTest, FixedSizes) {
+  EXPECT_EQ(cDataTypeSize(SQL_C_SLONG), 4);
+  EXPECT_EQ(cDataTypeSize(SQL_C_TYPE_TIMESTAMP), sizeof(SQL_TIMESTAMP_STRUCT));
+  EXPECT_EQ(cDataTypeSize(SQL_C_CHAR), 0);
+}
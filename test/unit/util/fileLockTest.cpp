@@ -0,0 +1,74 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+
+#include "../../../src/util/fileLock.hpp"
+
+class FileLockTest : public ::testing::Test {
+  protected:
+    std::filesystem::path filePath;
+    std::filesystem::path lockPath;
+
+    void SetUp() override {
+      std::filesystem::path dir = std::filesystem::temp_directory_path();
+      this->filePath            = dir / "fileLockTest.json";
+      this->lockPath            = dir / "fileLockTest.json.lock";
+      std::filesystem::remove(this->filePath);
+    }
+
+    void TearDown() override {
+      std::filesystem::remove(this->filePath);
+      std::filesystem::remove(this->lockPath);
+    }
+
+    std::string readFile() {
+      std::ifstream input(this->filePath, std::ios::binary);
+      return std::string((std::istreambuf_iterator<char>(input)),
+                         std::istreambuf_iterator<char>());
+    }
+};
+
+TEST_F(FileLockTest, LockIsHeldUntilReleased) {
+  {
+    FileLock first(this->lockPath.wstring(), 0);
+    ASSERT_TRUE(first.isLocked());
+
+    // A second holder waits out its timeout and then goes without.
+    auto started = std::chrono::steady_clock::now();
+    FileLock second(this->lockPath.wstring(), 50);
+    EXPECT_FALSE(second.isLocked());
+    EXPECT_GE(std::chrono::steady_clock::now() - started,
+              std::chrono::milliseconds(50));
+  }
+  FileLock third(this->lockPath.wstring(), 0);
+  EXPECT_TRUE(third.isLocked());
+}
+
+TEST_F(FileLockTest, WriteFileAtomicallyReplacesTheFile) {
+  ASSERT_TRUE(writeFileAtomically(this->filePath.wstring(), "first"));
+  EXPECT_EQ(this->readFile(), "first");
+
+  // Shorter contents replace the file rather than overwriting its start.
+  ASSERT_TRUE(writeFileAtomically(this->filePath.wstring(), "2nd"));
+  EXPECT_EQ(this->readFile(), "2nd");
+
+  // The temporary file is gone once it has been renamed over the target.
+  for (const auto& entry : std::filesystem::directory_iterator(
+           std::filesystem::temp_directory_path())) {
+    std::string name = entry.path().filename().string();
+    EXPECT_FALSE(name.starts_with("fileLockTest.json.") and
+                 name.ends_with(".tmp"))
+        << name;
+  }
+}
+
+TEST_F(FileLockTest, WriteFileAtomicallyWorksUnderTheLock) {
+  // Writers hold the lock across the replace, which lives on its own file.
+  FileLock lock(this->lockPath.wstring(), 0);
+  ASSERT_TRUE(lock.isLocked());
+  ASSERT_TRUE(writeFileAtomically(this->filePath.wstring(), "locked"));
+  EXPECT_EQ(this->readFile(), "locked");
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include "../../../src/util/informationSchemaColumns.hpp"
+
+static json informationSchemaRow(const std::string& type,
+                                 const std::string& isNullable = "YES") {
+  return json::array({"tpch", "sf1", "customer", "c", 2, isNullable, type});
+}
+
+TEST(InformationSchemaColumnsTest, Bigint) {
+  json row = sqlColumnsRowFromInformationSchema(informationSchemaRow("bigint"));
+  ASSERT_EQ(row.size(), 18);
+  EXPECT_EQ(row[2], "customer");
+  EXPECT_EQ(row[3], "c");
+  EXPECT_EQ(row[4], -5);
+  EXPECT_EQ(row[5], "bigint");
+  EXPECT_EQ(row[6], 19);
+  EXPECT_EQ(row[8], 0);
+  EXPECT_EQ(row[9], 10);
+  EXPECT_EQ(row[10], 1);
+  EXPECT_EQ(row[16], 2);
+  EXPECT_EQ(row[17], "YES");
+}
+
+TEST(InformationSchemaColumnsTest, Varchar) {
+  json bounded =
+      sqlColumnsRowFromInformationSchema(informationSchemaRow("varchar(25)"));
+  EXPECT_EQ(bounded[4], 12);
+  EXPECT_EQ(bounded[5], "varchar(25)");
+  EXPECT_EQ(bounded[6], 25);
+  EXPECT_TRUE(bounded[8].is_null());
+  EXPECT_EQ(bounded[15], 25);
+  json unbounded =
+      sqlColumnsRowFromInformationSchema(informationSchemaRow("varchar", "NO"));
+  EXPECT_EQ(unbounded[6], 2147483647);
+  EXPECT_EQ(unbounded[10], 0);
+  EXPECT_EQ(unbounded[17], "NO");
+}
+
+TEST(InformationSchemaColumnsTest, Decimal) {
+  json row =
+      sqlColumnsRowFromInformationSchema(informationSchemaRow("decimal(12,2)"));
+  EXPECT_EQ(row[4], 3);
+  EXPECT_EQ(row[6], 12);
+  EXPECT_EQ(row[8], 2);
+  EXPECT_EQ(row[9], 10);
+}
+
+TEST(InformationSchemaColumnsTest, TimestampWithTimeZone) {
+  json row = sqlColumnsRowFromInformationSchema(
+      informationSchemaRow("timestamp(3) with time zone"));
+  EXPECT_EQ(row[4], 93);
+  EXPECT_EQ(row[5], "timestamp");
+  EXPECT_EQ(row[6], 16);
+  EXPECT_EQ(row[8], 3);
+}
+
+TEST(InformationSchemaColumnsTest, Containers) {
+  json row = sqlColumnsRowFromInformationSchema(
+      informationSchemaRow("array(varchar(5))"));
+  EXPECT_EQ(row[4], 2003);
+  EXPECT_EQ(row[5], "array(varchar(5))");
+  EXPECT_TRUE(row[6].is_null());
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "../../../src/util/insertBatch.hpp"
+
+TEST(InsertBatchTest, SplitsRowAtMarkers) {
+  std::optional<InsertTemplate> insert =
+      parseInsertTemplate("INSERT INTO t (a, b) VALUES (?, lower(?))");
+  ASSERT_TRUE(insert.has_value());
+  EXPECT_EQ(insert->head, "INSERT INTO t (a, b) VALUES ");
+  EXPECT_EQ(insert->rowPieces,
+            std::vector<std::string>({"(", ", lower(", "))"}));
+  EXPECT_EQ(renderInsertRow(*insert, {"1", "'X'"}), "(1, lower('X'))");
+}
+
+TEST(InsertBatchTest, IgnoresQuotesAndComments) {
+  std::optional<InsertTemplate> insert = parseInsertTemplate(
+      "insert into \"values?\" values ('?', ? /* ? */) -- done?\n;");
+  ASSERT_TRUE(insert.has_value());
+  EXPECT_EQ(insert->head, "insert into \"values?\" values ");
+  EXPECT_EQ(insert->rowPieces,
+            std::vector<std::string>({"('?', ", " /* ? */)"}));
+}
+
+TEST(InsertBatchTest, RejectsOtherStatements) {
+  EXPECT_FALSE(parseInsertTemplate("SELECT ?").has_value());
+  EXPECT_FALSE(
+      parseInsertTemplate("INSERT INTO t SELECT * FROM u WHERE a = ?")
+          .has_value());
+  EXPECT_FALSE(
+      parseInsertTemplate("INSERT INTO t VALUES (?), (?)").has_value());
+  EXPECT_FALSE(parseInsertTemplate("INSERT INTO t VALUES (1)").has_value());
+  EXPECT_FALSE(parseInsertTemplate("INSERT INTO t VALUES (?").has_value());
+}
+
+TEST(InsertBatchTest, BatchesRespectMaxBytes) {
+  InsertTemplate insert = *parseInsertTemplate("INSERT INTO t VALUES (?)");
+  std::vector<std::string> rows;
+  for (int i = 0; i < 5; i++) {
+    rows.push_back(renderInsertRow(insert, {std::to_string(i)}));
+  }
+  size_t end = 0;
+  // The head is 21 bytes and each row 3, plus 2 for each separator.
+  EXPECT_EQ(buildInsertBatch(insert, rows, 0, 29, end),
+            "INSERT INTO t VALUES (0), (1)");
+  EXPECT_EQ(end, 2);
+  EXPECT_EQ(buildInsertBatch(insert, rows, 2, 1000, end),
+            "INSERT INTO t VALUES (2), (3), (4)");
+  EXPECT_EQ(end, 5);
+}
+
+TEST(InsertBatchTest, OversizedRowGetsItsOwnBatch) {
+  InsertTemplate insert = *parseInsertTemplate("INSERT INTO t VALUES (?)");
+  std::vector<std::string> rows = {"('long value')", "(1)"};
+  size_t end                    = 0;
+  EXPECT_EQ(buildInsertBatch(insert, rows, 0, 10, end),
+            "INSERT INTO t VALUES ('long value')");
+  EXPECT_EQ(end, 1);
+}
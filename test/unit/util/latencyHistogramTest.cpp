@@ -0,0 +1,84 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "../../../src/util/latencyHistogram.hpp"
+
+TEST(LatencyHistogramTest, EmptyHistogramReportsZero) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0);
+  EXPECT_EQ(histogram.min(), 0);
+  EXPECT_EQ(histogram.max(), 0);
+  EXPECT_EQ(histogram.mean(), 0);
+  EXPECT_EQ(histogram.percentile(99), 0);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  LatencyHistogram histogram;
+  for (uint64_t value = 0; value < 16; value++) {
+    histogram.record(value);
+  }
+  EXPECT_EQ(histogram.count(), 16);
+  EXPECT_EQ(histogram.min(), 0);
+  EXPECT_EQ(histogram.max(), 15);
+  EXPECT_EQ(histogram.percentile(50), 7);
+  EXPECT_EQ(histogram.percentile(100), 15);
+}
+
+TEST(LatencyHistogramTest, BucketsCoverEveryValueOnce) {
+  // Each bucket starts right after the one before it ends.
+  for (size_t i = 1; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    uint64_t start = LatencyHistogram::bucketUpperBound(i - 1) + 1;
+    EXPECT_EQ(LatencyHistogram::bucketIndex(start), i);
+    EXPECT_EQ(
+        LatencyHistogram::bucketIndex(LatencyHistogram::bucketUpperBound(i)),
+        i);
+  }
+  EXPECT_EQ(LatencyHistogram::bucketIndex(UINT64_MAX),
+            LATENCY_HISTOGRAM_BUCKETS - 1);
+  EXPECT_EQ(LatencyHistogram::bucketUpperBound(LATENCY_HISTOGRAM_BUCKETS - 1),
+            UINT64_MAX);
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinTheBucketPrecision) {
+  LatencyHistogram histogram;
+  for (uint64_t value = 1; value <= 100000; value++) {
+    histogram.record(value);
+  }
+  EXPECT_EQ(histogram.count(), 100000);
+  EXPECT_DOUBLE_EQ(histogram.mean(), 50000.5);
+  for (double percent : {50.0, 90.0, 99.0, 99.9}) {
+    double exact    = percent * 1000;
+    double reported = static_cast<double>(histogram.percentile(percent));
+    EXPECT_GE(reported, exact);
+    EXPECT_LE(reported, exact * (1 + 1.0 / LATENCY_HISTOGRAM_SUB_BUCKETS));
+  }
+  EXPECT_EQ(histogram.percentile(100), 100000);
+}
+
+TEST(LatencyHistogramTest, TailIsNotHiddenByTheMedian) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 990; i++) {
+    histogram.record(2000);
+  }
+  for (int i = 0; i < 10; i++) {
+    histogram.record(900000);
+  }
+  EXPECT_LE(histogram.percentile(50), 2000 * 17 / 16);
+  EXPECT_GE(histogram.percentile(99), 2000);
+  EXPECT_GE(histogram.percentile(99.5), 900000);
+  EXPECT_EQ(histogram.max(), 900000);
+}
+
+TEST(LatencyHistogramTest, AddCombinesHistograms) {
+  LatencyHistogram first;
+  LatencyHistogram second;
+  first.record(10);
+  first.record(20);
+  second.record(5);
+  second.record(5000);
+  first.add(second);
+  EXPECT_EQ(first.count(), 4);
+  EXPECT_EQ(first.min(), 5);
+  EXPECT_EQ(first.max(), 5000);
+  EXPECT_DOUBLE_EQ(first.mean(), (10 + 20 + 5 + 5000) / 4.0);
+}
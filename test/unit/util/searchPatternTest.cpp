@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../../../src/util/searchPattern.hpp"
+
+TEST(SearchPatternTest, FindsUnescapedWildcards) {
+  EXPECT_TRUE(isSearchPattern("%"));
+  EXPECT_TRUE(isSearchPattern("order_items"));
+  EXPECT_FALSE(isSearchPattern("order\\_items"));
+  EXPECT_FALSE(isSearchPattern("orders"));
+  EXPECT_FALSE(isSearchPattern("100\\%"));
+  EXPECT_TRUE(isSearchPattern("a\\\\%"));
+}
+
+TEST(SearchPatternTest, UnescapesNames) {
+  EXPECT_EQ(unescapeSearchPattern("order\\_items"), "order_items");
+  EXPECT_EQ(unescapeSearchPattern("a\\\\b"), "a\\b");
+  // A backslash that escapes nothing is just a backslash.
+  EXPECT_EQ(unescapeSearchPattern("a\\b"), "a\\b");
+}
+
+TEST(SearchPatternTest, ExactNamesUseEquals) {
+  EXPECT_EQ(searchPatternPredicate("table_name", "order\\_items"),
+            "table_name = 'order_items'");
+  EXPECT_EQ(searchPatternPredicate("table_name", "o'hare"),
+            "table_name = 'o''hare'");
+}
+
+TEST(SearchPatternTest, PatternsUseLikeWithEscape) {
+  EXPECT_EQ(searchPatternPredicate("table_name", "order\\_%"),
+            "table_name LIKE 'order\\_%' ESCAPE '\\'");
+  EXPECT_EQ(searchPatternPredicate("table_name", "a\\b%"),
+            "table_name LIKE 'a\\\\b%' ESCAPE '\\'");
+}
+
+TEST(SearchPatternTest, QuotesIdentifiers) {
+  EXPECT_EQ(quoteSqlIdentifier("tpch"), "\"tpch\"");
+  EXPECT_EQ(quoteSqlIdentifier("a\"b"), "\"a\"\"b\"");
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../../../src/util/sqlRowLimit.hpp"
+
+TEST(SqlRowLimitTest, AppendsToPlainSelect) {
+  EXPECT_EQ(applyRowLimit("SELECT * FROM t", 100),
+            "SELECT * FROM t\nLIMIT 100");
+  EXPECT_EQ(applyRowLimit("  select a from t order by a", 5),
+            "  select a from t order by a\nLIMIT 5");
+}
+
+TEST(SqlRowLimitTest, AppendsToWithQuery) {
+  EXPECT_EQ(applyRowLimit("WITH x AS (SELECT 1 LIMIT 3) SELECT * FROM x", 10),
+            "WITH x AS (SELECT 1 LIMIT 3) SELECT * FROM x\nLIMIT 10");
+}
+
+TEST(SqlRowLimitTest, KeepsExistingRowLimits) {
+  EXPECT_EQ(applyRowLimit("SELECT * FROM t LIMIT 5", 100),
+            "SELECT * FROM t LIMIT 5");
+  EXPECT_EQ(applyRowLimit("SELECT * FROM t OFFSET 5", 100),
+            "SELECT * FROM t OFFSET 5");
+  EXPECT_EQ(applyRowLimit("SELECT * FROM t FETCH FIRST 5 ROWS ONLY", 100),
+            "SELECT * FROM t FETCH FIRST 5 ROWS ONLY");
+}
+
+TEST(SqlRowLimitTest, IgnoresNestedAndQuotedKeywords) {
+  EXPECT_EQ(applyRowLimit("SELECT 'limit' FROM (SELECT 1 LIMIT 1)", 2),
+            "SELECT 'limit' FROM (SELECT 1 LIMIT 1)\nLIMIT 2");
+  EXPECT_EQ(applyRowLimit("SELECT \"limit\" FROM t -- limit\n", 2),
+            "SELECT \"limit\" FROM t -- limit\n\nLIMIT 2");
+  EXPECT_EQ(applyRowLimit("SELECT /* limit */ 1", 2),
+            "SELECT /* limit */ 1\nLIMIT 2");
+  EXPECT_EQ(applyRowLimit("SELECT 'it''s' FROM t", 2),
+            "SELECT 'it''s' FROM t\nLIMIT 2");
+}
+
+TEST(SqlRowLimitTest, LeavesOtherStatementsAlone) {
+  EXPECT_EQ(applyRowLimit("SHOW TABLES", 10), "SHOW TABLES");
+  EXPECT_EQ(applyRowLimit("INSERT INTO t SELECT * FROM s", 10),
+            "INSERT INTO t SELECT * FROM s");
+  EXPECT_EQ(applyRowLimit("EXPLAIN SELECT 1", 10), "EXPLAIN SELECT 1");
+  EXPECT_EQ(applyRowLimit("SELECT 1;", 10), "SELECT 1;");
+  EXPECT_EQ(applyRowLimit("SELECT 1", 0), "SELECT 1");
+}
@@ -0,0 +1,119 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../../src/util/fileLock.hpp"
+#include "../../../src/util/traceEvents.hpp"
+
+using json = nlohmann::json;
+
+class TraceEventsTest : public ::testing::Test {
+  protected:
+    std::filesystem::path requestedPath;
+    std::filesystem::path writtenPath;
+
+    void SetUp() override {
+      std::filesystem::path dir = std::filesystem::temp_directory_path();
+      this->requestedPath       = dir / "traceEventsTest.json";
+      // The process id goes in front of the extension.
+      this->writtenPath =
+          dir / ("traceEventsTest." +
+                 std::to_string(getCurrentProcessIdentifier()) + ".json");
+      std::filesystem::remove(this->writtenPath);
+    }
+
+    void TearDown() override {
+      stopTracing();
+      std::filesystem::remove(this->writtenPath);
+    }
+
+    json readTrace() {
+      std::ifstream input(this->writtenPath);
+      std::string contents((std::istreambuf_iterator<char>(input)),
+                           std::istreambuf_iterator<char>());
+      // The closing bracket is left off on purpose.
+      return json::parse(contents + "]");
+    }
+};
+
+static void recordSpans(int count) {
+  for (int i = 0; i < count; i++) {
+    TraceSpan outer("outer");
+    TraceSpan inner("inner");
+  }
+}
+
+TEST_F(TraceEventsTest, WritesSpansFromEveryThread) {
+  startTracing(this->requestedPath.string());
+  ASSERT_TRUE(isTracing());
+
+  // More spans per thread than one buffer chunk holds.
+  const int threadCount    = 4;
+  const int spansPerThread = 3000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < threadCount; i++) {
+    threads.emplace_back(recordSpans, spansPerThread);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  {
+    TraceSpan span("main");
+  }
+  stopTracing();
+  EXPECT_FALSE(isTracing());
+
+  json events = this->readTrace();
+  ASSERT_TRUE(events.is_array());
+  ASSERT_EQ(events.size(), threadCount * spansPerThread * 2 + 1);
+  std::map<std::string, int> names;
+  std::map<unsigned long, int> threadEvents;
+  for (const json& event : events) {
+    EXPECT_EQ(event["ph"], "X");
+    EXPECT_GE(event["dur"].get<long long>(), 0);
+    names[event["name"].get<std::string>()]++;
+    threadEvents[event["tid"].get<unsigned long>()]++;
+  }
+  EXPECT_EQ(names["outer"], threadCount * spansPerThread);
+  EXPECT_EQ(names["inner"], threadCount * spansPerThread);
+  EXPECT_EQ(names["main"], 1);
+  EXPECT_EQ(threadEvents.size(), threadCount + 1);
+}
+
+TEST_F(TraceEventsTest, NoSpansAreLostWhileTheWriterKeepsUp) {
+  // The writer runs all the time, so it often reads a chunk while the
+  // recording thread fills it up and moves on to the next one.
+  setTraceFlushInterval(0);
+  startTracing(this->requestedPath.string());
+  std::thread recorder(recordSpans, 50000);
+  recorder.join();
+  stopTracing();
+  setTraceFlushInterval(1000);
+
+  EXPECT_EQ(this->readTrace().size(), 100000);
+}
+
+TEST_F(TraceEventsTest, TracingAgainAppendsToTheFile) {
+  startTracing(this->requestedPath.string());
+  recordSpans(10);
+  stopTracing();
+
+  startTracing(this->requestedPath.string());
+  recordSpans(5);
+  stopTracing();
+
+  EXPECT_EQ(this->readTrace().size(), 30);
+}
+
+TEST_F(TraceEventsTest, SpansAreDroppedWhileTracingIsOff) {
+  recordSpans(10);
+  startTracing(this->requestedPath.string());
+  stopTracing();
+  EXPECT_EQ(this->readTrace().size(), 0);
+}